@@ -0,0 +1,40 @@
+/**
+ * @file admit.c
+ * @brief Admission check for src/messages.c: its own Tasks_Init() on the host.
+ *
+ * The example registers its tasks, RX server and report job and refuses to start (both
+ * LEDs lit) if a task can start more than SAMPLE_DELAY_MS after its release. This runs
+ * that registration unchanged and prints the bound, so a task set the target would
+ * reject fails here first.
+ */
+
+#include <stdio.h>
+#include "sim.h"
+
+#include "../lib/server.c"
+#include "../lib/scheduler.c"
+
+#define main main_messages
+#include "../src/messages.c"
+#undef main
+
+/* main_messages() is never called; printf() goes to stdout */
+void Uart_Init(void) { }
+
+int main(void)
+{
+    int8_t ok;
+    uint8_t i;
+
+    sim_reset(1000000u, 1);
+    ok = Tasks_Init();
+
+    for (i = 0; i < task_count; i++)
+        printf("task %u: period %u ms, slice %u ms\n", i, tasks[i].period_ms, tasks[i].slice_ms);
+    printf("rx server: %u us every %u ms\n", Server_CapacityUs(&rx_server),
+           Server_PeriodMs(&rx_server));
+    printf("utilization %u permille, worst start delay %u ms (limit %u ms)\n",
+           Scheduler_UtilizationPermille(), Scheduler_MaxStartDelayMs(), SAMPLE_DELAY_MS);
+    printf("%s\n", ok == 0 ? "PASS: messages.c starts" : "FAIL: messages.c would halt");
+    return ok == 0 ? 0 : 1;
+}
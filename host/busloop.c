@@ -0,0 +1,442 @@
+/**
+ * @file busloop.c
+ * @brief lib/bus.c against a loopback device model on host/sim.c.
+ *
+ * The engine is built with BUS_HW_INIT/BUS_HW_START replaced by a model of the two
+ * ports: a segment takes its bit time at the configured rate and then completes from
+ * a simulated interrupt, as the DMA/USCI ISRs do on the target.
+ * - B0 (I2C): a register-file device at LOOP_I2C_ADDR; the first byte written in a
+ *   transaction sets the register pointer, later bytes are stored, reads return the
+ *   registers, both auto-incrementing. Any other address is NACKed
+ * - B1 (SPI): MISO echoes MOSI; a read segment returns what the previous write
+ *   segment of the same transaction sent
+ *
+ * Two lib/scheduler.c tasks submit random writes, register reads (write + read chain),
+ * full-duplex exchanges and transfers to a missing device, never waiting for the bus.
+ * Completion callbacks (deferred work) check status, data and per-port order. Exit
+ * status 1 on any mismatch or transaction left unfinished.
+ *
+ * With -a the same workload goes through aio.h (Bus_AioOps), one device number per
+ * bus device, and the tasks cancel random queued requests: a canceled request must
+ * never reach the bus, the others must still complete in order.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim.h"
+#include "bus.h"
+
+#define SERVER_CLOCK() ((uint32_t)(sim_now() >> 3))
+
+static void loop_init(uint8_t p, uint8_t mode, uint32_t bit_hz);
+static void loop_start(uint8_t p, const bus_xfer_t *seg, uint8_t first);
+#define BUS_HW_INIT(p, mode, hz)    loop_init(p, mode, hz)
+#define BUS_HW_START(p, seg, first) loop_start(p, seg, first)
+
+#include "../lib/bus.c"
+#include "../lib/server.c"
+#include "../lib/scheduler.c"
+
+#define MCLK_HZ         8000000u
+#define LOOP_I2C_ADDR   0x48u
+#define LOOP_ISR_CYCLES 40u
+#define OPS             4u      // outstanding transactions per port
+#define MAX_DATA        16u
+
+/* ---------- Device model ---------- */
+
+static struct {
+    uint8_t  mode;
+    uint32_t bit_cycles;
+    int      src;
+    const bus_xfer_t *seg;
+    uint8_t  first;
+    uint8_t  reg[256];
+    uint8_t  ptr;
+    uint8_t  echo[MAX_DATA];
+    uint16_t echo_len;
+    uint64_t busy_cycles;
+} dev[BUS_PORTS];
+
+static void loop_init(uint8_t p, uint8_t mode, uint32_t bit_hz)
+{
+    dev[p].mode = mode;
+    dev[p].bit_cycles = sim_mclk_hz() / bit_hz;
+}
+
+static void loop_start(uint8_t p, const bus_xfer_t *seg, uint8_t first)
+{
+    /* I2C: START + address + ACK, then 9 bits per byte; SPI: 8 bits per byte */
+    uint32_t bits = dev[p].mode == BUS_I2C ? 10u + 9u * seg->len : 8u * seg->len;
+    uint32_t cycles = bits * dev[p].bit_cycles;
+
+    dev[p].seg = seg;
+    dev[p].first = first;
+    dev[p].busy_cycles += cycles;
+    sim_trigger(dev[p].src, sim_now() + cycles);
+}
+
+static void loop_complete(uint8_t p)
+{
+    const bus_xfer_t *seg = dev[p].seg;
+    uint16_t i = 0;
+
+    if (dev[p].mode == BUS_I2C) {
+        if (bus[p].head->dev->addr != LOOP_I2C_ADDR) {
+            segment_done(p, BUS_ERR_NACK);
+            return;
+        }
+        if (seg->tx) {
+            if (dev[p].first)
+                dev[p].ptr = seg->tx[i++];
+            for (; i < seg->len; i++)
+                dev[p].reg[dev[p].ptr++] = seg->tx[i];
+        } else {
+            for (; i < seg->len; i++)
+                seg->rx[i] = dev[p].reg[dev[p].ptr++];
+        }
+    } else {
+        if (dev[p].first)
+            dev[p].echo_len = 0;
+        for (; i < seg->len; i++) {
+            uint8_t out = seg->tx ? seg->tx[i] :
+                          i < dev[p].echo_len ? dev[p].echo[i] : 0xFFu;
+            if (seg->rx)
+                seg->rx[i] = out;
+        }
+        if (seg->tx) {
+            memcpy(dev[p].echo, seg->tx, seg->len);
+            dev[p].echo_len = seg->len;
+        }
+    }
+    segment_done(p, BUS_OK);
+}
+
+static void loop_isr_b0(void) { loop_complete(BUS_B0); }
+static void loop_isr_b1(void) { loop_complete(BUS_B1); }
+
+/* ---------- Workload ---------- */
+
+/* Completion order is checked per stream: a port, or with -a an aio device number */
+#define STREAM_I2C      0u
+#define STREAM_MISSING  1u      // own aio device with -a, else part of STREAM_I2C
+#define STREAM_SPI      2u
+#define STREAMS         3u
+
+typedef struct {
+    bus_xfer_t seg[2];
+    aio_req_t  req;
+    uint8_t    tx[MAX_DATA + 1];
+    uint8_t    rx[MAX_DATA];
+    uint8_t    expect[MAX_DATA];
+    uint8_t    n_expect;
+    int8_t     want;            // expected status
+    uint8_t    stream;
+    uint8_t    cancelable;      // leaves the device model unchanged if it never runs
+    uint32_t   seq;
+    uint8_t    busy;
+} op_t;
+
+static op_t ops[BUS_PORTS][OPS];
+static uint32_t seq_submit[STREAMS], seq_next[STREAMS], n_done[STREAMS];
+static uint32_t mismatches, skipped, first_bad, cancel_tries;
+static uint8_t use_aio;
+static uint8_t shadow[256];     // expected I2C register file
+
+static const bus_dev_t i2c_dev = { BUS_B0, LOOP_I2C_ADDR, NULL, 0 };
+static const bus_dev_t i2c_missing = { BUS_B0, LOOP_I2C_ADDR + 1u, NULL, 0 };
+static const bus_dev_t spi_dev = { BUS_B1, 0, &P1OUT, BIT3 };
+
+static void op_check(op_t *op, int8_t status)
+{
+    int bad = status != op->want;
+
+    if (status == AIO_CANCELED) {
+        bad |= op->req.count != 0;      // never started, completes out of order
+    } else {
+        bad |= op->seq < seq_next[op->stream] ||
+               (op->want == BUS_OK && memcmp(op->rx, op->expect, op->n_expect) != 0);
+        seq_next[op->stream] = op->seq + 1u;
+    }
+    if (bad && !mismatches++)
+        first_bad = op->seq;
+    n_done[op->stream]++;
+    op->busy = 0;
+}
+
+static void op_bus_done(uintptr_t arg)
+{
+    op_t *op = (op_t *)arg;         // seg[0] is the first member
+
+    op_check(op, op->seg[0].status);
+}
+
+static void op_aio_done(aio_req_t *req)
+{
+    op_t *op = (op_t *)((char *)req - offsetof(op_t, req));
+
+    op_check(op, req->status);
+}
+
+static op_t *op_get(uint8_t p)
+{
+    uint8_t i;
+
+    for (i = 0; i < OPS; i++)
+        if (!ops[p][i].busy) {
+            memset(ops[p][i].seg, 0, sizeof(ops[p][i].seg));
+            memset(&ops[p][i].req, 0, sizeof(ops[p][i].req));
+            ops[p][i].n_expect = 0;
+            ops[p][i].cancelable = 0;
+            return &ops[p][i];
+        }
+    skipped++;
+    return NULL;
+}
+
+static void op_submit(op_t *op)
+{
+    int rc;
+
+    op->seq = seq_submit[op->stream]++;
+    op->busy = 1;
+    if (use_aio) {
+        op->req.dev = op->stream;
+        op->req.done = op_aio_done;
+        rc = Aio_Submit(&op->req);
+    } else {
+        op->seg[0].done = op_bus_done;
+        rc = Bus_Submit(&op->seg[0]);
+    }
+    if (rc != 0) {
+        mismatches++;
+        op->busy = 0;
+    }
+}
+
+/* A random in-flight request of the port, if it may be dropped */
+static void op_cancel(uint8_t p)
+{
+    op_t *op = &ops[p][sim_rand_range(0, OPS - 1)];
+
+    if (!op->busy || !op->cancelable)
+        return;
+    cancel_tries++;
+    if (Aio_Cancel(&op->req) == 0)
+        op->want = AIO_CANCELED;
+}
+
+/* I2C: register write, register read (write + read chain) or a missing device */
+static void submit_i2c(void)
+{
+    op_t *op = op_get(BUS_B0);
+    uint8_t r = (uint8_t)sim_rand(), n = (uint8_t)sim_rand_range(1, MAX_DATA), i;
+    uint32_t kind = sim_rand_range(0, 19);
+
+    sim_consume(200);
+    if (!op)
+        return;
+    op->tx[0] = r;
+    op->want = BUS_OK;
+    op->stream = STREAM_I2C;
+    op->seg[0].dev = &i2c_dev;
+    op->req.target = &i2c_dev;
+
+    if (kind == 0) {
+        op->stream = use_aio ? STREAM_MISSING : STREAM_I2C;
+        op->want = use_aio ? AIO_ERR_IO : BUS_ERR_NACK;
+        op->cancelable = 1;
+        op->seg[0].dev = &i2c_missing;
+        op->seg[0].tx = op->tx;
+        op->seg[0].len = 1;
+        op->req.target = &i2c_missing;
+        op->req.op = AIO_WRITE;
+        op->req.buf = op->tx;
+        op->req.len = 1;
+    } else if (kind < 10) {
+        for (i = 0; i < n; i++)
+            shadow[(uint8_t)(r + i)] = op->tx[1u + i] = (uint8_t)sim_rand();
+        op->seg[0].tx = op->tx;
+        op->seg[0].len = (uint16_t)(n + 1u);
+        op->req.op = AIO_WRITE;
+        op->req.buf = op->tx;
+        op->req.len = (uint16_t)(n + 1u);
+    } else {
+        for (i = 0; i < n; i++)
+            op->expect[i] = shadow[(uint8_t)(r + i)];
+        op->n_expect = n;
+        op->cancelable = 1;
+        op->seg[0].tx = op->tx;
+        op->seg[0].len = 1;
+        op->seg[0].chain = &op->seg[1];
+        op->seg[1].rx = op->rx;
+        op->seg[1].len = n;
+        op->req.op = AIO_READ;
+        op->req.cmd = op->tx;
+        op->req.cmd_len = 1;
+        op->req.buf = op->rx;
+        op->req.len = n;
+    }
+    op_submit(op);
+}
+
+/* SPI: full-duplex exchange (-a: plain write), or a write chained to a read of its echo */
+static void submit_spi(void)
+{
+    op_t *op = op_get(BUS_B1);
+    uint8_t n = (uint8_t)sim_rand_range(1, MAX_DATA), i;
+
+    sim_consume(150);
+    if (!op)
+        return;
+    for (i = 0; i < n; i++)
+        op->expect[i] = op->tx[i] = (uint8_t)sim_rand();
+    op->n_expect = n;
+    op->want = BUS_OK;
+    op->stream = STREAM_SPI;
+    op->cancelable = 1;
+    op->seg[0].dev = &spi_dev;
+    op->seg[0].tx = op->tx;
+    op->seg[0].len = n;
+    op->req.target = &spi_dev;
+    if (sim_rand() & 1u) {
+        op->seg[0].rx = op->rx;
+        op->req.op = AIO_WRITE;
+        op->req.buf = op->tx;
+        op->req.len = n;
+        if (use_aio)
+            op->n_expect = 0;
+    } else {
+        op->seg[0].chain = &op->seg[1];
+        op->seg[1].rx = op->rx;
+        op->seg[1].len = n;
+        op->req.op = AIO_READ;
+        op->req.cmd = op->tx;
+        op->req.cmd_len = n;
+        op->req.buf = op->rx;
+        op->req.len = n;
+    }
+    op_submit(op);
+}
+
+/* Each run submits a burst of one to three transactions and returns; with -a it
+ * also tries to cancel one request in four runs */
+static void task_i2c(uint32_t now_ms)
+{
+    uint32_t k;
+
+    (void)now_ms;
+    for (k = sim_rand_range(1, 3); k; k--)
+        submit_i2c();
+    if (use_aio && sim_rand_range(0, 3) == 0)
+        op_cancel(BUS_B0);
+}
+
+static void task_spi(uint32_t now_ms)
+{
+    uint32_t k;
+
+    (void)now_ms;
+    for (k = sim_rand_range(1, 3); k; k--)
+        submit_spi();
+    if (use_aio && sim_rand_range(0, 3) == 0)
+        op_cancel(BUS_B1);
+}
+
+static void tick_isr(void)
+{
+    SysTime_Tick();
+    Scheduler_Tick();
+    __bic_SR_register_on_exit(LPM0_bits);
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "usage: %s [-a] [-d seconds] [-S seed] [-i i2c_hz] [-p spi_hz]\n"
+            "  -a  submit through aio.h and cancel random requests\n"
+            "  -d  simulated time (default 10)\n"
+            "  -S  seed (default 1)\n"
+            "  -i  I2C bit rate on B0 (default 400000)\n"
+            "  -p  SPI bit rate on B1 (default 1000000)\n", prog);
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t seconds = 10, seed = 1, i2c_hz = 400000u, spi_hz = 1000000u;
+    const char *const names[BUS_PORTS] = { "B0 I2C", "B1 SPI" };
+    const char *const streams[STREAMS] = { "i2c", "missing", "spi" };
+    const sim_stats_t *st;
+    uint64_t end;
+    uint8_t p, d;
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-a"))                      use_aio = 1;
+        else if (!strcmp(argv[i], "-d") && i + 1 < argc) seconds = strtoul(argv[++i], NULL, 0);
+        else if (!strcmp(argv[i], "-S") && i + 1 < argc) seed = strtoul(argv[++i], NULL, 0);
+        else if (!strcmp(argv[i], "-i") && i + 1 < argc) i2c_hz = strtoul(argv[++i], NULL, 0);
+        else if (!strcmp(argv[i], "-p") && i + 1 < argc) spi_hz = strtoul(argv[++i], NULL, 0);
+        else { usage(argv[0]); return 2; }
+    }
+    if (!i2c_hz || !spi_hz) { usage(argv[0]); return 2; }
+
+    sim_reset(MCLK_HZ, seed);
+    Clk_Init(CLK_8MHZ);
+    Defer_Init();
+    dev[BUS_B0].src = sim_add_source(loop_isr_b0, 0, 0, LOOP_ISR_CYCLES);
+    dev[BUS_B1].src = sim_add_source(loop_isr_b1, 0, 0, LOOP_ISR_CYCLES);
+    sim_add_source(tick_isr, MCLK_HZ / 1000u, MCLK_HZ / 1000u, 40);
+    Bus_Init(BUS_B0, BUS_I2C, i2c_hz);
+    Bus_Init(BUS_B1, BUS_SPI, spi_hz);
+    if (use_aio)
+        for (d = 0; d < STREAMS; d++)
+            Aio_Attach(d, &Bus_AioOps);
+    Scheduler_AddTask(task_i2c, 5, 0, 0);
+    Scheduler_AddTask(task_spi, 2, 1, 0);
+
+    end = (uint64_t)seconds * MCLK_HZ;
+    __enable_interrupt();
+    while (sim_now() < end)
+        Scheduler_Dispatch();
+    task_count = 0;                     // drain: no new submissions
+    while (Bus_Busy(BUS_B0) || Bus_Busy(BUS_B1) || Defer_Pending() || Aio_Pending())
+        Scheduler_Dispatch();
+    __disable_interrupt();
+
+    printf("%-7s %10s %10s %7s %6s %6s\n", "port", "submitted", "completed", "errors",
+           "queue", "busy");
+    for (p = 0; p < BUS_PORTS; p++) {
+        const bus_stats_t *s = Bus_GetStats(p);
+        printf("%-7s %10lu %10lu %7u %6u %5.1f%%\n", names[p], (unsigned long)s->submitted,
+               (unsigned long)s->completed, s->errors, s->max_queue,
+               100.0 * dev[p].busy_cycles / sim_now());
+        if (s->lost_events)
+            mismatches++;
+    }
+    if (use_aio) {
+        printf("%-7s %10s %10s %7s %8s %6s\n", "aio dev", "submitted", "completed", "errors",
+               "canceled", "queue");
+        for (d = 0; d < STREAMS; d++) {
+            const aio_stats_t *a = Aio_GetStats(d);
+            printf("%-7s %10lu %10lu %7u %8u %6u\n", streams[d], (unsigned long)a->submitted,
+                   (unsigned long)a->completed, a->errors, a->canceled, a->max_queue);
+        }
+        printf("%lu cancel attempts on queued or running requests\n",
+               (unsigned long)cancel_tries);
+    }
+    for (d = 0; d < STREAMS; d++)
+        if (n_done[d] != seq_submit[d])
+            mismatches++;
+    st = sim_stats();
+    printf("CPU in LPM0 %.1f%%, %lu submissions skipped (all %u blocks in flight)\n",
+           100.0 * st->sleep_cycles / sim_now(), (unsigned long)skipped, OPS);
+    if (mismatches) {
+        printf("%lu mismatches, first at transaction %lu\n", (unsigned long)mismatches,
+               (unsigned long)first_bad);
+        return 1;
+    }
+    printf("all transactions completed in order with the expected data and status\n");
+    return 0;
+}
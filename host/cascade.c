@@ -0,0 +1,152 @@
+/**
+ * @file cascade.c
+ * @brief lib/cascade.c against independent per-rate counters on the host.
+ *
+ * Each scenario draws 1..CASCADE_MAX_RATES harmonic periods (each a multiple of the
+ * one before, up to 65535 ticks), ticks the cascade and, next to it, one independent
+ * counter per rate as src/superloop.c used to. A consumer takes the flags after a random
+ * number of ticks, sometimes longer than the fastest period. Per rate:
+ * - a flag is seen only in a take after the independent counter rolled over
+ * - flags seen plus misses equal the rollovers of the independent counter
+ * Cascade_Init() must reject non-harmonic, zero and duplicate periods. The counters
+ * touched per tick are printed for both designs. Exit status 1 on any mismatch.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim.h"
+#include "cascade.h"
+
+static uint32_t bad;
+
+static void fail(const char *what, uint32_t a, uint32_t b)
+{
+    if (bad++ < 10)
+        printf("mismatch: %s (%lu, %lu)\n", what, (unsigned long)a, (unsigned long)b);
+}
+
+static uint8_t draw_periods(uint16_t *p)
+{
+    uint8_t n = (uint8_t)sim_rand_range(1, CASCADE_MAX_RATES), i;
+    uint32_t period = sim_rand_range(1, 200);
+
+    for (i = 0; i < n; i++) {
+        if (period > 0xFFFFu)
+            break;
+        p[i] = (uint16_t)period;
+        period *= sim_rand_range(2, 6);
+    }
+    return i;
+}
+
+static void check_rejects(void)
+{
+    static const uint16_t non_harmonic[] = { 100, 250 };
+    static const uint16_t zero[] = { 0, 100 };
+    static const uint16_t duplicate[] = { 100, 100 };
+    uint16_t many[CASCADE_MAX_RATES + 1];
+    uint8_t i;
+
+    for (i = 0; i <= CASCADE_MAX_RATES; i++)
+        many[i] = (uint16_t)(1u << (i < 15 ? i : 15));
+    if (Cascade_Init(non_harmonic, 2) != -1) fail("non-harmonic periods accepted", 100, 250);
+    if (Cascade_Init(zero, 2) != -1)         fail("zero period accepted", 0, 100);
+    if (Cascade_Init(duplicate, 2) != -1)    fail("duplicate period accepted", 100, 100);
+    if (Cascade_Init(many, CASCADE_MAX_RATES + 1) != -1)
+        fail("too many rates accepted", CASCADE_MAX_RATES + 1, 0);
+    if (Cascade_Init(NULL, 1) != -1)         fail("no periods accepted", 0, 0);
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "usage: %s [-n scenarios] [-t ticks] [-S seed]\n"
+            "  -n  scenarios (default 200)\n"
+            "  -t  ticks per scenario (default 200000)\n"
+            "  -S  seed (default 1)\n", prog);
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t scenarios = 200, ticks = 200000, seed = 1, s;
+    uint64_t cascade_touches = 0, counter_touches = 0, total_ticks = 0, seen_total = 0;
+    uint32_t rates_total = 0;
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-n") && i + 1 < argc)      scenarios = strtoul(argv[++i], NULL, 0);
+        else if (!strcmp(argv[i], "-t") && i + 1 < argc) ticks = strtoul(argv[++i], NULL, 0);
+        else if (!strcmp(argv[i], "-S") && i + 1 < argc) seed = strtoul(argv[++i], NULL, 0);
+        else { usage(argv[0]); return 2; }
+    }
+
+    sim_reset(1000000u, seed);
+    check_rejects();
+
+    for (s = 0; s < scenarios; s++) {
+        uint16_t periods[CASCADE_MAX_RATES], count[CASCADE_MAX_RATES];
+        uint32_t rolled[CASCADE_MAX_RATES], seen[CASCADE_MAX_RATES];
+        uint16_t unseen = 0;    // rates rolled over since the last take
+        uint32_t t, next_take = 0;
+        uint8_t n = draw_periods(periods), r;
+
+        if (Cascade_Init(periods, n) != 0) {
+            fail("harmonic periods rejected", periods[0], n);
+            continue;
+        }
+        for (r = 0; r < n; r++) {
+            count[r] = 0;
+            rolled[r] = seen[r] = 0;
+        }
+
+        for (t = 1; t <= ticks; t++) {
+            uint16_t flags;
+
+            Cascade_Tick();
+            for (r = 0; r < n; r++) {
+                if (++count[r] >= periods[r]) {
+                    count[r] = 0;
+                    rolled[r]++;
+                    unseen |= (uint16_t)(1u << r);
+                }
+            }
+            counter_touches += n;
+            cascade_touches++;
+            for (r = 0; r + 1u < n && (t % periods[r]) == 0; r++)
+                cascade_touches++;
+
+            if (t < next_take)
+                continue;
+            flags = Cascade_Take();
+            if (flags & ~unseen)
+                fail("flag without a rollover", flags, t);
+            if (unseen & ~flags)
+                fail("rollover without a flag", unseen, t);
+            for (r = 0; r < n; r++)
+                if (flags & (1u << r))
+                    seen[r]++;
+            unseen = 0;
+            next_take = t + sim_rand_range(0, (uint32_t)periods[0] * 3u / 2u);
+        }
+        for (r = 0; r < n; r++) {
+            if (seen[r] + Cascade_Missed(r) + ((unseen >> r) & 1u) != rolled[r])
+                fail("seen + missed != rollovers", seen[r] + Cascade_Missed(r), rolled[r]);
+            seen_total += seen[r];
+        }
+        total_ticks += ticks;
+        rates_total += n;
+    }
+
+    printf("%lu scenarios, %.1f rates on average, %llu flags taken\n"
+           "counters touched per tick: cascade %.3f, independent counters %.3f\n",
+           (unsigned long)scenarios, (double)rates_total / (scenarios ? scenarios : 1),
+           (unsigned long long)seen_total, (double)cascade_touches / total_ticks,
+           (double)counter_touches / total_ticks);
+    if (bad) {
+        printf("%lu mismatches\n", (unsigned long)bad);
+        return 1;
+    }
+    printf("every rollover is seen or counted as missed\n");
+    return 0;
+}
@@ -0,0 +1,430 @@
+/**
+ * @file ccsched.c
+ * @brief lib/ccsched.c (one Timer_B0 compare channel per task) on host/sim.c.
+ *
+ * The driver is built with its CCSCHED_* register macros replaced by a TB0 model: the
+ * counter runs at SMCLK/8 from CcSched_Start(), and writing a compare schedules that
+ * channel's interrupt for the moment the 16-bit counter reaches it, as on the target.
+ *
+ * Each scenario draws a clock speed and 1..6 tasks (periods from 200 us to 3 s, some
+ * longer than one compare step, random offsets and execution times up to a utilization
+ * cap), and optionally a higher-priority interrupt that delays the compare ISR past
+ * short periods. Checks:
+ * - every release interrupt is at or after its release time, in order, and none is lost
+ * - interrupts per channel = releases + the hops of periods over one compare step
+ * - the n-th run of a task starts at or after its n-th release, within max_late
+ * - the main loop never sleeps with a released task not yet run
+ * CcSched_AddTask() must reject a seventh task, periods that are not whole counts and
+ * periods under CCSCHED_MIN_COUNTS. Exit status 1 on any failure.
+ *
+ * The lateness of release interrupts is reported apart for scenarios with and without
+ * the disturbing interrupt. Without it, only the other compare ISRs and the driver's
+ * GIE-clear windows delay a release, and the share of releases entered within one
+ * timer count shows how often the timer clock is the only limit.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim.h"
+#include "clock.h"
+
+/* ---------- TB0 model ---------- */
+
+static void tb_set(uint8_t ch, uint16_t ccr);
+static void tb_run(void);
+static void tb_stop(void);
+static uint16_t tb_now(void);
+static void tb_force(uint8_t ch);
+
+#define CCSCHED_STOP()          tb_stop()
+#define CCSCHED_RUN()           tb_run()
+#define CCSCHED_NOW()           tb_now()
+#define CCSCHED_SET(ch, ccr)    tb_set(ch, ccr)
+#define CCSCHED_ENABLE(ch)      ((void)(ch))
+#define CCSCHED_FORCE(ch)       tb_force(ch)
+
+#include "../lib/ccsched.c"
+
+#define MAX_STEP        0xF000u     // CCSCHED_MAX_STEP
+#define ISR_CYCLES      40u
+#define NOISE_PERIOD    40000u      // cycles between disturbing interrupts
+
+static int tb_src[CCSCHED_MAX_TASKS + 1];
+static uint16_t tb_ccr[CCSCHED_MAX_TASKS + 1];
+static uint64_t tb_base;            // cycle of count 0
+static int tb_running;
+
+static uint64_t tb_counts(void)
+{
+    return (sim_now() - tb_base) >> 3;          // MCLK = SMCLK, ID__8
+}
+
+static uint16_t tb_now(void)
+{
+    return tb_running ? (uint16_t)tb_counts() : 0u;
+}
+
+/* The compare matches when the counter next counts to ccr */
+static void tb_schedule(uint8_t ch)
+{
+    uint64_t counts = tb_counts();
+    uint32_t delta = (uint16_t)(tb_ccr[ch] - (uint16_t)counts);
+
+    sim_trigger(tb_src[ch], tb_base + ((counts + (delta ? delta : 0x10000u)) << 3));
+}
+
+static void tb_set(uint8_t ch, uint16_t ccr)
+{
+    tb_ccr[ch] = ccr;
+    if (tb_running)
+        tb_schedule(ch);
+}
+
+static void tb_run(void)
+{
+    uint8_t ch;
+
+    tb_base = sim_now();
+    tb_running = 1;
+    for (ch = 1; ch <= cc_count; ch++)
+        tb_schedule(ch);
+}
+
+static void tb_stop(void)
+{
+    uint8_t ch;
+
+    tb_running = 0;
+    for (ch = 1; ch <= CCSCHED_MAX_TASKS; ch++)
+        if (tb_src[ch] >= 0)
+            sim_cancel(tb_src[ch]);
+}
+
+static void tb_force(uint8_t ch)
+{
+    sim_trigger(tb_src[ch], sim_now());
+}
+
+/* ---------- Harness ---------- */
+
+typedef struct {
+    uint32_t period;            // counts
+    uint32_t offset;
+    uint32_t exec_max;          // cycles
+    uint32_t isrs, releases, runs, hops;
+} htask_t;
+
+static struct {
+    htask_t  t[CCSCHED_MAX_TASKS];
+    uint8_t  n;
+    uint32_t max_late;          // cycles
+    uint64_t worst_isr_late;    // cycles from release to its ISR
+    uint64_t worst_run_late;
+    uint32_t on_count;          // release interrupts entered within one timer count
+    uint32_t forced;
+    uint32_t noise_cycles;
+} h;
+
+static uint32_t bad;
+
+static void fail(const char *what, unsigned task, unsigned long long a, unsigned long long b)
+{
+    if (bad++ < 10)
+        printf("mismatch: %s T%u (%llu, %llu)\n", what, task, a, b);
+}
+
+/* Cycle of release k >= 1 */
+static uint64_t release_at(const htask_t *t, uint32_t k)
+{
+    return tb_base + (((uint64_t)t->offset + (uint64_t)k * t->period) << 3);
+}
+
+/* Compare interrupts per period, by the driver's step rule */
+static uint32_t steps(uint32_t left)
+{
+    uint32_t n = 0;
+
+    while (left > MAX_STEP) {
+        if (left < 2u * MAX_STEP) return n + 2u;
+        left -= MAX_STEP;
+        n++;
+    }
+    return n + 1u;
+}
+
+/* Hops up to and including the in-progress period after t->releases releases */
+static uint32_t hops_max(const htask_t *t)
+{
+    return steps(t->offset + t->period) - 1u + t->releases * (steps(t->period) - 1u);
+}
+
+static void channel_isr(uint8_t ch)
+{
+    htask_t *t = &h.t[ch - 1u];
+    uint64_t entry = sim_now() - ISR_CYCLES;
+
+    t->isrs++;
+    if (!CcSched_Isr((uint16_t)(ch << 1))) {
+        t->hops++;
+        return;
+    }
+    t->releases++;
+    if (entry < release_at(t, t->releases)) {
+        fail("release interrupt early", ch - 1u, entry, release_at(t, t->releases));
+    } else {
+        uint64_t late = entry - release_at(t, t->releases);
+
+        if (late < 8u)
+            h.on_count++;
+        if (late > h.worst_isr_late)
+            h.worst_isr_late = late;
+    }
+    __bic_SR_register_on_exit(LPM0_bits);
+}
+
+#define CHANNEL_ISR(n) static void tb_isr_##n(void) { channel_isr(n); }
+CHANNEL_ISR(1) CHANNEL_ISR(2) CHANNEL_ISR(3) CHANNEL_ISR(4) CHANNEL_ISR(5) CHANNEL_ISR(6)
+
+static const sim_isr_t tb_isrs[CCSCHED_MAX_TASKS + 1] = {
+    NULL, tb_isr_1, tb_isr_2, tb_isr_3, tb_isr_4, tb_isr_5, tb_isr_6
+};
+
+static void noise_isr(void)
+{
+    sim_consume(h.noise_cycles);
+}
+
+static void run_task(uint8_t i)
+{
+    htask_t *t = &h.t[i];
+    uint64_t rel = release_at(t, ++t->runs);
+
+    if (sim_now() < rel) {
+        fail("run before its release", i, sim_now(), rel);
+    } else {
+        if (sim_now() - rel > h.max_late)
+            fail("run later than max_late", i, sim_now() - rel, h.max_late);
+        if (sim_now() - rel > h.worst_run_late)
+            h.worst_run_late = sim_now() - rel;
+    }
+    sim_consume(sim_rand_range(t->exec_max / 2u, t->exec_max));
+}
+
+#define TASK_FN(n) static void task_##n(void) { run_task(n); }
+TASK_FN(0) TASK_FN(1) TASK_FN(2) TASK_FN(3) TASK_FN(4) TASK_FN(5)
+
+static const ccsched_fn_t task_fns[CCSCHED_MAX_TASKS] = {
+    task_0, task_1, task_2, task_3, task_4, task_5
+};
+
+static void on_sleep(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < h.n; i++)
+        if (h.t[i].runs < h.t[i].releases)
+            fail("sleep with a released task", i, h.t[i].runs, h.t[i].releases);
+}
+
+/* Blocking bound: two passes of every task, plus the interrupts that fit in the window */
+static uint32_t lateness_bound(void)
+{
+    uint64_t base = 2u * ISR_CYCLES, late, prev = 0;
+    uint8_t i;
+
+    for (i = 0; i < h.n; i++)
+        base += 2u * h.t[i].exec_max;
+    late = base;
+    while (late != prev && late < 0xFFFFFFFFu) {
+        prev = late;
+        late = base;
+        for (i = 0; i < h.n; i++) {
+            uint64_t period = (uint64_t)h.t[i].period << 3;
+            late += (prev + period - 1u) / period * ISR_CYCLES * steps(h.t[i].period);
+        }
+        if (h.noise_cycles)
+            late += (prev + NOISE_PERIOD - 1u) / NOISE_PERIOD * (h.noise_cycles + ISR_CYCLES);
+    }
+    return late > 0xFFFFFFFFu ? 0xFFFFFFFFu : (uint32_t)late;
+}
+
+static void check_rejects(void)
+{
+    uint8_t i;
+
+    sim_reset(1000000u, 1);
+    Clk_Init(CLK_1MHZ);                 // 8 us per count
+    CcSched_Init();
+    if (CcSched_AddTask(task_0, 100, 0) != -1)  fail("12.5 counts accepted", 0, 100, 0);
+    if (CcSched_AddTask(task_0, 1000, 4) != -1) fail("offset of 0.5 counts accepted", 0, 4, 0);
+    if (CcSched_AddTask(task_0, 8u * (CCSCHED_MIN_COUNTS - 1u), 0) != -1)
+        fail("period under CCSCHED_MIN_COUNTS accepted", 0, CCSCHED_MIN_COUNTS - 1u, 0);
+    if (CcSched_AddTask(NULL, 1000, 0) != -1)   fail("no function accepted", 0, 0, 0);
+    for (i = 0; i < CCSCHED_MAX_TASKS; i++)
+        if (CcSched_AddTask(task_0, 1000u * (i + 1u), 0) != i)
+            fail("valid task rejected", i, 1000u * (i + 1u), 0);
+    if (CcSched_AddTask(task_0, 1000, 0) != -1) fail("seventh task accepted", 6, 0, 0);
+}
+
+/* Run one scenario; releases and runs are compared up to end_ms */
+static void run_scenario(uint32_t seed, uint32_t util_pct, uint32_t end_ms)
+{
+    static const struct { ClockSpeed_t speed; uint32_t hz; } clocks[] = {
+        { CLK_1MHZ, 1000000u }, { CLK_8MHZ, 8000000u }, { CLK_16MHZ, 16000000u }
+    };
+    uint32_t c = sim_rand_range(0, 2), share[CCSCHED_MAX_TASKS], total = 0, cpm;
+    uint32_t hz = clocks[c].hz;
+    uint64_t end;
+    uint8_t i, ch;
+
+    memset(&h, 0, sizeof(h));
+    sim_reset(hz, seed);
+    Clk_Init(clocks[c].speed);
+    sim_set_jitter(0, sim_rand_range(0, 20));
+    sim_set_sleep_hook(on_sleep);
+    cpm = CcSched_CountsPerMs();
+
+    /* The disturbing interrupt outranks the compares: added first */
+    if (sim_rand() & 1u) {
+        h.noise_cycles = sim_rand_range(100, 4000);
+        sim_add_source(noise_isr, NOISE_PERIOD, sim_rand_range(1, NOISE_PERIOD), ISR_CYCLES);
+    }
+    memset(tb_src, -1, sizeof(tb_src));
+    tb_running = 0;
+    for (ch = 1; ch <= CCSCHED_MAX_TASKS; ch++)
+        tb_src[ch] = sim_add_source(tb_isrs[ch], 0, 0, ISR_CYCLES);
+
+    CcSched_Init();
+    h.n = (uint8_t)sim_rand_range(1, CCSCHED_MAX_TASKS);
+    for (i = 0; i < h.n; i++) {
+        htask_t *t = &h.t[i];
+        uint32_t us_per_count = 1000u / cpm ? 1000u / cpm : 1u;
+        uint32_t period_us = (sim_rand() & 7u) ? sim_rand_range(200, 500000) : sim_rand_range(500000, 3000000);
+        uint32_t offset_us = sim_rand_range(0, period_us);
+
+        period_us -= period_us % us_per_count;
+        offset_us -= offset_us % us_per_count;
+        if (period_us < us_per_count * CCSCHED_MIN_COUNTS)
+            period_us = us_per_count * CCSCHED_MIN_COUNTS;
+        if (CcSched_AddTask(task_fns[i], period_us, offset_us) != i) {
+            fail("task rejected", i, period_us, offset_us);
+            return;
+        }
+        t->period = CcSched_GetTask(i)->period;
+        t->offset = (uint32_t)((uint64_t)offset_us * cpm / 1000u);
+        share[i] = sim_rand_range(1, 100);
+        total += share[i];
+    }
+    for (i = 0; i < h.n; i++) {
+        uint64_t cy = (uint64_t)util_pct * share[i] * ((uint64_t)h.t[i].period << 3) / (100u * total);
+        h.t[i].exec_max = cy < 20u ? 20u : (uint32_t)cy;
+    }
+    h.max_late = lateness_bound();
+
+    CcSched_Start();
+    end = tb_base + (uint64_t)end_ms * (hz / 1000u);
+    __enable_interrupt();
+    while (sim_now() < end)
+        CcSched_Dispatch();
+    __disable_interrupt();
+    tb_stop();
+    end = sim_now();                    // releases were counted up to here
+
+    for (i = 0; i < h.n; i++) {
+        htask_t *t = &h.t[i];
+        uint64_t counts = (end - tb_base) >> 3;
+        uint32_t due = counts >= (uint64_t)t->offset + t->period ?
+                       (uint32_t)((counts - t->offset) / t->period) : 0u;
+        uint32_t due_old = 0;
+
+        while (due_old < due && release_at(t, due_old + 1u) + h.max_late < end)
+            due_old++;
+        if (t->releases > due || t->releases + 1u < due)
+            fail("releases != due", i, t->releases, due);
+        if (t->runs < due_old)
+            fail("release not run within max_late", i, t->runs, due_old);
+        if (t->isrs != t->releases + t->hops)
+            fail("interrupts != releases + hops", i, t->isrs, t->releases + t->hops);
+        if (t->hops > hops_max(t) || (t->releases && t->hops < hops_max(t) - (steps(t->period) - 1u)))
+            fail("hops outside the step rule", i, t->hops, hops_max(t));
+        h.forced += CcSched_GetTask(i)->late_arms;
+    }
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "usage: %s [-n scenarios] [-t ms] [-u util%%] [-S seed]\n"
+            "  -n  scenarios (default 300)\n"
+            "  -t  simulated ms per scenario (default 4000)\n"
+            "  -u  utilization cap in percent (default 50)\n"
+            "  -S  seed (default 1)\n", prog);
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t scenarios = 300, ms = 4000, util = 50, seed = 1, s;
+    uint64_t isrs = 0, releases = 0, hops = 0, forced = 0, sim_ms = 0;
+    uint64_t worst_isr[2] = { 0, 0 }, worst_run = 0, quiet_releases = 0, quiet_on_count = 0;
+    uint32_t worst_isr_hz[2] = { 1, 1 }, worst_run_hz = 1;
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-n") && i + 1 < argc)      scenarios = strtoul(argv[++i], NULL, 0);
+        else if (!strcmp(argv[i], "-t") && i + 1 < argc) ms = strtoul(argv[++i], NULL, 0);
+        else if (!strcmp(argv[i], "-u") && i + 1 < argc) util = strtoul(argv[++i], NULL, 0);
+        else if (!strcmp(argv[i], "-S") && i + 1 < argc) seed = strtoul(argv[++i], NULL, 0);
+        else { usage(argv[0]); return 2; }
+    }
+
+    memset(tb_src, -1, sizeof(tb_src));
+    check_rejects();
+    for (s = 0; s < scenarios; s++) {
+        uint8_t t, noisy;
+
+        run_scenario(seed + s * 2654435761u, util, ms);
+        noisy = h.noise_cycles != 0;
+        for (t = 0; t < h.n; t++) {
+            isrs += h.t[t].isrs;
+            releases += h.t[t].releases;
+            hops += h.t[t].hops;
+            if (!noisy)
+                quiet_releases += h.t[t].releases;
+        }
+        if (!noisy)
+            quiet_on_count += h.on_count;
+        forced += h.forced;
+        sim_ms += ms;
+        /* compare in time, not cycles: the clock differs per scenario */
+        if (h.worst_isr_late * worst_isr_hz[noisy] > worst_isr[noisy] * sim_mclk_hz()) {
+            worst_isr[noisy] = h.worst_isr_late;
+            worst_isr_hz[noisy] = sim_mclk_hz();
+        }
+        if (h.worst_run_late * worst_run_hz > worst_run * sim_mclk_hz()) {
+            worst_run = h.worst_run_late;
+            worst_run_hz = sim_mclk_hz();
+        }
+    }
+
+    printf("%lu scenarios, %llu releases, %llu compare interrupts (%llu hops, %llu forced)\n"
+           "interrupts per simulated second: %.0f (a 1 ms tick takes 1000 and rounds releases to 1 ms)\n"
+           "release interrupt lateness, compares only: worst %.1f us (%llu counts), "
+           "%.2f%% within one count\n"
+           "release interrupt lateness, with a higher-priority interrupt: worst %.1f us\n"
+           "worst task start %.1f us after its release\n",
+           (unsigned long)scenarios, (unsigned long long)releases, (unsigned long long)isrs,
+           (unsigned long long)hops, (unsigned long long)forced,
+           sim_ms ? isrs * 1000.0 / sim_ms : 0.0,
+           worst_isr[0] * 1e6 / worst_isr_hz[0], (unsigned long long)(worst_isr[0] / 8u),
+           quiet_releases ? 100.0 * quiet_on_count / quiet_releases : 100.0,
+           worst_isr[1] * 1e6 / worst_isr_hz[1],
+           worst_run * 1e6 / worst_run_hz);
+    if (bad) {
+        printf("%lu mismatches\n", (unsigned long)bad);
+        return 1;
+    }
+    printf("no release interrupt before its release, none lost; every release run once "
+           "within its lateness bound\n");
+    return 0;
+}
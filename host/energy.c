@@ -0,0 +1,158 @@
+/**
+ * @file energy.c
+ * @brief Battery-life prediction: runs lib/scheduler.c with energy accounting on host/sim.c.
+ *
+ * Each task is given a period and a cycle cost; the simulator runs the task set for the
+ * requested time, and lib/energy.c (the firmware code, with the simulator's cycle counter
+ * as stamp source) prices every task, the dispatch/ISR overhead and LPM0 with the same
+ * current model as on the target. The simulator's own active/sleep split is printed as a
+ * cross-check of the accounting. The tick is the one Scheduler_Start() derives from the
+ * periods; -f keeps the TICK_MS tick to show what the longer tick saves.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim.h"
+
+/* Firmware accounting with the simulator as cycle counter */
+#define ENERGY_CYCLES() ((uint32_t)sim_now())
+#define SERVER_CLOCK()  ((uint32_t)(sim_now() >> 3))
+#include "../lib/energy.c"
+#include "../lib/server.c"
+#include "../lib/scheduler.c"
+#include "sut.h"
+
+typedef struct {
+    uint16_t period_ms;
+    uint32_t cycles;
+    uint32_t runs;
+} etask_t;
+
+static etask_t et[SUT_MAX_TASKS];
+static uint8_t et_count;
+
+void harness_task(uint8_t id)
+{
+    et[id].runs++;
+    sim_consume(et[id].cycles);
+}
+
+SUT_TRAMPOLINES(tramp_, void, (uint32_t now_ms), now_ms)
+
+static const task_fn_t tramps[SUT_MAX_TASKS] = {
+    tramp_0, tramp_1, tramp_2, tramp_3, tramp_4, tramp_5, tramp_6, tramp_7
+};
+
+static void tick_isr(void)
+{
+    SysTime_Tick();
+    Scheduler_Tick();
+    __bic_SR_register_on_exit(LPM0_bits);
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "usage: %s [-c 1|8|16] [-d seconds] [-b mAh] [-m mV] [-f] -t period_ms:cycles ...\n"
+            "  -c  MCLK in MHz (default 8)\n"
+            "  -d  simulated time in seconds (default 10)\n"
+            "  -b  battery capacity in mAh for the lifetime estimate (default 230, CR2032)\n"
+            "  -m  supply voltage in mV (default: model, 3000)\n"
+            "  -i  tick ISR cost in cycles (default 40)\n"
+            "  -f  fixed TICK_MS tick instead of Scheduler_Start()\n"
+            "  -t  task with period and worst-case cycles per run, up to %d\n",
+            prog, SUT_MAX_TASKS);
+}
+
+static void row(const char *name, uint64_t nj, uint64_t total, uint64_t us)
+{
+    printf("%-12s %12.1f %6.1f%% %10.2f\n", name, nj / 1000.0,
+           total ? 100.0 * nj / total : 0.0,
+           us ? nj * 1e6 / us / model->supply_mv : 0.0);     // average uA
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t mhz = 8, seconds = 10, isr_cycles = 40, mv = 0, tick;
+    int fixed = 0;
+    double mah = 230.0;
+    energy_model_t m = energy_model_fr5994;
+    ClockSpeed_t speed;
+    uint64_t end, total = 0, us, nj;
+    const sim_stats_t *st;
+    char name[16];
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-c") && i + 1 < argc)      mhz = strtoul(argv[++i], NULL, 0);
+        else if (!strcmp(argv[i], "-d") && i + 1 < argc) seconds = strtoul(argv[++i], NULL, 0);
+        else if (!strcmp(argv[i], "-b") && i + 1 < argc) mah = strtod(argv[++i], NULL);
+        else if (!strcmp(argv[i], "-m") && i + 1 < argc) mv = strtoul(argv[++i], NULL, 0);
+        else if (!strcmp(argv[i], "-i") && i + 1 < argc) isr_cycles = strtoul(argv[++i], NULL, 0);
+        else if (!strcmp(argv[i], "-f"))                 fixed = 1;
+        else if (!strcmp(argv[i], "-t") && i + 1 < argc && et_count < SUT_MAX_TASKS) {
+            char *colon;
+            et[et_count].period_ms = (uint16_t)strtoul(argv[++i], &colon, 0);
+            if (*colon != ':' || !et[et_count].period_ms) { usage(argv[0]); return 2; }
+            et[et_count++].cycles = strtoul(colon + 1, NULL, 0);
+        }
+        else { usage(argv[0]); return 2; }
+    }
+    switch (mhz) {
+        case 1:  speed = CLK_1MHZ;  break;
+        case 8:  speed = CLK_8MHZ;  break;
+        case 16: speed = CLK_16MHZ; break;
+        default: usage(argv[0]); return 2;
+    }
+    if (!et_count) { usage(argv[0]); return 2; }
+    if (mv) m.supply_mv = (uint16_t)mv;
+
+    sim_reset(mhz * 1000000u, 1);
+    Clk_Init(speed);
+    for (i = 0; i < et_count; i++)
+        Scheduler_AddTask(tramps[i], et[i].period_ms, 0, 0);
+    if (!fixed)
+        Scheduler_Start();
+    tick = SysTime_TickMs() * mhz * 1000u;
+    sim_add_source(tick_isr, tick, tick, isr_cycles);
+    Energy_Init(&m);
+    Energy_SetWakeCycles((uint16_t)isr_cycles);
+
+    end = sim_now() + (uint64_t)seconds * mhz * 1000000u;
+    __enable_interrupt();
+    while (sim_now() < end)
+        Scheduler_Dispatch();
+    __disable_interrupt();
+
+    for (i = 0; i <= ENERGY_MAX_TASKS; i++)
+        total += Energy_TaskNanojoules((uint8_t)i);
+    total += Energy_SleepNanojoules();
+    us = Energy_ElapsedUs();
+
+    printf("%u task(s) @ %lu MHz, %u ms tick, %lu s simulated, %u mV\n", et_count,
+           (unsigned long)mhz, SysTime_TickMs(), (unsigned long)seconds, m.supply_mv);
+    printf("%-12s %12s %7s %10s\n", "account", "uJ", "share", "avg uA");
+    for (i = 0; i < et_count; i++) {
+        snprintf(name, sizeof(name), "T%d %ums", i, et[i].period_ms);
+        row(name, Energy_TaskNanojoules((uint8_t)i), total, us);
+    }
+    row("overhead", Energy_TaskNanojoules(ENERGY_MAX_TASKS), total, us);
+    nj = Energy_SleepNanojoules();
+    row("idle (LPM0)", nj, total, us);
+    row("total", total, total, us);
+
+    if (us && total) {
+        double ua = total * 1e6 / us / m.supply_mv;
+        double hours = mah * 1000.0 / ua;
+        printf("battery %.0f mAh: %.0f h (%.1f days)\n", mah, hours, hours / 24.0);
+    }
+
+    st = sim_stats();
+    printf("sim cross-check: active+ISR %llu, LPM %llu cycles; accounted %llu, %llu\n",
+           (unsigned long long)(st->active_cycles + st->isr_cycles),
+           (unsigned long long)st->sleep_cycles,
+           (unsigned long long)(us * mhz - sleep_cycles[speed][ENERGY_LPM0]),
+           (unsigned long long)sleep_cycles[speed][ENERGY_LPM0]);
+    return 0;
+}
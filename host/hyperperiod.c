@@ -0,0 +1,188 @@
+/**
+ * @file hyperperiod.c
+ * @brief Hyperperiod and slot-table check for src/scheduler_generator.c, with period proposals.
+ *
+ * The task set is loaded into the generator's own tables and checked with the firmware's
+ * compute_hyperperiod() / count_slots(), so the verdict matches build_schedule() on the
+ * target. If the hyperperiod overflows or the table exceeds the slot budget, every
+ * combination of shortened periods (within the tolerance, restricted to 2^a * 3^b * 5^c)
+ * is searched for the one that fits with the least total relative change, e.g. 33 -> 32 ms.
+ * Shortening a period only makes a task run more often, so the proposal keeps every
+ * deadline; the utilization is printed when slices are given.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define main main_generator
+#include "../src/scheduler_generator.c"
+#undef main
+
+#define MAX_CANDIDATES 8u       // shortened periods tried per task, closest first
+
+typedef struct {
+    uint16_t period_ms;
+    uint16_t slice_ms;
+    uint16_t cand[MAX_CANDIDATES];
+    uint8_t  ncand;
+} htask_t;
+
+static htask_t ht[MAX_TASKS];
+static uint8_t ht_count;
+static uint32_t max_slots = MAX_SLOTS;
+static uint32_t max_hyper = UINT32_MAX;
+
+static uint16_t pick[MAX_TASKS], best[MAX_TASKS];
+static uint32_t best_cost = UINT32_MAX, best_slots;
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "usage: %s [-s slots] [-H ms] [-t percent] period_ms[:slice_ms] ...\n"
+            "  -s  slot budget (default MAX_SLOTS, %u)\n"
+            "  -H  largest acceptable hyperperiod in ms (default: 32-bit limit)\n"
+            "  -t  largest period reduction per task in percent (default 10)\n"
+            "exit status: 0 fits, 1 does not fit as given, 2 usage\n",
+            prog, MAX_SLOTS);
+}
+
+/* 2^a * 3^b * 5^c: periods built from these share long common divisors */
+static int smooth(uint32_t v)
+{
+    while (v % 2u == 0u) v /= 2u;
+    while (v % 3u == 0u) v /= 3u;
+    while (v % 5u == 0u) v /= 5u;
+    return v == 1u;
+}
+
+static void candidates(htask_t *t, uint32_t tol_pct)
+{
+    uint32_t lo = (uint32_t)t->period_ms * (100u - tol_pct) / 100u, q;
+
+    t->ncand = 0;
+    t->cand[t->ncand++] = t->period_ms;
+    for (q = t->period_ms - 1u; q >= lo && q > 0u && t->ncand < MAX_CANDIDATES; q--)
+        if (smooth(q))
+            t->cand[t->ncand++] = (uint16_t)q;
+}
+
+/* Load periods into the generator and run the firmware check */
+static uint32_t check(const uint16_t *period, uint32_t *slots)
+{
+    uint32_t hyper;
+    uint8_t i;
+
+    num_tasks = 0;
+    for (i = 0; i < ht_count; i++)
+        add_task("T", NULL, period[i], ht[i].slice_ms);
+    hyper = compute_hyperperiod();
+    *slots = hyper ? count_slots(hyper) : 0u;
+    return hyper;
+}
+
+static int fits(uint32_t hyper, uint32_t slots)
+{
+    return hyper != 0u && hyper <= max_hyper && slots <= max_slots;
+}
+
+/* Depth-first over candidate periods; hyperperiod and slot count only grow with depth */
+static void search(uint8_t i, uint32_t hyper, uint32_t slots, uint32_t cost)
+{
+    uint8_t c, j;
+
+    if (cost > best_cost)
+        return;
+    if (i == ht_count) {
+        if (cost < best_cost || slots < best_slots) {
+            best_cost = cost;
+            best_slots = slots;
+            memcpy(best, pick, sizeof(best));
+        }
+        return;
+    }
+    for (c = 0; c < ht[i].ncand; c++) {
+        uint16_t q = ht[i].cand[c];
+        uint32_t h = hyper ? lcm(hyper, q) : q, s = 0;
+
+        if (h == 0u || h > max_hyper)
+            continue;
+        pick[i] = q;
+        for (j = 0; j <= i; j++)
+            s += h / pick[j];
+        if (s > max_slots)
+            continue;
+        search((uint8_t)(i + 1u), h, s,
+               cost + (uint32_t)(ht[i].period_ms - q) * 1000u / ht[i].period_ms);
+    }
+}
+
+static void report(const char *title, const uint16_t *period)
+{
+    uint32_t slots, hyper = check(period, &slots), util = 0;
+    uint8_t i;
+
+    printf("%s\n", title);
+    for (i = 0; i < ht_count; i++) {
+        printf("  T%u %5u ms", i, period[i]);
+        if (period[i] != ht[i].period_ms)
+            printf(" (was %u)", ht[i].period_ms);
+        if (ht[i].slice_ms)
+            printf("  slice %u ms", ht[i].slice_ms);
+        printf("\n");
+        util += (uint32_t)ht[i].slice_ms * 1000u / period[i];
+    }
+    if (hyper)
+        printf("  hyperperiod %lu ms, %lu slots (budget %lu)", (unsigned long)hyper,
+               (unsigned long)slots, (unsigned long)max_slots);
+    else
+        printf("  hyperperiod overflows 32 bits");
+    if (util)
+        printf(", utilization %lu.%lu%%", (unsigned long)(util / 10u), (unsigned long)(util % 10u));
+    printf("\n");
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t tol = 10, slots, hyper, new_slots;
+    uint16_t given[MAX_TASKS];
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-s") && i + 1 < argc)      max_slots = strtoul(argv[++i], NULL, 0);
+        else if (!strcmp(argv[i], "-H") && i + 1 < argc) max_hyper = strtoul(argv[++i], NULL, 0);
+        else if (!strcmp(argv[i], "-t") && i + 1 < argc) tol = strtoul(argv[++i], NULL, 0);
+        else if (argv[i][0] != '-' && ht_count < MAX_TASKS) {
+            char *end;
+            unsigned long p = strtoul(argv[i], &end, 0);
+            if (!p || p > UINT16_MAX || (*end && *end != ':')) { usage(argv[0]); return 2; }
+            ht[ht_count].period_ms = (uint16_t)p;
+            ht[ht_count].slice_ms = *end ? (uint16_t)strtoul(end + 1, NULL, 0) : 0;
+            given[ht_count++] = (uint16_t)p;
+        }
+        else { usage(argv[0]); return 2; }
+    }
+    if (!ht_count || tol > 90) { usage(argv[0]); return 2; }
+
+    report("given", given);
+    hyper = check(given, &slots);
+    if (fits(hyper, slots)) {
+        printf("fits\n");
+        return 0;
+    }
+
+    for (i = 0; i < ht_count; i++)
+        candidates(&ht[i], tol);
+    search(0, 0, 0, 0);
+    if (best_cost == UINT32_MAX) {
+        printf("no periods within -%lu%% fit; raise -t or split the task set\n", (unsigned long)tol);
+        return 1;
+    }
+
+    report("proposed", best);
+    check(best, &new_slots);
+    if (slots)
+        printf("table %lu -> %lu slots (-%lu%%)\n", (unsigned long)slots, (unsigned long)new_slots,
+               (unsigned long)((slots - new_slots) * 100u / slots));
+    return 1;
+}
@@ -0,0 +1,166 @@
+/**
+ * @file msp430.h
+ * @brief Host stand-in for the TI device header, used by the simulator builds in host/.
+ *
+ * - Peripheral registers are plain globals (defined in host/sim.c), so firmware
+ *   sources compile unchanged with the native compiler
+ * - SR intrinsics, __delay_cycles() and LPM entry advance simulated time (host/sim.h)
+ * - The GCC interrupt(vector) attribute is mapped to "used"; the harness calls ISRs directly
+ */
+
+#ifndef HOST_MSP430_H
+#define HOST_MSP430_H
+
+#include <stdint.h>
+
+/* ---------- Registers ---------- */
+#ifndef SIM_REG
+#define SIM_REG(type, name) extern volatile type name;
+#endif
+
+SIM_REG(uint16_t, WDTCTL)
+SIM_REG(uint16_t, PM5CTL0)
+SIM_REG(uint16_t, SYSCTL)
+SIM_REG(uint16_t, FRCTL0)
+SIM_REG(uint8_t,  CSCTL0_H)
+SIM_REG(uint16_t, CSCTL1)
+SIM_REG(uint16_t, CSCTL2)
+SIM_REG(uint16_t, CSCTL3)
+
+SIM_REG(uint8_t,  P1DIR)
+SIM_REG(uint8_t,  P1OUT)
+SIM_REG(uint8_t,  P1SEL0)
+SIM_REG(uint8_t,  P1SEL1)
+SIM_REG(uint8_t,  P2DIR)
+SIM_REG(uint8_t,  P2OUT)
+SIM_REG(uint8_t,  P2SEL0)
+SIM_REG(uint8_t,  P2SEL1)
+SIM_REG(uint8_t,  P3DIR)
+SIM_REG(uint8_t,  P3OUT)
+SIM_REG(uint8_t,  P3SEL0)
+SIM_REG(uint8_t,  P3SEL1)
+SIM_REG(uint8_t,  P5DIR)
+SIM_REG(uint8_t,  P5OUT)
+SIM_REG(uint8_t,  P5SEL0)
+SIM_REG(uint8_t,  P5SEL1)
+
+SIM_REG(uint16_t, TA0CTL)
+SIM_REG(uint16_t, TA0R)
+SIM_REG(uint16_t, TA0CCTL0)
+SIM_REG(uint16_t, TA0CCR0)
+SIM_REG(uint16_t, TA0IV)
+
+SIM_REG(uint16_t, TB0CTL)
+SIM_REG(uint16_t, TB0R)
+SIM_REG(uint16_t, TB0CCTL0)
+SIM_REG(uint16_t, TB0CCR0)
+SIM_REG(uint16_t, TB0IV)
+
+SIM_REG(uint16_t, UCA0CTLW0)
+SIM_REG(uint16_t, UCA0BRW)
+SIM_REG(uint16_t, UCA0MCTLW)
+SIM_REG(uint16_t, UCA0IE)
+SIM_REG(uint16_t, UCA0IFG)
+SIM_REG(uint16_t, UCA0IV)
+SIM_REG(uint16_t, UCA0TXBUF)
+SIM_REG(uint16_t, UCA0RXBUF)
+
+SIM_REG(uint16_t, CRCINIRES)
+SIM_REG(uint8_t,  CRCDIRB_L)
+
+/* ---------- Bit definitions ---------- */
+#define BIT0 (0x0001)
+#define BIT1 (0x0002)
+#define BIT2 (0x0004)
+#define BIT3 (0x0008)
+#define BIT4 (0x0010)
+#define BIT5 (0x0020)
+#define BIT6 (0x0040)
+#define BIT7 (0x0080)
+
+#define WDTPW       (0x5A00)
+#define WDTHOLD     (0x0080)
+#define LOCKLPM5    (0x0001)
+
+#define CSKEY       (0xA500)
+#define CSKEY_H     (0xA5)
+#define DCORSEL     (0x0040)
+#define DCOFSEL_0   (0x0000)
+#define DCOFSEL_4   (0x0008)
+#define DCOFSEL_6   (0x000C)
+#define SELA__VLOCLK (0x0100)
+#define SELS__DCOCLK (0x0030)
+#define SELM__DCOCLK (0x0003)
+#define DIVA__1     (0x0000)
+#define DIVS__1     (0x0000)
+#define DIVM__1     (0x0000)
+#define SYSRIVECT   (0x0001)
+#define FRCTLPW     (0xA500)
+#define NWAITS_0    (0x0000)
+#define NWAITS_1    (0x0010)
+
+#define CCIFG       (0x0001)
+#define CCIE        (0x0010)
+#define TACLR       (0x0004)
+#define TAIE        (0x0002)
+#define TASSEL_2    (0x0200)
+#define TASSEL__ACLK  (0x0100)
+#define TASSEL__SMCLK (0x0200)
+#define ID_3        (0x00C0)
+#define ID__1       (0x0000)
+#define ID__8       (0x00C0)
+#define MC_1        (0x0010)
+#define MC__STOP    (0x0000)
+#define MC__UP      (0x0010)
+#define MC__CONTINUOUS (0x0020)
+#define TBCLR       (0x0004)
+#define TBSSEL__ACLK  (0x0100)
+#define TBSSEL__SMCLK (0x0200)
+
+#define UCSWRST     (0x0001)
+#define UCSSEL__SMCLK (0x0080)
+#define UCOS16      (0x0001)
+#define UCBRF_5     (0x0050)
+#define UCBRF_8     (0x0080)
+#define UCBRF_10    (0x00A0)
+#define UCRXIFG     (0x0001)
+#define UCTXIFG     (0x0002)
+#define UCRXIE      (0x0001)
+#define UCTXIE      (0x0002)
+#define USCI_UART_UCRXIFG (0x0002)
+#define USCI_UART_UCTXIFG (0x0004)
+
+/* ---------- Status register ---------- */
+#define GIE         (0x0008)
+#define CPUOFF      (0x0010)
+#define OSCOFF      (0x0020)
+#define SCG0        (0x0040)
+#define SCG1        (0x0080)
+#define LPM0_bits   (CPUOFF)
+#define LPM1_bits   (SCG0 | CPUOFF)
+#define LPM3_bits   (SCG1 | SCG0 | CPUOFF)
+#define LPM4_bits   (SCG1 | SCG0 | OSCOFF | CPUOFF)
+
+/* ---------- Interrupt vectors ---------- */
+#define TIMER0_A0_VECTOR  (45)
+#define USCI_A0_VECTOR    (49)
+#define TIMER0_B0_VECTOR  (63)
+#define TIMER0_B1_VECTOR  (62)
+
+/* Vector attributes are accepted and ignored (x86 "interrupt" means something else) */
+#define interrupt(vector) used
+
+/* ---------- Intrinsics (implemented in host/sim.c) ---------- */
+void __bis_SR_register(uint16_t bits);
+void __bic_SR_register(uint16_t bits);
+void __bis_SR_register_on_exit(uint16_t bits);
+void __bic_SR_register_on_exit(uint16_t bits);
+uint16_t __get_SR_register(void);
+void __enable_interrupt(void);
+void __disable_interrupt(void);
+uint16_t __get_interrupt_state(void);
+void __set_interrupt_state(uint16_t sr);
+void __no_operation(void);
+void __delay_cycles(unsigned long cycles);
+
+#endif /* HOST_MSP430_H */
@@ -0,0 +1,431 @@
+/**
+ * @file logfile.c
+ * @brief lib/blklog.c on host/sim.c with a Linux file as the flash region.
+ *
+ * The logger is built with LOG_MEDIA_* replaced by a file backend: a sector write or a
+ * 4 KB erase completes after the time a 25-series SPI NOR flash would take (command and
+ * data at the SPI clock plus two page programs, or the erase time), and only then
+ * reaches the file. Programming follows NOR rules: bits only go from 1 to 0, and a
+ * byte that would need a 0 turned back into 1 is counted as programmed over old data.
+ * BlkLog_Service() polls it from a 1 ms lib/scheduler.c task as on the target.
+ *
+ * Two producer tasks (1 ms and 10 ms) append records of 4..64 bytes at the requested
+ * rate; each payload starts with a per-type counter of accepted records. After the run
+ * the logger is synced, the region is read back in sequence order through
+ * BlkLog_ReadSector()/BlkLog_Next(), and every type must show consecutive counters
+ * ending at the last accepted record (older ones may be gone when the ring wrapped).
+ * The region is then mounted again and must resume at the same sequence number.
+ *
+ * Finally the target is reset in the middle of sector writes (-T): the pages finished
+ * so far, last first, and random bits of the page in progress reach the file. The
+ * remount must skip a sector left partly programmed to the next erase block, and the
+ * next sector must then be written on erased flash and read back.
+ * Exit status 1 on any mismatch or any byte programmed over old data.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim.h"
+
+#define SERVER_CLOCK() ((uint32_t)(sim_now() >> 3))
+
+static void file_init(void);
+static int file_read(uint32_t sector, uint16_t off, uint8_t *buf, uint16_t n);
+static int file_write(uint32_t sector, const uint8_t *buf);
+static int file_erase(uint32_t sector);
+static int file_poll(void);
+#define LOG_MEDIA_INIT(dev)                 file_init()
+#define LOG_MEDIA_READ(sector, off, buf, n) file_read(sector, off, buf, n)
+#define LOG_MEDIA_WRITE(sector, buf)        file_write(sector, buf)
+#define LOG_MEDIA_ERASE(sector)             file_erase(sector)
+#define LOG_MEDIA_POLL(now_ms)              file_poll()
+
+#include "../lib/blklog.c"
+#include "../lib/server.c"
+#include "../lib/scheduler.c"
+
+#define MCLK_HZ         8000000u
+#define TYPES           2u
+#define MIN_DATA        4u
+#define MAX_DATA        64u
+#define PAGE            256u
+#define PAGES           (BLKLOG_SECTOR / PAGE)
+
+/* ---------- File backend ---------- */
+
+static FILE *media;
+static const char *media_path = "build/host/blklog.bin";
+static uint32_t media_sectors = 256;
+static uint32_t spi_hz = 8000000u, page_us = 700, erase_ms = 45;
+static uint8_t pending[BLKLOG_SECTOR];
+static uint32_t pending_sector;
+static uint8_t pending_erase;
+static uint64_t done_at, write_at;
+static uint32_t page_cycles;                // one page: WREN, PP, address, data, program
+static uint64_t media_busy_cycles;
+static uint32_t overwritten;                // bytes programmed over non-erased flash
+
+static void file_init(void)
+{
+}
+
+static int file_read(uint32_t sector, uint16_t off, uint8_t *buf, uint16_t n)
+{
+    if (sector >= media_sectors ||
+        fseek(media, (long)sector * BLKLOG_SECTOR + off, SEEK_SET) != 0 ||
+        fread(buf, 1, n, media) != n)
+        return -1;
+    return 0;
+}
+
+static void file_start(uint32_t sector, uint64_t cycles)
+{
+    pending_sector = sector;
+    done_at = sim_now() + cycles;
+    media_busy_cycles += cycles;
+}
+
+static int file_write(uint32_t sector, const uint8_t *buf)
+{
+    /* WREN + PP + 4 address + 256 data per page, RDSR polls ignored */
+    uint64_t bits = 8u * (1u + 4u + PAGE + 1u);
+
+    if (sector >= media_sectors)
+        return -1;
+    memcpy(pending, buf, BLKLOG_SECTOR);
+    pending_erase = 0;
+    page_cycles = (uint32_t)(bits * MCLK_HZ / spi_hz + (uint64_t)page_us * (MCLK_HZ / 1000000u));
+    write_at = sim_now();
+    file_start(sector, (uint64_t)PAGES * page_cycles);
+    return 0;
+}
+
+static int file_erase(uint32_t sector)
+{
+    if (sector >= media_sectors || sector % BLKLOG_ERASE)
+        return -1;
+    pending_erase = 1;
+    file_start(sector, (uint64_t)erase_ms * (MCLK_HZ / 1000u));
+    return 0;
+}
+
+/* NOR page program: ANDs into the file; returns 1 if any bit was cleared */
+static int file_program(uint32_t sector, uint16_t off, const uint8_t *src, uint16_t n)
+{
+    uint8_t cur[PAGE];
+    uint16_t i;
+    int dirty = 0;
+
+    if (file_read(sector, off, cur, n) != 0)
+        return -1;
+    for (i = 0; i < n; i++) {
+        if ((cur[i] & src[i]) != src[i])
+            overwritten++;
+        dirty |= src[i] != 0xFF;
+        cur[i] &= src[i];
+    }
+    if (fseek(media, (long)sector * BLKLOG_SECTOR + off, SEEK_SET) != 0 ||
+        fwrite(cur, 1, n, media) != n)
+        return -1;
+    return dirty;
+}
+
+static int file_poll(void)
+{
+    static const uint8_t erased[BLKLOG_SECTOR * BLKLOG_ERASE] = { [0 ... BLKLOG_SECTOR * BLKLOG_ERASE - 1] = 0xFF };
+    uint16_t p;
+
+    sim_consume(80);
+    if (sim_now() < done_at)
+        return LOG_BUSY;
+    if (pending_erase) {
+        if (fseek(media, (long)pending_sector * BLKLOG_SECTOR, SEEK_SET) != 0 ||
+            fwrite(erased, 1, sizeof(erased), media) != sizeof(erased))
+            return -1;
+    } else {
+        for (p = 0; p < PAGES; p++)
+            if (file_program(pending_sector, p * PAGE, pending + p * PAGE, PAGE) < 0)
+                return -1;
+    }
+    fflush(media);
+    return 0;
+}
+
+/* Reset during a sector write: finished pages (last first) reach the file, and the
+ * page in progress clears a random half of the bits it would clear. Returns 1 if any
+ * bit of the sector was cleared. */
+static int file_tear(void)
+{
+    uint32_t done = (uint32_t)((sim_now() - write_at) / page_cycles);
+    uint8_t part[PAGE];
+    uint16_t p, i;
+    int dirty = 0;
+
+    for (p = 0; p < PAGES && p <= done; p++) {
+        uint16_t off = (uint16_t)(PAGES - 1u - p) * PAGE;
+        const uint8_t *src = pending + off;
+
+        if (p == done) {
+            for (i = 0; i < PAGE; i++)
+                part[i] = (uint8_t)(src[i] | sim_rand());
+            src = part;
+        }
+        dirty |= file_program(pending_sector, off, src, PAGE) > 0;
+    }
+    fflush(media);
+    done_at = 0;
+    return dirty;
+}
+
+/* ---------- Workload ---------- */
+
+static uint32_t rate = 12000;               // payload bytes per second, both producers
+static uint32_t accepted[TYPES], dropped[TYPES];
+static uint8_t stop;
+
+/* Append records while this type's byte credit lasts; the overshoot carries over */
+static void produce(uint8_t type, uint32_t budget)
+{
+    static int32_t credit[TYPES];
+    uint8_t rec[MAX_DATA];
+    uint8_t len, i;
+
+    credit[type] += (int32_t)budget;
+    while (!stop && credit[type] > 0) {
+        len = (uint8_t)sim_rand_range(MIN_DATA, MAX_DATA);
+        memcpy(rec, &accepted[type], 4);
+        for (i = 4; i < len; i++)
+            rec[i] = (uint8_t)(accepted[type] * 7u + i);
+        sim_consume(60u + 4u * len);
+        if (BlkLog_Append(type, rec, len) == 0)
+            accepted[type]++;
+        else
+            dropped[type]++;
+        credit[type] -= len;
+    }
+}
+
+static void task_fast(uint32_t now_ms)
+{
+    (void)now_ms;
+    produce(0, rate / 2u / 1000u);
+}
+
+static void task_burst(uint32_t now_ms)
+{
+    (void)now_ms;
+    produce(1, rate / 2u / 100u);
+}
+
+static void tick_isr(void)
+{
+    SysTime_Tick();
+    Scheduler_Tick();
+    __bic_SR_register_on_exit(LPM0_bits);
+}
+
+/* ---------- Read-back ---------- */
+
+static uint32_t verify(void)
+{
+    static uint8_t sector[BLKLOG_SECTOR];
+    uint32_t next = BlkLog_NextSeq(), seq, bad = 0, valid = 0, gaps = 0;
+    uint32_t seen[TYPES], last[TYPES];
+    uint8_t have[TYPES] = { 0 }, started = 0, t;
+    blklog_rec_t rec;
+    uint16_t pos;
+
+    seq = next > media_sectors ? next - media_sectors : 0;
+    for (; seq < next; seq++) {
+        if (BlkLog_ReadSector(seq, sector) != 0) {
+            gaps += started;            // only the erase block ahead of the writer may be gone
+            continue;
+        }
+        started = 1;
+        valid++;
+        for (pos = 0; BlkLog_Next(sector, &pos, &rec);) {
+            uint32_t c;
+            uint8_t i;
+
+            if (rec.type >= TYPES || rec.len < MIN_DATA || rec.len > MAX_DATA) {
+                bad++;
+                continue;
+            }
+            t = rec.type;
+            memcpy(&c, rec.data, 4);
+            for (i = 4; i < rec.len; i++)
+                if (rec.data[i] != (uint8_t)(c * 7u + i))
+                    bad++;
+            if (have[t] && c != last[t] + 1u)
+                bad++;
+            if (!have[t])
+                seen[t] = c;
+            have[t] = 1;
+            last[t] = c;
+        }
+    }
+    for (t = 0; t < TYPES; t++) {
+        if (accepted[t] && (!have[t] || last[t] != accepted[t] - 1u))
+            bad++;
+        if (have[t] && next <= media_sectors && seen[t] != 0)
+            bad++;                      // nothing overwritten yet: must start at 0
+    }
+    printf("read back %lu of %lu sectors in the ring, %lu records checked per type:",
+           (unsigned long)valid, (unsigned long)(next < media_sectors ? next : media_sectors),
+           (unsigned long)TYPES);
+    for (t = 0; t < TYPES; t++)
+        printf(" %lu..%lu", have[t] ? (unsigned long)seen[t] : 0ul,
+               have[t] ? (unsigned long)last[t] : 0ul);
+    printf("\n");
+    return bad + gaps;
+}
+
+/* ---------- Torn writes ---------- */
+
+/* Reset at a random point of the next sector write, remount, then write one more sector */
+static uint32_t tear(uint32_t *skipped)
+{
+    static uint8_t sector[BLKLOG_SECTOR];
+    uint8_t rec[MIN_DATA] = { 0 };
+    uint32_t seq, expect, bad = 0;
+    uint8_t finished;
+    int dirty;
+
+    BlkLog_Append(0, rec, sizeof(rec));
+    while (BlkLog_Sync() != 0 || media_op != OP_WRITE)
+        Scheduler_Dispatch();
+    seq = BlkLog_NextSeq();
+    sim_consume(sim_rand_range(0, PAGES * page_cycles - 1u));
+    finished = sim_now() >= done_at;    // tick ISRs may carry the reset past the end
+    dirty = file_tear();
+
+    BlkLog_Init(NULL, 0, media_sectors);
+    if (finished)
+        expect = seq + 1u;
+    else if (dirty && seq % BLKLOG_ERASE)
+        expect = (seq / BLKLOG_ERASE + 1u) * BLKLOG_ERASE;
+    else
+        expect = seq;
+    *skipped += !finished && expect != seq;
+    if (BlkLog_NextSeq() != expect) {
+        printf("torn sector %lu: remount resumes at %lu, expected %lu\n", (unsigned long)seq,
+               (unsigned long)BlkLog_NextSeq(), (unsigned long)expect);
+        bad++;
+    }
+
+    BlkLog_Append(1, rec, sizeof(rec));
+    while (BlkLog_Sync() != 0 || BlkLog_Busy())
+        Scheduler_Dispatch();
+    if (BlkLog_GetStats()->errors || BlkLog_ReadSector(BlkLog_NextSeq() - 1u, sector) != 0) {
+        printf("torn sector %lu: next sector not written\n", (unsigned long)seq);
+        bad++;
+    }
+    return bad;
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "usage: %s [-d seconds] [-r bytes_per_s] [-n sectors] [-f file] [-S seed]\n"
+            "          [-c spi_hz] [-p page_us] [-e erase_ms] [-T tears]\n"
+            "  -d  simulated time (default 10)\n"
+            "  -r  record payload rate of both producers (default 12000)\n"
+            "  -n  region size in 512-byte sectors (default 256)\n"
+            "  -f  backing file, created erased (default build/host/blklog.bin)\n"
+            "  -S  seed (default 1)\n"
+            "  -c  SPI clock (default 8000000)\n"
+            "  -p  page program time (default 700)\n"
+            "  -e  4 KB erase time (default 45)\n"
+            "  -T  resets during a sector write after the run (default 32)\n", prog);
+}
+
+int main(int argc, char **argv)
+{
+    static const uint8_t ff[BLKLOG_SECTOR] = { [0 ... BLKLOG_SECTOR - 1] = 0xFF };
+    uint32_t seconds = 10, seed = 1, tears = 32, skipped = 0, s, next, bad;
+    uint16_t errors;
+    const blklog_stats_t *st;
+    double secs;
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-d") && i + 1 < argc)      seconds = strtoul(argv[++i], NULL, 0);
+        else if (!strcmp(argv[i], "-r") && i + 1 < argc) rate = strtoul(argv[++i], NULL, 0);
+        else if (!strcmp(argv[i], "-n") && i + 1 < argc) media_sectors = strtoul(argv[++i], NULL, 0);
+        else if (!strcmp(argv[i], "-f") && i + 1 < argc) media_path = argv[++i];
+        else if (!strcmp(argv[i], "-S") && i + 1 < argc) seed = strtoul(argv[++i], NULL, 0);
+        else if (!strcmp(argv[i], "-c") && i + 1 < argc) spi_hz = strtoul(argv[++i], NULL, 0);
+        else if (!strcmp(argv[i], "-p") && i + 1 < argc) page_us = strtoul(argv[++i], NULL, 0);
+        else if (!strcmp(argv[i], "-e") && i + 1 < argc) erase_ms = strtoul(argv[++i], NULL, 0);
+        else if (!strcmp(argv[i], "-T") && i + 1 < argc) tears = strtoul(argv[++i], NULL, 0);
+        else { usage(argv[0]); return 2; }
+    }
+    if (!spi_hz) { usage(argv[0]); return 2; }
+
+    media = fopen(media_path, "w+b");
+    if (!media) {
+        perror(media_path);
+        return 2;
+    }
+    for (s = 0; s < media_sectors; s++)
+        fwrite(ff, 1, sizeof(ff), media);
+
+    sim_reset(MCLK_HZ, seed);
+    Clk_Init(CLK_8MHZ);
+    Defer_Init();
+    sim_add_source(tick_isr, MCLK_HZ / 1000u, MCLK_HZ / 1000u, 40);
+    if (BlkLog_Init(NULL, 0, media_sectors) != 0) {
+        fprintf(stderr, "region of %lu sectors is not a multiple of %u (min %u)\n",
+                (unsigned long)media_sectors, BLKLOG_ERASE, 2u * BLKLOG_ERASE);
+        return 2;
+    }
+    Scheduler_AddTask(BlkLog_Service, 1, 0, 0);
+    Scheduler_AddTask(task_fast, 1, 0, 0);
+    Scheduler_AddTask(task_burst, 10, 5, 0);
+
+    __enable_interrupt();
+    while (sim_now() < (uint64_t)seconds * MCLK_HZ)
+        Scheduler_Dispatch();
+    stop = 1;
+    while (BlkLog_Sync() != 0 || BlkLog_Busy())
+        Scheduler_Dispatch();
+    __disable_interrupt();
+
+    st = BlkLog_GetStats();
+    secs = (double)sim_now() / MCLK_HZ;
+    printf("accepted %lu records (%.1f KB/s), dropped %lu, %lu sectors written (%.1f KB/s), "
+           "%u errors\n", (unsigned long)st->records, st->bytes / secs / 1024.0,
+           (unsigned long)st->dropped, (unsigned long)st->sectors,
+           st->sectors * (double)BLKLOG_SECTOR / secs / 1024.0, st->errors);
+    printf("flash busy %.1f%%, CPU in LPM0 %.1f%%\n", 100.0 * media_busy_cycles / sim_now(),
+           100.0 * sim_stats()->sleep_cycles / sim_now());
+
+    errors = st->errors;
+    bad = verify();
+    next = BlkLog_NextSeq();
+    BlkLog_Init(NULL, 0, media_sectors);
+    if (BlkLog_NextSeq() != next) {
+        printf("remount resumes at sector %lu, expected %lu\n",
+               (unsigned long)BlkLog_NextSeq(), (unsigned long)next);
+        bad++;
+    }
+
+    __enable_interrupt();
+    for (s = 0; s < tears; s++)
+        bad += tear(&skipped);
+    __disable_interrupt();
+    fclose(media);
+    if (tears)
+        printf("%lu resets during a sector write, %lu torn sectors skipped to the next "
+               "erase block\n", (unsigned long)tears, (unsigned long)skipped);
+    if (overwritten)
+        printf("%lu bytes programmed over non-erased flash\n", (unsigned long)overwritten);
+    if (bad || errors || overwritten) {
+        printf("%lu mismatches in %s\n", (unsigned long)bad, media_path);
+        return 1;
+    }
+    printf("all accepted records read back in order; remount resumes at sector %lu\n",
+           (unsigned long)next);
+    return 0;
+}
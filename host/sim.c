@@ -0,0 +1,312 @@
+/**
+ * @file sim.c
+ * @brief Cycle-level time and interrupt model for running firmware code on the host.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Define the register globals declared by the host msp430.h */
+#define SIM_REG(type, name) volatile type name;
+#include <msp430.h>
+#include "sim.h"
+
+#define SR_LPM_BITS (CPUOFF | OSCOFF | SCG0 | SCG1)
+#define NEVER       UINT64_MAX
+
+typedef struct {
+    sim_isr_t isr;
+    uint32_t  period;
+    uint32_t  isr_cycles;
+    uint64_t  nominal;     // next nominal firing
+    uint64_t  fire_at;     // nominal + jitter
+    uint8_t   pending;
+} source_t;
+
+static source_t sources[SIM_MAX_SOURCES];
+static uint8_t  source_count;
+static uint64_t now;
+static uint32_t mclk_hz;
+static uint16_t sr;
+static uint8_t  in_isr;
+static uint16_t *exit_sr;          // SR image restored on ISR exit
+static uint32_t fire_jitter;
+static uint32_t intrinsic_delay;
+static uint32_t rng_state = 1;
+static void (*sleep_hook)(void);
+static sim_stats_t stats;
+
+uint32_t sim_rand(void)
+{
+    /* xorshift32 */
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+uint32_t sim_rand_range(uint32_t lo, uint32_t hi)
+{
+    if (hi <= lo)
+        return lo;
+    return lo + sim_rand() % (hi - lo + 1u);
+}
+
+void sim_reset(uint32_t hz, uint32_t seed)
+{
+    memset(sources, 0, sizeof(sources));
+    memset(&stats, 0, sizeof(stats));
+    source_count = 0;
+    now = 0;
+    mclk_hz = hz;
+    sr = 0;
+    in_isr = 0;
+    exit_sr = NULL;
+    fire_jitter = 0;
+    intrinsic_delay = 0;
+    sleep_hook = NULL;
+    rng_state = seed ? seed : 1u;
+    UCA0IFG = UCTXIFG;     // TX buffer always ready
+}
+
+static void arm(source_t *s, uint64_t nominal)
+{
+    s->nominal = nominal;
+    s->fire_at = nominal + (fire_jitter ? sim_rand_range(0, fire_jitter) : 0u);
+}
+
+int sim_add_source(sim_isr_t isr, uint32_t period_cycles, uint32_t first_cycles, uint32_t isr_cycles)
+{
+    source_t *s;
+
+    if (source_count >= SIM_MAX_SOURCES)
+        return -1;
+    s = &sources[source_count];
+    s->isr = isr;
+    s->period = period_cycles;
+    s->isr_cycles = isr_cycles;
+    s->pending = 0;
+    if (period_cycles || first_cycles)
+        arm(s, now + first_cycles);
+    else
+        s->nominal = s->fire_at = NEVER;
+    return source_count++;
+}
+
+static void latch(void);
+
+void sim_trigger(int id, uint64_t at_cycles)
+{
+    sources[id].nominal = sources[id].fire_at = at_cycles;
+    if (at_cycles <= now)
+        latch();            // already due: pending now, as a flag set by software
+}
+
+void sim_cancel(int id)
+{
+    sources[id].nominal = sources[id].fire_at = NEVER;
+    sources[id].pending = 0;
+}
+
+void sim_set_jitter(uint32_t fire, uint32_t delay)
+{
+    fire_jitter = fire;
+    intrinsic_delay = delay;
+}
+
+void sim_set_sleep_hook(void (*hook)(void))
+{
+    sleep_hook = hook;
+}
+
+uint64_t sim_now(void)          { return now; }
+uint32_t sim_mclk_hz(void)      { return mclk_hz; }
+const sim_stats_t *sim_stats(void) { return &stats; }
+
+/* Earliest firing among sources, NEVER if none */
+static int next_source(uint64_t *at)
+{
+    int best = -1;
+    uint8_t i;
+
+    *at = NEVER;
+    for (i = 0; i < source_count; i++) {
+        if (sources[i].fire_at < *at) {
+            *at = sources[i].fire_at;
+            best = i;
+        }
+    }
+    return best;
+}
+
+/* Latch every source whose firing time has passed */
+static void latch(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < source_count; i++) {
+        source_t *s = &sources[i];
+        while (s->fire_at <= now) {
+            s->pending = 1;
+            if (s->period)
+                arm(s, s->nominal + s->period);
+            else
+                s->nominal = s->fire_at = NEVER;
+        }
+    }
+}
+
+static void advance_raw(uint64_t cycles, uint64_t *bucket)
+{
+    now += cycles;
+    *bucket += cycles;
+    latch();
+}
+
+/* Run pending ISRs while GIE is set, highest priority (lowest id) first */
+static void service(void)
+{
+    while ((sr & GIE) && !in_isr) {
+        uint8_t i;
+        uint16_t saved;
+
+        for (i = 0; i < source_count && !sources[i].pending; i++) { }
+        if (i == source_count)
+            return;
+
+        sources[i].pending = 0;
+        saved = sr;
+        sr &= (uint16_t)~(GIE | SR_LPM_BITS);
+        in_isr = 1;
+        exit_sr = &saved;
+        advance_raw(sources[i].isr_cycles, &stats.isr_cycles);
+        sources[i].isr();
+        in_isr = 0;
+        exit_sr = NULL;
+        stats.isr_count++;
+        sr = saved;
+    }
+}
+
+void sim_consume(uint32_t cycles)
+{
+    uint64_t left = cycles;
+
+    while (left) {
+        uint64_t at;
+        uint64_t step;
+
+        next_source(&at);
+        step = (at > now && at - now < left) ? at - now : left;
+        if (in_isr) {
+            advance_raw(left, &stats.isr_cycles);
+            return;
+        }
+        advance_raw(step, &stats.active_cycles);
+        left -= step;
+        service();
+    }
+    service();
+}
+
+static void inject_delay(void)
+{
+    if (intrinsic_delay)
+        sim_consume(sim_rand_range(0, intrinsic_delay));
+}
+
+static void sleep_until_woken(void)
+{
+    if (!(sr & GIE)) {
+        fprintf(stderr, "sim: LPM entered with GIE clear at cycle %llu (deadlock)\n",
+                (unsigned long long)now);
+        abort();
+    }
+    if (sleep_hook)
+        sleep_hook();
+    while (sr & CPUOFF) {
+        uint64_t at;
+
+        service();
+        if (!(sr & CPUOFF))
+            break;
+        if (next_source(&at) < 0) {
+            fprintf(stderr, "sim: LPM with no interrupt source left (deadlock)\n");
+            abort();
+        }
+        if (at > now)
+            advance_raw(at - now, &stats.sleep_cycles);
+    }
+    stats.wakeups++;
+}
+
+/* ---------- Intrinsics ---------- */
+
+void __bis_SR_register(uint16_t bits)
+{
+    inject_delay();
+    sr |= bits;
+    if (sr & CPUOFF)
+        sleep_until_woken();
+    else
+        service();
+}
+
+void __bic_SR_register(uint16_t bits)
+{
+    inject_delay();
+    sr &= (uint16_t)~bits;
+}
+
+void __bis_SR_register_on_exit(uint16_t bits)
+{
+    if (exit_sr)
+        *exit_sr |= bits;
+}
+
+void __bic_SR_register_on_exit(uint16_t bits)
+{
+    if (exit_sr)
+        *exit_sr &= (uint16_t)~bits;
+}
+
+uint16_t __get_SR_register(void)
+{
+    return sr;
+}
+
+void __enable_interrupt(void)
+{
+    inject_delay();
+    sr |= GIE;
+    service();
+}
+
+void __disable_interrupt(void)
+{
+    inject_delay();
+    sr &= (uint16_t)~GIE;
+}
+
+uint16_t __get_interrupt_state(void)
+{
+    inject_delay();
+    return sr;
+}
+
+void __set_interrupt_state(uint16_t state)
+{
+    sr = (uint16_t)((sr & ~GIE) | (state & GIE));
+    service();
+}
+
+void __no_operation(void)
+{
+    sim_consume(1);
+}
+
+void __delay_cycles(unsigned long cycles)
+{
+    sim_consume((uint32_t)cycles);
+}
@@ -0,0 +1,92 @@
+/**
+ * @file sim.h
+ * @brief Cycle-level time and interrupt model for running firmware code on the host.
+ *
+ * - Simulated time advances only through the intrinsics in host/include/msp430.h,
+ *   __delay_cycles() and sim_consume()
+ * - Interrupt sources fire periodically (with optional jitter) or when triggered;
+ *   a pending source is serviced as soon as GIE is set, lowest id first
+ * - Every intrinsic can inject a random delay so ISRs land inside the firmware's
+ *   critical-section windows
+ */
+
+#ifndef SIM_H
+#define SIM_H
+
+#include <stdint.h>
+
+#define SIM_MAX_SOURCES 8
+
+typedef void (*sim_isr_t)(void);
+
+typedef struct {
+    uint64_t active_cycles;   /**< CPU executing main-loop or task code */
+    uint64_t isr_cycles;      /**< CPU executing ISRs (including entry/exit) */
+    uint64_t sleep_cycles;    /**< CPU off in LPM */
+    uint32_t isr_count;
+    uint32_t wakeups;         /**< LPM exits */
+} sim_stats_t;
+
+/**
+ * @brief Reset time, SR, sources and statistics.
+ *
+ * @param mclk_hz Simulated MCLK (cycles per second).
+ * @param seed Seed for jitter and injected delays.
+ */
+void sim_reset(uint32_t mclk_hz, uint32_t seed);
+
+/**
+ * @brief Register an interrupt source. Lower ids have higher priority.
+ *
+ * @param isr Handler, called with GIE clear.
+ * @param period_cycles Period, 0 for a source fired only by sim_trigger().
+ * @param first_cycles Time of the first nominal firing.
+ * @param isr_cycles CPU cycles charged per ISR execution.
+ * @return Source id, or -1 if full.
+ */
+int sim_add_source(sim_isr_t isr, uint32_t period_cycles, uint32_t first_cycles, uint32_t isr_cycles);
+
+/**
+ * @brief Fire source id at absolute time at_cycles (replaces its next firing); a time
+ *        already reached makes it pending at once.
+ */
+void sim_trigger(int id, uint64_t at_cycles);
+
+/**
+ * @brief Stop a source from firing again.
+ */
+void sim_cancel(int id);
+
+/**
+ * @brief Randomize timing.
+ *
+ * @param fire_jitter Each firing is delayed by 0..fire_jitter cycles (no drift).
+ * @param intrinsic_delay Each intrinsic call first burns 0..intrinsic_delay cycles.
+ */
+void sim_set_jitter(uint32_t fire_jitter, uint32_t intrinsic_delay);
+
+/**
+ * @brief Called each time the firmware enters LPM with GIE set.
+ */
+void sim_set_sleep_hook(void (*hook)(void));
+
+/**
+ * @brief Burn CPU cycles in the current context (interrupts fire if GIE is set).
+ */
+void sim_consume(uint32_t cycles);
+
+uint64_t sim_now(void);
+uint32_t sim_mclk_hz(void);
+const sim_stats_t *sim_stats(void);
+
+/**
+ * @brief Small deterministic PRNG shared by the simulator and harnesses.
+ */
+uint32_t sim_rand(void);
+
+/**
+ * @brief Uniform random number in [lo, hi].
+ */
+uint32_t sim_rand_range(uint32_t lo, uint32_t hi);
+
+#endif /* SIM_H */
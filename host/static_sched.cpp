@@ -0,0 +1,388 @@
+/**
+ * @file static_sched.cpp
+ * @brief lib/static_scheduler.hpp against lib/scheduler.c on host/sim.c.
+ *
+ * Two fixed task sets are instantiated as StaticScheduler types: the src/scheduler.c set
+ * (10/50/100 ms at offsets 0/1/3 ms, 1 ms tick) and eight tasks with periods from 1 to
+ * 100 ms. Each is registered with lib/scheduler.c (through host/sut_scheduler.c) with
+ * the same parameters.
+ *
+ * - Equivalence: for each seed, both schedulers run the same scenario (random task
+ *   costs, tick jitter) and must call the same tasks at the same ticks in the same order;
+ *   lib/scheduler.c updates its countdowns in the tick ISR here, as the static one does
+ * - Stress: the static scheduler alone with random delays at every intrinsic, checked
+ *   for early/double runs and lost releases as in host/stress.c
+ * - Cost: MSP430X cycles per tick in each scheduler's tick ISR and main loop, charged to
+ *   the simulated CPU with sim_consume(). lib/scheduler.c is ticked as src/scheduler.c
+ *   does it: Scheduler_TickDeferred() in the ISR, the countdowns in tick_work() from the
+ *   main loop (sut_deferred). The per-step figures (cost_t below) are read off
+ *   hand-written instruction listings, not compiler output, so they only show where
+ *   each design spends its cycles. Size and cycles of the real build need the target
+ *   toolchain: make report REPORT_APPS="scheduler static_scheduler"
+ *
+ * Exit status 1 on any mismatch.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+extern "C" {
+#include "sim.h"
+#include "sut.h"
+}
+#include "static_scheduler.hpp"
+
+#define MCLK_HZ         8000000u
+#define CYCLES_PER_MS   (MCLK_HZ / 1000u)
+#define TICK_ISR_CYCLES 40u
+#define MAX_TRACE       200000u
+
+using sched::StaticScheduler;
+using sched::Task;
+
+/* ---------- Task sets ---------- */
+
+template <uint8_t Id>
+static void task(uint32_t now_ms)
+{
+    (void)now_ms;
+    harness_task(Id);
+}
+
+using ExampleSet = StaticScheduler<
+    Task<task<0>, 10, 0, 2>,
+    Task<task<1>, 50, 1, 3>,
+    Task<task<2>, 100, 3, 6>>;
+
+using EightSet = StaticScheduler<
+    Task<task<0>, 1, 0>,
+    Task<task<1>, 2, 1>,
+    Task<task<2>, 5, 0>,
+    Task<task<3>, 7, 3>,
+    Task<task<4>, 10, 2>,
+    Task<task<5>, 20, 5>,
+    Task<task<6>, 25, 7>,
+    Task<task<7>, 100, 11>>;
+
+/* Parameters of a set as run-time arrays, for lib/scheduler.c and the checks */
+template <class S>
+struct SetInfo;
+
+template <class... T>
+struct SetInfo<StaticScheduler<T...>> {
+    static constexpr uint8_t count = sizeof...(T);
+    static constexpr uint16_t period[] = { T::period_ms... };
+    static constexpr uint16_t offset[] = { T::offset_ms... };
+    static constexpr uint16_t slice[] = { T::slice_ms... };
+};
+
+/* ---------- Cycle model ----------
+ * MSP430X cycles of each scheduler's own instructions, zero wait states, using the
+ * tables in tools/cycles.py on listings written for the small model (not compiler
+ * output). Calls both schedulers make (SysTime_Tick(), the empty Defer_Run() sweep,
+ * SysTime_Now(), slice timing, energy stamps) are not charged.
+ */
+typedef struct {
+    uint16_t tick;          // per countdown walk: call, loop set-up and exit, return
+    uint16_t tick_task;     // per task per walk: countdown decrement and branch
+    uint16_t tick_release;  // per release: reload, saturating pending increment
+    uint16_t pass;          // per main-loop pass: set-up of the scan and run loops
+    uint16_t scan_task;     // per task per pass: pending test before sleeping
+    uint16_t run_task;      // per task per pass: pending snapshot with GIE clear
+    uint16_t run;           // per task run: clear pending, call the task
+    uint8_t  deferred;      // walk in the main loop (tick_work()), not in the ISR
+    uint16_t post;          // ISR, tick_work not queued: count the tick, Defer_Post()
+    uint16_t owe;           // ISR, tick_work already queued: count the tick
+    uint16_t drain;         // main loop: Defer_Run() pops and calls tick_work()
+    uint16_t drain_tick;    // main loop: per owed tick in tick_work()
+} cost_t;
+
+/* lib/scheduler.c as src/scheduler.c runs it. Tick ISR, Scheduler_TickDeferred():
+ *   call 4; add #1, &ticks_owed 4; cmp.b #0, &tick_queued 4, jne 2; ret 4
+ *   post: mov #tick_work 2, clr 1, clr.b 1, call #Defer_Post 4, result to tick_queued 7;
+ *   Defer_Post(): argument checks 6, ring address 2, head/tail/depth 10, slot address 8,
+ *   fn and arg stores 8, stamp from SysTime_Counts() 24, publish head 4, posted++ 8,
+ *   max_depth 8, push/pop/ret 10
+ * Main loop, Defer_Run() with tick_work queued: head/tail test 8, slot address 6, copy
+ *   12, tail++ 5, latency from SysTime_Counts() 30, total_latency/run 16, call 5, count
+ *   and p 2, one more sweep of the three rings 36; tick_work(): dint/nop 2, take and
+ *   clear ticks_owed/tick_queued 11, eint 1, ret 4, then per owed tick dec/jne 3 and
+ *   the countdown walk below
+ * Scheduler_Tick() walks tasks[] through a pointer (16-byte task_t):
+ *   call #Scheduler_Tick 4; mov.b &task_count 3, mov #tasks 2, clr 1; exit cmp/jhs 3; ret 4
+ *   per task: add #-1, 12(r12) 4, jne 2; add #16, r12 2, inc.b 1, cmp.b/jlo 3
+ *   release: mov 10(r12), 12(r12) 5; cmp #-1, 14(r12) 3, jeq 2; inc 14(r12) 4
+ * Scheduler_Dispatch(): two loops over tasks[], each mov.b &task_count 3, mov #tasks 2,
+ * exit cmp/jhs 3
+ *   scan: tst 14(r12) 3, jne 2; add #16 2, inc.b 1, cmp.b/jlo 3
+ *   run: dint/nop 2, mov 14(r10), r15 3, tst/jeq 3, eint 1; add #16 2, inc.b 1,
+ *   cmp.b/jlo 3; per run: clr 14(r10) 3, call 0(r10) 5 */
+static const cost_t lib_cost = { 17, 14, 14, 16, 11, 15, 8, 1, 121, 18, 138, 3 };
+
+/* StaticScheduler: one unrolled block per task on absolute addresses, inlined in the ISR
+ *   per task: add #-1, &countdown 4, jne 2
+ *   release: mov #P, &countdown 4; cmp #-1, &pending 3, jeq 2; inc &pending 4
+ *   scan: tst &pending 3, jne 2
+ *   run: dint/nop 2, mov &pending, r15 3, clr &pending 3, eint 1, tst/jeq 3
+ *   per run: call #fn 4 */
+static const cost_t static_cost = { 0, 6, 13, 0, 5, 12, 4, 0, 0, 0, 0, 0 };
+
+/* ---------- Harness ---------- */
+
+typedef struct {
+    uint32_t tick;
+    uint8_t  id;
+} trace_t;
+
+static struct {
+    const uint16_t *period, *offset;
+    uint32_t exec_max[SUT_MAX_TASKS];
+    uint32_t runs[SUT_MAX_TASKS];
+    uint32_t ticks;
+    uint8_t  count;
+    uint8_t  zero_cost;
+    trace_t *trace;
+    uint32_t trace_len;
+    uint32_t early;
+    const cost_t *cost;         // charge modelled cycles, NULL = none
+    uint64_t tick_cycles;       // charged to the tick ISR
+    uint64_t loop_cycles;       // charged to the main loop
+    uint32_t owed_cycles;       // deferred countdown walks not charged yet
+    uint8_t  queued;            // deferred: tick_work posted, not drained yet
+} h;
+
+static void (*tick_isr)(void);
+static uint32_t bad;
+
+static void fail(const char *set, const char *what, uint32_t seed, uint32_t a)
+{
+    if (bad++ < 10)
+        printf("mismatch: %s, %s (seed %lu, %lu)\n", set, what, (unsigned long)seed,
+               (unsigned long)a);
+}
+
+extern "C" void harness_task(uint8_t id)
+{
+    uint32_t rel = (uint32_t)h.offset[id] + (h.runs[id] + 1u) * h.period[id];
+
+    if (h.ticks < rel)
+        h.early++;
+    if (h.trace_len < MAX_TRACE)
+        h.trace[h.trace_len++] = { h.ticks, id };
+    h.runs[id]++;
+    if (h.cost) {
+        sim_consume(h.cost->run);
+        h.loop_cycles += h.cost->run;
+    }
+    if (!h.zero_cost)
+        sim_consume(sim_rand_range(h.exec_max[id] / 2u, h.exec_max[id]));
+}
+
+static void harness_isr(void)
+{
+    h.ticks++;
+    tick_isr();
+    if (h.cost) {
+        uint32_t c = h.cost->tick;
+        uint8_t i;
+
+        for (i = 0; i < h.count; i++) {
+            c += h.cost->tick_task;
+            if (h.ticks > h.offset[i] && (h.ticks - h.offset[i]) % h.period[i] == 0)
+                c += h.cost->tick_release;
+        }
+        if (h.cost->deferred) {
+            /* The walk runs later in tick_work(); the ISR only counts and posts */
+            h.owed_cycles += h.cost->drain_tick + c;
+            c = h.queued ? h.cost->owe : h.cost->post;
+            h.queued = 1;
+        }
+        sim_consume(c);
+        h.tick_cycles += c;
+    }
+}
+
+/* Main-loop cycles of one pass, including a queued tick_work() */
+static void charge_pass(uint8_t count)
+{
+    uint32_t c = h.cost->pass + count * (h.cost->scan_task + h.cost->run_task);
+
+    __disable_interrupt();
+    if (h.queued) {
+        c += h.cost->drain + h.owed_cycles;
+        h.owed_cycles = 0;
+        h.queued = 0;
+    }
+    __enable_interrupt();
+    sim_consume(c);
+    h.loop_cycles += c;
+}
+
+template <class S>
+static void static_tick_isr(void)
+{
+    SysTime_Tick();
+    S::tick();
+    __bic_SR_register_on_exit(LPM0_bits);
+}
+
+/* Task costs: half the CPU split evenly, never more than the slice */
+template <class S>
+static void setup_costs(void)
+{
+    using I = SetInfo<S>;
+    uint8_t i;
+
+    memset(h.runs, 0, sizeof(h.runs));
+    h.ticks = 0;
+    h.period = I::period;
+    h.offset = I::offset;
+    h.count = I::count;
+    for (i = 0; i < I::count; i++) {
+        h.exec_max[i] = I::period[i] * CYCLES_PER_MS / 2u / I::count;
+        if (I::slice[i] && h.exec_max[i] > I::slice[i] * CYCLES_PER_MS)
+            h.exec_max[i] = I::slice[i] * CYCLES_PER_MS;
+    }
+}
+
+/* One scenario on lib (a host/sut_scheduler.c wrapper) or, if NULL, on the static
+ * scheduler; the rest is identical */
+template <class S>
+static void run(const sut_t *lib, uint32_t seed, uint32_t ticks, uint32_t jitter,
+                uint32_t intrinsic_delay, trace_t *trace)
+{
+    using I = SetInfo<S>;
+    uint8_t i;
+
+    setup_costs<S>();
+    h.trace = trace;
+    h.trace_len = 0;
+    h.early = 0;
+    h.owed_cycles = 0;
+    h.queued = 0;
+    sut_scheduler.reset();          // also clears systime_ms and the defer ring
+    S::reset();
+    if (lib)
+        for (i = 0; i < I::count; i++)
+            lib->add_task(i, I::period[i], I::offset[i], I::slice[i]);
+    tick_isr = lib ? lib->tick_isr : static_tick_isr<S>;
+
+    sim_reset(MCLK_HZ, seed);
+    sim_set_jitter(jitter, intrinsic_delay);
+    sim_add_source(harness_isr, CYCLES_PER_MS, CYCLES_PER_MS, TICK_ISR_CYCLES);
+    __enable_interrupt();
+    while (h.ticks < ticks) {
+        if (h.cost)
+            charge_pass(I::count);
+        if (lib)
+            lib->dispatch();
+        else
+            S::dispatch();
+    }
+    __disable_interrupt();
+}
+
+static uint8_t same_trace(const trace_t *a, const trace_t *b, uint32_t len)
+{
+    uint32_t i;
+
+    for (i = 0; i < len; i++)
+        if (a[i].tick != b[i].tick || a[i].id != b[i].id)
+            return 0;
+    return 1;
+}
+
+/* Every release more than 100 ticks old must have run by the end */
+static uint8_t releases_lost(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < h.count; i++) {
+        uint32_t due = h.ticks > h.offset[i] + 100u
+                       ? (h.ticks - h.offset[i] - 100u) / h.period[i] : 0;
+        if (h.runs[i] < due)
+            return 1;
+    }
+    return 0;
+}
+
+template <class S>
+static void check_set(const char *name, uint32_t first, uint32_t scenarios, uint32_t ticks)
+{
+    static trace_t a[MAX_TRACE], b[MAX_TRACE];
+    uint32_t seed, len, runs = 0, n = 100000u;
+    double lib_tick, lib_loop, static_tick, static_loop;
+
+    h.zero_cost = 0;
+    for (seed = first; seed - first < scenarios; seed++) {
+        uint32_t jitter = seed * 2654435761u % (CYCLES_PER_MS / 4u);
+
+        run<S>(&sut_scheduler, seed, ticks, jitter, 0, a);
+        len = h.trace_len;
+        run<S>(NULL, seed, ticks, jitter, 0, b);
+        if (h.trace_len != len || !same_trace(a, b, len))
+            fail(name, "dispatch differs from lib/scheduler.c", seed, len);
+        runs += len;
+
+        run<S>(NULL, seed, ticks, 0, 200, b);
+        if (h.early)
+            fail(name, "early or double run", seed, h.early);
+        if (releases_lost())
+            fail(name, "lost release", seed, h.ticks);
+    }
+
+    /* Cycles per tick with empty tasks, lib ticked as src/scheduler.c does it: each pass
+     * is one tick (one wakeup) */
+    h.zero_cost = 1;
+    h.cost = &lib_cost;
+    h.tick_cycles = h.loop_cycles = 0;
+    run<S>(&sut_deferred, 1, n, 0, 0, a);
+    lib_tick = (double)h.tick_cycles / h.ticks;
+    lib_loop = (double)h.loop_cycles / h.ticks;
+    h.cost = &static_cost;
+    h.tick_cycles = h.loop_cycles = 0;
+    run<S>(NULL, 1, n, 0, 0, a);
+    static_tick = (double)h.tick_cycles / h.ticks;
+    static_loop = (double)h.loop_cycles / h.ticks;
+    h.cost = NULL;
+
+    printf("%-8s %u tasks  %4lu scenarios  %8lu runs compared  utilization %4lu permille\n"
+           "         cycles/tick from listings: tick ISR %5.1f lib, %5.1f static;"
+           "  main loop %5.1f lib, %5.1f static\n",
+           name, SetInfo<S>::count, (unsigned long)scenarios, (unsigned long)runs,
+           (unsigned long)S::utilization_permille, lib_tick, static_tick, lib_loop, static_loop);
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "usage: %s [-n scenarios] [-t ticks] [-S seed]\n"
+            "  -n  scenarios per task set (default 100)\n"
+            "  -t  ticks per scenario (default 2000)\n"
+            "  -S  seed of the first scenario (default 1)\n", prog);
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t scenarios = 100, ticks = 2000, seed = 1;
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-n") && i + 1 < argc)      scenarios = strtoul(argv[++i], NULL, 0);
+        else if (!strcmp(argv[i], "-t") && i + 1 < argc) ticks = strtoul(argv[++i], NULL, 0);
+        else if (!strcmp(argv[i], "-S") && i + 1 < argc) seed = strtoul(argv[++i], NULL, 0);
+        else { usage(argv[0]); return 2; }
+    }
+    if (!ticks || ticks > MAX_TRACE / 8u) { usage(argv[0]); return 2; }
+
+    check_set<ExampleSet>("example", seed, scenarios, ticks);
+    check_set<EightSet>("eight", seed, scenarios, ticks);
+
+    if (bad) {
+        printf("%lu mismatches\n", (unsigned long)bad);
+        return 1;
+    }
+    printf("static scheduler runs every task at the same ticks as lib/scheduler.c\n");
+    return 0;
+}
@@ -0,0 +1,554 @@
+/**
+ * @file stress.c
+ * @brief Property-based stress test of the schedulers on the host simulator.
+ *
+ * Each scenario draws a random task set (periods, offsets, execution times up to
+ * a utilization cap) and random timing (tick jitter, ISR cost, delays injected at
+ * every intrinsic), runs one scheduler on host/sim.c and checks:
+ * - no early or double run: the n-th run of a task starts at or after its n-th release
+ * - bounded lateness: no run starts more than max_late ticks after its release
+ * - no lost release: every release older than max_late ticks has run by the end
+ * - no lost wakeup: the main loop never enters LPM while a released task is waiting
+ * - with -b, no background chunk (lib/background.c) is still running when a release
+ *   tick arrives
+ *
+ * A cyclic executive (sut->frames: "frames") legitimately holds a job until the frame it
+ * was packed into, so its runs are checked against the task's own window instead: run n
+ * starts at or after n * T and ends before (n + 1) * T, and no deadline passes unrun.
+ * Its random task sets keep every job under a quarter of the shortest period, so that
+ * most of them have a valid frame size.
+ *
+ * max_late is 2 * sum(ceil(C_i)) + 2 ticks: a cooperative pass can be blocked by
+ * at most the remainder of one pass plus one full pass.
+ *
+ * "-e C:T" adds an event storm (an interrupt every STORM_CYCLES whose handler takes
+ * STORM_HANDLER_CYCLES, far more than the CPU has left) served by a sporadic server
+ * (lib/server.c) with capacity C us per T ms. max_late grows by the server capacity that
+ * fits in the window, L = base + ceil(L / T) * ceil((C + handler) / 1 ms). "-e 0:0"
+ * posts the handlers as plain deferred work instead, to show the unbounded case.
+ *
+ * The tick source starts after start() with the tick the scheduler chose (SysTime_TickMs(),
+ * Scheduler_Start() or build_schedule()); h.ticks counts ms. Half of the random task sets
+ * put their offsets on the GCD of the periods, so coarse ticks are exercised.
+ *
+ * A failing scenario is reported with its seed; "-r seed" replays it with a trace.
+ *
+ * "-w" runs the src/phase_offset.c task set instead (10/50/100 ms busy for 2/10/50 ms)
+ * and prints the worst lateness per task for array-order dispatch, priority dispatch,
+ * and priority dispatch with tasks yielding every millisecond.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <msp430.h>
+#include "sim.h"
+#include "sut.h"
+#include "systime.h"
+#include "background.h"
+#include "server.h"
+
+#define MCLK_HZ         1000000u
+#define CYCLES_PER_MS   (MCLK_HZ / 1000u)
+
+#define STORM_CYCLES            400u    // event interrupt period
+#define STORM_ISR_CYCLES        20u
+#define STORM_HANDLER_CYCLES    300u
+
+enum {
+    V_EARLY,
+    V_LATE,
+    V_LOST,
+    V_SLEEP,
+    V_BG,
+    V_DEADLINE,
+    V_KINDS
+};
+
+static const char *const v_names[V_KINDS] = {
+    "early/double run", "late run", "lost release", "lost wakeup", "background over release",
+    "deadline miss"
+};
+
+typedef struct {
+    uint16_t period_ms;
+    uint16_t offset_ms;
+    uint16_t slice_ms;
+    uint32_t exec_max;          // cycles
+} htask_t;
+
+static struct {
+    const sut_t *sut;
+    htask_t  t[SUT_MAX_TASKS];
+    uint8_t  n;
+    uint32_t runs[SUT_MAX_TASKS];
+    uint32_t ticks;
+    uint32_t max_late;
+    uint32_t worst_late;
+    uint32_t worst_task[SUT_MAX_TASKS];
+    uint32_t violations[V_KINDS];
+    char     first[160];
+    int      trace;
+    int      yield;             // tasks call sut->yield() every CYCLES_PER_MS
+    int      rejected;          // start() or add_server() refused the task set
+    uint16_t bg_us;             // background chunk length, 0 = no background job
+    uint32_t bg_chunks;
+    int      storm;             // event storm on, served by srv or by Defer_Post() if no srv
+    server_t srv;
+    uint16_t srv_us, srv_ms;
+} h;
+
+static const uint16_t periods[] = { 2, 4, 5, 8, 10, 20, 25, 40, 50, 100, 200 };
+
+/* src/phase_offset.c: Task_Fast, Task_Medium, Task_Slow */
+static const htask_t phase_example[] = {
+    {  10,  0,  1,  2u * CYCLES_PER_MS },
+    {  50,  2,  5, 10u * CYCLES_PER_MS },
+    { 100, 10, 20, 50u * CYCLES_PER_MS },
+};
+
+/* ---------- Checks ---------- */
+
+static void violation(int kind, uint8_t id, uint32_t release)
+{
+    if (!h.violations[0] && !h.violations[1] && !h.violations[2] && !h.violations[3] &&
+        !h.violations[4] && !h.violations[5])
+        snprintf(h.first, sizeof(h.first), "%s: T%u release %lu, tick %lu",
+                 v_names[kind], id, (unsigned long)release, (unsigned long)h.ticks);
+    h.violations[kind]++;
+    if (h.trace)
+        printf("%8lu  !! %s T%u (release %lu)\n", (unsigned long)h.ticks,
+               v_names[kind], id, (unsigned long)release);
+}
+
+void harness_task(uint8_t id)
+{
+    uint32_t rel = h.sut->release_ms(id, h.runs[id]);
+    uint32_t due = h.sut->release_ms(id, h.runs[id] + 1u);
+    uint32_t exec = sim_rand_range(h.t[id].exec_max / 2u, h.t[id].exec_max);
+
+    if (h.ticks < rel) {
+        violation(V_EARLY, id, rel);
+    } else {
+        uint32_t late = h.ticks - rel;
+        if (late > h.worst_late)
+            h.worst_late = late;
+        if (late > h.worst_task[id])
+            h.worst_task[id] = late;
+        if (late > h.max_late && !h.sut->frames)
+            violation(V_LATE, id, rel);
+    }
+    if (h.trace)
+        printf("%8lu  run T%u #%lu (release %lu, %lu cycles)\n", (unsigned long)h.ticks, id,
+               (unsigned long)h.runs[id], (unsigned long)rel, (unsigned long)exec);
+    h.runs[id]++;
+    if (h.yield && h.sut->yield) {
+        while (exec > CYCLES_PER_MS) {
+            sim_consume(CYCLES_PER_MS);
+            exec -= CYCLES_PER_MS;
+            h.sut->yield();
+        }
+    }
+    sim_consume(exec);
+    if (h.sut->frames && h.ticks >= due)
+        violation(V_DEADLINE, id, rel);
+}
+
+/* Endless background work: one chunk of exactly bg_us, must end before the next release */
+static uint8_t bg_chunk(void)
+{
+    uint32_t next = UINT32_MAX;
+    uint8_t i, first = 0;
+
+    for (i = 0; i < h.n; i++) {
+        uint32_t rel = h.sut->release_ms(i, h.runs[i]);
+        if (rel < next) {
+            next = rel;
+            first = i;
+        }
+    }
+    if (h.trace)
+        printf("%8lu  background chunk (next release %lu)\n", (unsigned long)h.ticks,
+               (unsigned long)next);
+    sim_consume(h.bg_us * (CYCLES_PER_MS / 1000u));
+    h.bg_chunks++;
+    if (h.ticks >= next)
+        violation(V_BG, first, next);
+    return 1;
+}
+
+static void storm_handler(uintptr_t arg)
+{
+    (void)arg;
+    sim_consume(STORM_HANDLER_CYCLES);
+}
+
+static void storm_isr(void)
+{
+    if (h.srv_ms)
+        Server_Post(&h.srv, storm_handler, 0);
+    else
+        Defer_Post(DEFER_PRIO_NORMAL, storm_handler, 0);
+    __bic_SR_register_on_exit(LPM0_bits);
+}
+
+/* Server interference added to a blocking bound of base ticks */
+static uint32_t with_server(uint32_t base)
+{
+    uint32_t c = (h.srv_us + STORM_HANDLER_CYCLES * (1000000u / MCLK_HZ) + 999u) / 1000u;
+    uint32_t late = base, prev = 0;
+
+    while (h.srv_ms && late != prev && late < 100000u) {
+        prev = late;
+        late = base + (prev + h.srv_ms - 1u) / h.srv_ms * c;
+    }
+    return late;
+}
+
+static void on_sleep(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < h.n && !h.sut->frames; i++) {     // frames: jobs wait for their frame
+        uint32_t rel = h.sut->release_ms(i, h.runs[i]);
+        if (rel <= h.ticks)
+            violation(V_SLEEP, i, rel);
+    }
+    if (h.trace > 1)
+        printf("%8lu  sleep\n", (unsigned long)h.ticks);
+}
+
+static void tick(void)
+{
+    h.ticks += SysTime_TickMs();
+    h.sut->tick_isr();
+}
+
+/* ---------- Scenario ---------- */
+
+static uint32_t hyperperiod(void)
+{
+    uint32_t hp = 1;
+    uint8_t i;
+
+    for (i = 0; i < h.n; i++) {
+        uint32_t a = hp, b = h.t[i].period_ms;
+        while (b) { uint32_t t = b; b = a % b; a = t; }
+        hp = hp / a * h.t[i].period_ms;
+    }
+    return hp;
+}
+
+static uint32_t slot_count(void)
+{
+    uint32_t hp = hyperperiod(), slots = 0;
+    uint8_t i;
+
+    for (i = 0; i < h.n; i++)
+        slots += hp / h.t[i].period_ms;
+    return slots;
+}
+
+static void make_taskset(uint32_t util_pct)
+{
+    uint32_t share[SUT_MAX_TASKS], total = 0, late = 0;
+    uint8_t max = h.sut->max_tasks < SUT_MAX_TASKS ? h.sut->max_tasks : SUT_MAX_TASKS;
+    uint16_t grid = 0, min_period = 0xFFFFu;
+    uint8_t i;
+
+    h.n = (uint8_t)sim_rand_range(1, max);
+    for (i = 0; i < h.n; i++) {
+        uint16_t a = grid, b = h.t[i].period_ms =
+            periods[sim_rand_range(0, sizeof(periods) / sizeof(periods[0]) - 1)];
+        while (b) { uint16_t t = b; b = a % b; a = t; }
+        grid = a;
+        h.t[i].offset_ms = (uint16_t)sim_rand_range(0, h.t[i].period_ms - 1u);
+        share[i] = sim_rand_range(1, 100);
+        total += share[i];
+    }
+    if (sim_rand() & 1u)
+        for (i = 0; i < h.n; i++)
+            h.t[i].offset_ms -= h.t[i].offset_ms % grid;    // coarse tick: GCD of periods
+    while (h.sut->max_slots && h.n > 1 && slot_count() > h.sut->max_slots)
+        total -= share[--h.n];
+    for (i = 0; i < h.n; i++)
+        if (h.t[i].period_ms < min_period)
+            min_period = h.t[i].period_ms;
+
+    for (i = 0; i < h.n; i++) {
+        /* u_i = util * share_i / total, C_i = u_i * T_i */
+        uint32_t c = (uint32_t)((uint64_t)util_pct * share[i] * h.t[i].period_ms * CYCLES_PER_MS
+                                / (100u * total));
+        if (h.sut->frames && c > min_period * CYCLES_PER_MS / 4u)
+            c = min_period * CYCLES_PER_MS / 4u;    // short jobs: a frame size exists
+        h.t[i].exec_max = c < 20u ? 20u : c;
+        h.t[i].slice_ms = (uint16_t)((h.t[i].exec_max + CYCLES_PER_MS - 1u) / CYCLES_PER_MS);
+        late += h.t[i].slice_ms;
+    }
+    h.max_late = 2u * late + 2u;
+}
+
+static void fixed_taskset(const htask_t *t, uint8_t n)
+{
+    uint32_t late = 0;
+    uint8_t i;
+
+    h.n = n;
+    for (i = 0; i < n; i++) {
+        h.t[i] = t[i];
+        late += t[i].slice_ms > t[i].exec_max / CYCLES_PER_MS ?
+                t[i].slice_ms : (t[i].exec_max + CYCLES_PER_MS - 1u) / CYCLES_PER_MS;
+    }
+    h.max_late = 2u * late + 2u;
+}
+
+/* Run one scenario, return non-zero if any property failed. A NULL fixed set draws a
+ * random one. */
+static int run_scenario(const sut_t *sut, uint32_t seed, uint32_t util_pct, int trace,
+                        const htask_t *fixed, uint8_t fixed_n, int yield, uint16_t bg_us,
+                        int storm, uint16_t srv_us, uint16_t srv_ms)
+{
+    uint32_t end, tick_cycles, tick_isr_cycles;
+    uint8_t i;
+    int r;
+
+    memset(&h, 0, sizeof(h));
+    h.sut = sut;
+    h.trace = trace;
+    h.yield = yield;
+    h.bg_us = bg_us;
+    h.storm = storm;
+    h.srv_us = srv_us;
+    h.srv_ms = srv_ms;
+
+    sim_reset(MCLK_HZ, seed);
+    if (fixed)
+        fixed_taskset(fixed, fixed_n);
+    else
+        make_taskset(util_pct);
+    sim_set_jitter(sim_rand_range(0, CYCLES_PER_MS / 10u), sim_rand_range(0, 20));
+    sim_set_sleep_hook(on_sleep);
+    tick_isr_cycles = sim_rand_range(20, 80);
+
+    sut->reset();
+    Background_Init();
+    if (bg_us)
+        Background_Wake((uint8_t)Background_Add(bg_chunk, bg_us));
+    for (i = 0; i < h.n; i++) {
+        if (sut->add_task(i, h.t[i].period_ms, h.t[i].offset_ms, h.t[i].slice_ms) != 0) {
+            fprintf(stderr, "%s: add_task rejected T%u\n", sut->name, i);
+            return 1;
+        }
+    }
+    if (storm && srv_ms) {
+        Server_Init(&h.srv, srv_us, srv_ms);
+        if (!sut->add_server || sut->add_server(&h.srv) != 0) {
+            h.rejected = 1;     // over 100 % with the server
+            return 0;
+        }
+        h.max_late = with_server(h.max_late);
+    }
+    r = sut->start();
+    if (r > 0) {
+        h.rejected = 1;         // not schedulable by this scheduler: nothing to check
+        return 0;
+    }
+    if (r != 0)
+        return 1;
+    /* tick first: it keeps priority over the storm */
+    tick_cycles = SysTime_TickMs() * CYCLES_PER_MS;
+    sim_add_source(tick, tick_cycles, tick_cycles, tick_isr_cycles);
+    if (storm)
+        sim_add_source(storm_isr, STORM_CYCLES, STORM_CYCLES, STORM_ISR_CYCLES);
+
+    if (trace) {
+        printf("scenario 0x%08lx on %s: max_late %lu ticks\n", (unsigned long)seed,
+               sut->name, (unsigned long)h.max_late);
+        for (i = 0; i < h.n; i++)
+            printf("  T%u period %u offset %u slice %u exec <= %lu cycles\n", i,
+                   h.t[i].period_ms, h.t[i].offset_ms, h.t[i].slice_ms,
+                   (unsigned long)h.t[i].exec_max);
+    }
+
+    end = 3u * hyperperiod() + h.max_late + 1u;
+    __enable_interrupt();
+    while (h.ticks < end)
+        sut->dispatch();
+    __disable_interrupt();
+
+    for (i = 0; i < h.n; i++) {
+        uint32_t rel = sut->release_ms(i, h.runs[i]);
+        if (sut->frames ? sut->release_ms(i, h.runs[i] + 1u) <= h.ticks :
+                          rel + h.max_late < h.ticks)
+            violation(V_LOST, i, rel);
+    }
+    return h.violations[V_EARLY] || h.violations[V_LATE] || h.violations[V_LOST] ||
+           h.violations[V_SLEEP] || h.violations[V_BG] || h.violations[V_DEADLINE];
+}
+
+/* ---------- Main ---------- */
+
+static const sut_t *const suts[] = {
+    &sut_scheduler, &sut_deferred, &sut_phase_offset, &sut_phase_array, &sut_generator,
+    &sut_frames
+};
+
+/* Worst lateness per task of the phase_offset example, before and after priorities */
+static int lateness_report(uint32_t count, uint32_t base)
+{
+    static const struct { const char *name; const sut_t *sut; int yield; } cfg[] = {
+        { "array order",      &sut_phase_array,  0 },
+        { "priority",         &sut_phase_offset, 0 },
+        { "priority + yield", &sut_phase_offset, 1 },
+    };
+    const uint8_t n = sizeof(phase_example) / sizeof(phase_example[0]);
+    int failed = 0;
+    size_t c;
+    uint8_t i;
+
+    printf("worst lateness in ticks over %lu scenarios\n%-18s", (unsigned long)count, "dispatch");
+    for (i = 0; i < n; i++)
+        printf("  T%u %3ums", i, phase_example[i].period_ms);
+    printf("\n");
+
+    for (c = 0; c < sizeof(cfg) / sizeof(cfg[0]); c++) {
+        uint32_t worst[SUT_MAX_TASKS] = { 0 }, k;
+
+        for (k = 0; k < count; k++) {
+            failed |= run_scenario(cfg[c].sut, base * 2654435761u + k, 0, 0,
+                                   phase_example, n, cfg[c].yield, 0, 0, 0, 0);
+            for (i = 0; i < n; i++)
+                if (h.worst_task[i] > worst[i])
+                    worst[i] = h.worst_task[i];
+        }
+        printf("%-18s", cfg[c].name);
+        for (i = 0; i < n; i++)
+            printf("  %8lu", (unsigned long)worst[i]);
+        printf("\n");
+    }
+    return failed;
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "usage: %s [-s sut] [-n scenarios] [-S seed] [-u util%%] [-y] [-b us] [-e us:ms]\n"
+            "          [-r seed [-v]] [-w]\n"
+            "  -s  scheduler, deferred, generator, frames, phase_offset or phase_array\n"
+            "      (default: all)\n"
+            "  -n  scenarios per scheduler (default 10000)\n"
+            "  -S  base seed (default: time)\n"
+            "  -u  utilization cap in percent (default 50)\n"
+            "  -b  endless background job in chunks of us microseconds (lib/background.c)\n"
+            "  -e  event storm served by a sporadic server of us per ms (lib/server.c),\n"
+            "      0:0 = plain deferred work (scheduler and deferred only)\n"
+            "  -y  tasks call the scheduler's yield point every ms (phase_offset)\n"
+            "  -r  replay one scenario seed with a trace, -v also traces sleeps\n"
+            "  -w  worst lateness per task of the phase_offset example, per dispatch order\n",
+            prog);
+}
+
+int main(int argc, char **argv)
+{
+    const char *only = NULL;
+    uint32_t count = 10000, base = (uint32_t)time(NULL), util = 50, replay = 0;
+    uint16_t bg_us = 0, srv_us = 0, srv_ms = 0;
+    int storm = 0;
+    int do_replay = 0, verbose = 0, yield = 0, report = 0, failed = 0;
+    size_t k;
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-s") && i + 1 < argc)      only = argv[++i];
+        else if (!strcmp(argv[i], "-n") && i + 1 < argc) count = strtoul(argv[++i], NULL, 0);
+        else if (!strcmp(argv[i], "-S") && i + 1 < argc) base = strtoul(argv[++i], NULL, 0);
+        else if (!strcmp(argv[i], "-u") && i + 1 < argc) util = strtoul(argv[++i], NULL, 0);
+        else if (!strcmp(argv[i], "-r") && i + 1 < argc) { replay = strtoul(argv[++i], NULL, 0); do_replay = 1; }
+        else if (!strcmp(argv[i], "-v"))                 verbose = 1;
+        else if (!strcmp(argv[i], "-y"))                 yield = 1;
+        else if (!strcmp(argv[i], "-b") && i + 1 < argc) bg_us = (uint16_t)strtoul(argv[++i], NULL, 0);
+        else if (!strcmp(argv[i], "-e") && i + 1 < argc) {
+            char *colon;
+            srv_us = (uint16_t)strtoul(argv[++i], &colon, 0);
+            if (*colon != ':') { usage(argv[0]); return 2; }
+            srv_ms = (uint16_t)strtoul(colon + 1, NULL, 0);
+            storm = 1;
+        }
+        else if (!strcmp(argv[i], "-w"))                 report = 1;
+        else { usage(argv[0]); return 2; }
+    }
+    if (report)
+        return lateness_report(count, base);
+
+    for (k = 0; k < sizeof(suts) / sizeof(suts[0]); k++) {
+        const sut_t *sut = suts[k];
+        uint32_t fails = 0, first_seed = 0, worst = 0, rejected = 0, n;
+        uint64_t bg_cycles = 0, cycles = 0, srv_run = 0, srv_exhausted = 0, srv_dropped = 0;
+        uint32_t kinds[V_KINDS] = { 0 };
+        char first[160] = "";
+        clock_t t0;
+        double secs;
+
+        if (only && strcmp(only, sut->name))
+            continue;
+        if (storm && !sut->add_server)
+            continue;
+
+        if (do_replay) {
+            failed |= run_scenario(sut, replay, util, 1 + verbose, NULL, 0, yield, bg_us,
+                                   storm, srv_us, srv_ms);
+            printf("%s\n", failed ? h.first :
+                   h.rejected ? "task set rejected as not schedulable" : "all properties hold");
+            continue;
+        }
+
+        t0 = clock();
+        for (n = 0; n < count; n++) {
+            uint32_t seed = base * 2654435761u + n;
+            int v;
+            if (run_scenario(sut, seed, util, 0, NULL, 0, yield, bg_us, storm, srv_us, srv_ms)) {
+                if (!fails++) {
+                    first_seed = seed;
+                    memcpy(first, h.first, sizeof(first));
+                }
+                for (v = 0; v < V_KINDS; v++)
+                    kinds[v] += h.violations[v] != 0;
+            }
+            if (h.worst_late > worst)
+                worst = h.worst_late;
+            rejected += h.rejected;
+            bg_cycles += (uint64_t)h.bg_chunks * h.bg_us * (CYCLES_PER_MS / 1000u);
+            cycles += sim_now();
+            if (storm && srv_ms && !h.rejected) {
+                srv_run += Server_GetStats(&h.srv)->run;
+                srv_exhausted += Server_GetStats(&h.srv)->exhausted;
+                srv_dropped += Server_GetStats(&h.srv)->dropped;
+            }
+        }
+        secs = (double)(clock() - t0) / CLOCKS_PER_SEC;
+
+        printf("%-13s %8lu scenarios %8lu failing  worst lateness %4lu ticks  %.1f s (%.0f/min)\n",
+               sut->name, (unsigned long)count, (unsigned long)fails, (unsigned long)worst,
+               secs, secs > 0 ? count * 60.0 / secs : 0.0);
+        if (bg_us)
+            printf("    background %.1f%% of time\n", cycles ? 100.0 * bg_cycles / cycles : 0.0);
+        if (storm && srv_ms)
+            printf("    server %u us / %u ms: %llu handlers run, budget exhausted %llu times, "
+                   "%llu events dropped\n", srv_us, srv_ms, (unsigned long long)srv_run,
+                   (unsigned long long)srv_exhausted, (unsigned long long)srv_dropped);
+        if (rejected)
+            printf("    %lu task sets rejected as not schedulable (start() or add_server())\n",
+                   (unsigned long)rejected);
+        if (fails) {
+            int v;
+            for (v = 0; v < V_KINDS; v++)
+                if (kinds[v])
+                    printf("    %-18s in %lu scenarios\n", v_names[v], (unsigned long)kinds[v]);
+            printf("    first: seed 0x%08lx, %s\n", (unsigned long)first_seed, first);
+            printf("    replay: stress -s %s -r 0x%08lx\n", sut->name, (unsigned long)first_seed);
+            failed = 1;
+        }
+    }
+    return failed;
+}
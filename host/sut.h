@@ -0,0 +1,59 @@
+/**
+ * @file sut.h
+ * @brief Uniform view of a firmware scheduler for the host harnesses.
+ *
+ * Each sut_*.c wrapper #includes one scheduler source (renaming its global
+ * symbols) and exposes it through sut_t. Harness tasks are identified by an
+ * index; the wrappers provide trampolines with the signature each scheduler
+ * expects, all of which call harness_task(id).
+ */
+
+#ifndef SUT_H
+#define SUT_H
+
+#include <stdint.h>
+
+#define SUT_MAX_TASKS 8
+
+struct server;
+
+typedef struct {
+    const char *name;
+    uint8_t  max_tasks;
+    uint16_t max_slots;        /**< Table size limit, 0 if the scheduler has no table */
+    void     (*reset)(void);
+    int      (*add_task)(uint8_t id, uint16_t period_ms, uint16_t offset_ms, uint16_t slice_ms);
+    int      (*start)(void);   /**< Finalize the task set (build tables): 0 on success,
+                                    >0 if the set is not schedulable (skipped) */
+    void     (*tick_isr)(void);
+    void     (*dispatch)(void);/**< One main-loop pass, may sleep in LPM */
+    uint32_t (*release_ms)(uint8_t id, uint32_t n); /**< Tick of the n-th release (n >= 0) */
+    void     (*yield)(void);   /**< Preemption point for running tasks, NULL if none */
+    int      (*add_server)(struct server *s); /**< Register a sporadic server (after
+                                    add_task), 0 on success; NULL if unsupported */
+    uint8_t  frames;           /**< Cyclic executive: a job may wait for its frame, so
+                                    run n is checked against its deadline release_ms(n + 1)
+                                    instead of max_late */
+} sut_t;
+
+/* Implemented by the harness */
+void harness_task(uint8_t id);
+
+#define SUT_TRAMPOLINES(prefix, ret, params, arg)                           \
+    static ret prefix##0 params { (void)(arg); harness_task(0); }           \
+    static ret prefix##1 params { (void)(arg); harness_task(1); }           \
+    static ret prefix##2 params { (void)(arg); harness_task(2); }           \
+    static ret prefix##3 params { (void)(arg); harness_task(3); }           \
+    static ret prefix##4 params { (void)(arg); harness_task(4); }           \
+    static ret prefix##5 params { (void)(arg); harness_task(5); }           \
+    static ret prefix##6 params { (void)(arg); harness_task(6); }           \
+    static ret prefix##7 params { (void)(arg); harness_task(7); }
+
+extern const sut_t sut_scheduler;
+extern const sut_t sut_deferred;
+extern const sut_t sut_phase_offset;
+extern const sut_t sut_phase_array;
+extern const sut_t sut_generator;
+extern const sut_t sut_frames;
+
+#endif /* SUT_H */
@@ -0,0 +1,9 @@
+/**
+ * @file sut_frames.c
+ * @brief src/scheduler_generator.c built as a cyclic executive (SCHED_BACKEND_FRAMES).
+ */
+
+#define SCHED_BACKEND           1u      // SCHED_BACKEND_FRAMES
+#define SUT_GEN(sym)            sym##_frames
+#define SUT_GEN_NAME            "frames"
+#include "sut_generator.c"
@@ -0,0 +1,107 @@
+/**
+ * @file sut_generator.c
+ * @brief Host wrapper for the table-driven executor in src/scheduler_generator.c.
+ *
+ * sut_frames.c includes this file again with SCHED_BACKEND = SCHED_BACKEND_FRAMES.
+ */
+
+#ifndef SUT_GEN
+#define SUT_GEN(sym)            sym##_generator
+#define SUT_GEN_NAME            "generator"
+#endif
+
+#define main                    SUT_GEN(main)
+#define task_1                  SUT_GEN(task_1)
+#define task_2                  SUT_GEN(task_2)
+#define task_3                  SUT_GEN(task_3)
+#define add_task                SUT_GEN(add_task)
+#define compute_hyperperiod     SUT_GEN(compute_hyperperiod)
+#define count_slots             SUT_GEN(count_slots)
+#define compute_offsets         SUT_GEN(compute_offsets)
+#define build_schedule          SUT_GEN(build_schedule)
+#define timer_0_a0_isr          SUT_GEN(timer_0_a0_isr)
+#define gpio_init               SUT_GEN(gpio_init)
+#define run_scheduler           SUT_GEN(run_scheduler)
+#define scheduler_step          SUT_GEN(scheduler_step)
+#include "../src/scheduler_generator.c"
+#include <stddef.h>
+#include "sut.h"
+
+SUT_TRAMPOLINES(tramp_, void, (void), 0)
+
+static const task_fn_t tramps[SUT_MAX_TASKS] = {
+    tramp_0, tramp_1, tramp_2, tramp_3, tramp_4, tramp_5, tramp_6, tramp_7
+};
+
+static void sut_reset(void)
+{
+    num_tasks = 0;
+#if SCHED_BACKEND == SCHED_BACKEND_SLOTS
+    num_slots = 0;
+    slot_idx = 0;
+#else
+    num_frames = 0;
+    frames_owed = 0;
+#endif
+    hyperperiod_ms = 0;
+    systime_ms = 0;
+    SysTime_SetTickMs(TICK_MS);
+}
+
+/* Offsets are computed by the generator, offset_ms is ignored */
+static int sut_add_task(uint8_t id, uint16_t period_ms, uint16_t offset_ms, uint16_t slice_ms)
+{
+    (void)offset_ms;
+    if (num_tasks >= MAX_TASKS)
+        return -1;
+    add_task("T", tramps[id], period_ms, slice_ms);
+    return 0;
+}
+
+static const task_def_t *find(uint8_t id)
+{
+    uint8_t i;
+
+    for (i = 0; i < num_tasks; i++)
+        if (tasks[i].func == tramps[id])
+            return &tasks[i];
+    return NULL;
+}
+
+#if SCHED_BACKEND == SCHED_BACKEND_SLOTS
+
+static int sut_start(void)
+{
+    compute_offsets();
+    return build_schedule();
+}
+
+static uint32_t sut_release_ms(uint8_t id, uint32_t n)
+{
+    const task_def_t *t = find(id);
+    return (uint32_t)t->offset_ms + n * t->period_ms;
+}
+
+#else
+
+/* A task set without a valid frame size is rejected, not failed */
+static int sut_start(void)
+{
+    int r = build_schedule();
+    return r == SCHED_ERR_FRAMES ? 1 : r;
+}
+
+/* Offsets are forced to 0: job n is released at n * T and is due at (n + 1) * T. The
+ * frame it was packed into is the executive's business; stress.c checks the window. */
+static uint32_t sut_release_ms(uint8_t id, uint32_t n)
+{
+    return n * find(id)->period_ms;
+}
+
+#endif
+
+const sut_t SUT_GEN(sut) = {
+    SUT_GEN_NAME, MAX_TASKS, MAX_SLOTS,
+    sut_reset, sut_add_task, sut_start, timer_0_a0_isr, scheduler_step, sut_release_ms,
+    NULL, NULL, SCHED_BACKEND == SCHED_BACKEND_FRAMES
+};
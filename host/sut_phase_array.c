@@ -0,0 +1,9 @@
+/**
+ * @file sut_phase_array.c
+ * @brief src/phase_offset.c built with the original array-order dispatch, for comparison.
+ */
+
+#define DISPATCH_POLICY     0u      // DISPATCH_ARRAY
+#define SUT_PO(sym)         sym##_phase_array
+#define SUT_PO_NAME         "phase_array"
+#include "sut_phase_offset.c"
@@ -0,0 +1,60 @@
+/**
+ * @file sut_phase_offset.c
+ * @brief Host wrapper for the phase-offset scheduler in src/phase_offset.c.
+ *
+ * Priorities are rate-monotonic (the period, capped at 254) with the threshold equal
+ * to the priority, so at a yield point any task with a shorter period may run.
+ * sut_phase_array.c includes this file again with DISPATCH_POLICY = DISPATCH_ARRAY.
+ */
+
+#ifndef SUT_PO
+#define SUT_PO(sym)         sym##_phase_offset
+#define SUT_PO_NAME         "phase_offset"
+#endif
+
+#define main                SUT_PO(main)
+#define Gpio_Init           SUT_PO(Gpio_Init)
+#define Scheduler_AddTask   SUT_PO(Scheduler_AddTask)
+#define Scheduler_Dispatch  SUT_PO(Scheduler_Dispatch)
+#define Scheduler_Yield     SUT_PO(Scheduler_Yield)
+#define Timer0_A0_ISR       SUT_PO(Timer0_A0_ISR)
+#include "../src/phase_offset.c"
+#include "sut.h"
+
+SUT_TRAMPOLINES(tramp_, void, (uint32_t now_ms), now_ms)
+
+static const task_fn_t tramps[SUT_MAX_TASKS] = {
+    tramp_0, tramp_1, tramp_2, tramp_3, tramp_4, tramp_5, tramp_6, tramp_7
+};
+
+static void sut_reset(void)
+{
+    task_count = 0;
+    running_threshold = PRIO_IDLE;
+    systime_ms = 0;
+    SysTime_SetTickMs(TICK_MS);
+}
+
+static int sut_add_task(uint8_t id, uint16_t period_ms, uint16_t offset_ms, uint16_t slice_ms)
+{
+    uint8_t prio = period_ms < PRIO_IDLE ? (uint8_t)period_ms : PRIO_IDLE - 1u;
+
+    return Scheduler_AddTask(tramps[id], period_ms, slice_ms, offset_ms, prio, prio);
+}
+
+static int sut_start(void)
+{
+    return 0;
+}
+
+/* First release at the offset */
+static uint32_t sut_release_ms(uint8_t id, uint32_t n)
+{
+    return (uint32_t)tasks[id].phase_offset_ms + n * tasks[id].period_ms;
+}
+
+const sut_t SUT_PO(sut) = {
+    SUT_PO_NAME, MAX_TASKS, 0,
+    sut_reset, sut_add_task, sut_start, Timer0_A0_ISR, Scheduler_Dispatch, sut_release_ms,
+    Scheduler_Yield
+};
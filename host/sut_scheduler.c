@@ -0,0 +1,76 @@
+/**
+ * @file sut_scheduler.c
+ * @brief Host wrapper for the pending-counter scheduler in lib/scheduler.c.
+ *
+ * "scheduler" updates the countdowns in the tick ISR, "deferred" posts them as
+ * deferred work (Scheduler_TickDeferred(), lib/defer.c) run by Scheduler_Dispatch().
+ * lib/server.c is built in here, with the simulator as consumption clock.
+ */
+
+#include "sim.h"
+
+#define SERVER_CLOCK() ((uint32_t)(sim_now() >> 3))     // TA0 counts at SMCLK/8
+#define SCHEDULER_CLOCK() SERVER_CLOCK()
+#include "../lib/server.c"
+#include "../lib/scheduler.c"
+#include "sut.h"
+
+SUT_TRAMPOLINES(tramp_, void, (uint32_t now_ms), now_ms)
+
+static const task_fn_t tramps[SUT_MAX_TASKS] = {
+    tramp_0, tramp_1, tramp_2, tramp_3, tramp_4, tramp_5, tramp_6, tramp_7
+};
+
+static void sut_reset(void)
+{
+    task_count = 0;
+    systime_ms = 0;
+    SysTime_SetTickMs(TICK_MS);
+    ticks_owed = 0;
+    tick_queued = 0;
+    server_count = 0;
+    Defer_Init();
+}
+
+static int sut_add_task(uint8_t id, uint16_t period_ms, uint16_t offset_ms, uint16_t slice_ms)
+{
+    return Scheduler_AddTask(tramps[id], period_ms, offset_ms, slice_ms);
+}
+
+static int sut_start(void)
+{
+    Scheduler_Start();
+    return 0;
+}
+
+static void sut_tick_isr(void)
+{
+    SysTime_Tick();
+    Scheduler_Tick();
+    __bic_SR_register_on_exit(LPM0_bits);
+}
+
+static void sut_tick_isr_deferred(void)
+{
+    SysTime_Tick();
+    Scheduler_TickDeferred();
+    __bic_SR_register_on_exit(LPM0_bits);
+}
+
+/* First release one period after the offset */
+static uint32_t sut_release_ms(uint8_t id, uint32_t n)
+{
+    return (uint32_t)tasks[id].offset_ms + (n + 1u) * tasks[id].period_ms;
+}
+
+const sut_t sut_scheduler = {
+    "scheduler", MAX_TASKS, 0,
+    sut_reset, sut_add_task, sut_start, sut_tick_isr, Scheduler_Dispatch, sut_release_ms,
+    NULL, Scheduler_AddServer
+};
+
+const sut_t sut_deferred = {
+    "deferred", MAX_TASKS, 0,
+    sut_reset, sut_add_task, sut_start, sut_tick_isr_deferred, Scheduler_Dispatch, sut_release_ms,
+    NULL, Scheduler_AddServer
+};
@@ -0,0 +1,213 @@
+/**
+ * @file tpackchk.c
+ * @brief lib/tpack.c round trip on the host, and a decoder for captured streams.
+ *
+ * Synthetic telemetry is encoded into packets as a task would, each packet is decoded
+ * again with TPack_Decode() and compared row by row. Channel c carries signal c % 4:
+ * - 0: 12-bit ADC reading of a slow sine with +-2 LSB noise
+ * - 1: random walk with steps of up to +-3
+ * - 2: constant with a rare jump to a random level
+ * - 3: counter, +1 per row
+ * A second pass encodes full-range white noise, where every residual is escaped. Each
+ * packet is also decoded with its last byte cut off, which must be rejected. The
+ * ratio counts one length byte per packet, as a UART or blklog.h frame would.
+ *
+ * -w file writes the stream as [len][packet]...; -x file decodes such a capture
+ * (e.g. from the UART) and prints one CSV line per row instead of running the check.
+ * Exit status 1 on any mismatch.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "sim.h"
+#include "tpack.h"
+
+static uint8_t channels = 4;
+static uint32_t total_rows = 100000;
+static uint16_t packet_cap = 255;
+static uint32_t bad;
+
+static void fail(const char *what, uint32_t a, uint32_t b)
+{
+    if (bad++ < 10)
+        printf("mismatch: %s (%lu, %lu)\n", what, (unsigned long)a, (unsigned long)b);
+}
+
+/* ---------- Signals ---------- */
+
+static uint16_t level[TPACK_CHANNELS];
+
+static uint16_t signal(uint8_t c, uint32_t i, uint8_t noise)
+{
+    int32_t v;
+
+    if (noise)
+        return (uint16_t)sim_rand();
+    switch (c % 4u) {
+    case 0:
+        return (uint16_t)(2048 + 1000.0 * sin(i * 2.0 * M_PI / 2000.0) +
+                          (int32_t)sim_rand_range(0, 4) - 2);
+    case 1:
+        v = (int32_t)level[c] + (int32_t)sim_rand_range(0, 6) - 3;
+        level[c] = (uint16_t)(v < 0 ? 0 : v > 4095 ? 4095 : v);
+        return level[c];
+    case 2:
+        if (sim_rand_range(0, 499) == 0)
+            level[c] = (uint16_t)sim_rand_range(0, 4095);
+        return level[c];
+    default:
+        return (uint16_t)i;
+    }
+}
+
+/* ---------- Round trip ---------- */
+
+static uint64_t check_packet(const uint8_t *pkt, uint16_t len, const uint16_t *sent, uint8_t rows)
+{
+    static uint16_t got[TPACK_MAX_ROWS * TPACK_CHANNELS];
+    int n = TPack_Decode(pkt, len, channels, got, TPACK_MAX_ROWS);
+
+    if (n != rows)
+        fail("rows decoded", (uint32_t)n, rows);
+    else if (memcmp(got, sent, (size_t)rows * channels * sizeof(uint16_t)) != 0)
+        fail("row values", rows, len);
+    if (TPack_Decode(pkt, (uint16_t)(len - 1u), channels, got, TPACK_MAX_ROWS) != -1)
+        fail("truncated packet accepted", len, rows);
+    return len + 1u;
+}
+
+static void run(const char *name, uint8_t noise, FILE *capture)
+{
+    static uint8_t pkt[1024];
+    static uint16_t sent[TPACK_MAX_ROWS * TPACK_CHANNELS];
+    uint16_t row[TPACK_CHANNELS], len, max_row = 0, before;
+    uint64_t wire = 0;
+    uint32_t i, packets = 0;
+    tpack_t p;
+    uint8_t c, rows = 0;
+
+    memset(level, 0, sizeof(level));
+    TPack_Init(&p, channels);
+    TPack_Begin(&p, pkt, packet_cap);
+    for (i = 0; i < total_rows; i++) {
+        for (c = 0; c < channels; c++)
+            row[c] = signal(c, i, noise);
+        before = p.pos;
+        if (TPack_Put(&p, row) != 0) {
+            len = TPack_End(&p);
+            wire += check_packet(pkt, len, sent, rows);
+            if (capture) {
+                fputc(len, capture);
+                fwrite(pkt, 1, len, capture);
+            }
+            packets++;
+            rows = 0;
+            TPack_Begin(&p, pkt, packet_cap);
+            before = p.pos;
+            if (TPack_Put(&p, row) != 0)
+                fail("row refused by an empty packet", i, 0);
+        }
+        if (p.pos - before > max_row)
+            max_row = p.pos - before;
+        memcpy(&sent[rows * channels], row, channels * sizeof(uint16_t));
+        rows++;
+    }
+    len = TPack_End(&p);
+    if (len) {
+        wire += check_packet(pkt, len, sent, rows);
+        if (capture) {
+            fputc(len, capture);
+            fwrite(pkt, 1, len, capture);
+        }
+        packets++;
+    }
+    printf("%-8s %8lu rows  %8lu packets  %9lu -> %8lu bytes  ratio %5.2f  "
+           "%5.2f bits/sample  max row %u bytes (limit %u)\n",
+           name, (unsigned long)total_rows, (unsigned long)packets,
+           (unsigned long)(total_rows * channels * 2u), (unsigned long)wire,
+           (double)total_rows * channels * 2u / wire,
+           wire * 8.0 / ((double)total_rows * channels), max_row, TPACK_ROW_MAX(channels));
+}
+
+/* ---------- Capture decoder ---------- */
+
+static int decode_file(const char *path)
+{
+    static uint8_t pkt[256];
+    static uint16_t rows[TPACK_MAX_ROWS * TPACK_CHANNELS];
+    FILE *f = fopen(path, "rb");
+    int len, n, i, c;
+
+    if (!f) {
+        perror(path);
+        return 2;
+    }
+    while ((len = fgetc(f)) != EOF) {
+        if (fread(pkt, 1, (size_t)len, f) != (size_t)len ||
+            (n = TPack_Decode(pkt, (uint16_t)len, channels, rows, TPACK_MAX_ROWS)) < 0) {
+            fprintf(stderr, "%s: bad packet at offset %ld\n", path, ftell(f));
+            fclose(f);
+            return 1;
+        }
+        for (i = 0; i < n; i++)
+            for (c = 0; c < channels; c++)
+                printf("%u%c", rows[i * channels + c], c + 1 < channels ? ',' : '\n');
+    }
+    fclose(f);
+    return 0;
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "usage: %s [-c channels] [-n rows] [-p packet_bytes] [-S seed] [-w file] [-x file]\n"
+            "  -c  channels per row, 1..%u (default 4)\n"
+            "  -n  rows per pass (default 100000)\n"
+            "  -p  packet buffer, up to 255 for a one-byte length (default 255)\n"
+            "  -S  seed (default 1)\n"
+            "  -w  also write the smooth stream as [len][packet]... to file\n"
+            "  -x  decode such a file to CSV instead\n", prog, TPACK_CHANNELS);
+}
+
+int main(int argc, char **argv)
+{
+    const char *wpath = NULL, *xpath = NULL;
+    uint32_t seed = 1;
+    FILE *capture = NULL;
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-c") && i + 1 < argc)      channels = (uint8_t)strtoul(argv[++i], NULL, 0);
+        else if (!strcmp(argv[i], "-n") && i + 1 < argc) total_rows = strtoul(argv[++i], NULL, 0);
+        else if (!strcmp(argv[i], "-p") && i + 1 < argc) packet_cap = (uint16_t)strtoul(argv[++i], NULL, 0);
+        else if (!strcmp(argv[i], "-S") && i + 1 < argc) seed = strtoul(argv[++i], NULL, 0);
+        else if (!strcmp(argv[i], "-w") && i + 1 < argc) wpath = argv[++i];
+        else if (!strcmp(argv[i], "-x") && i + 1 < argc) xpath = argv[++i];
+        else { usage(argv[0]); return 2; }
+    }
+    if (channels == 0 || channels > TPACK_CHANNELS || packet_cap > 255u ||
+        packet_cap < 1u + TPACK_ROW_MAX(channels)) {
+        usage(argv[0]);
+        return 2;
+    }
+    if (xpath)
+        return decode_file(xpath);
+
+    if (wpath && !(capture = fopen(wpath, "wb"))) {
+        perror(wpath);
+        return 2;
+    }
+    sim_reset(8000000u, seed);
+    run("smooth", 0, capture);
+    run("noise", 1, NULL);
+    if (capture)
+        fclose(capture);
+    if (bad) {
+        printf("%lu mismatches\n", (unsigned long)bad);
+        return 1;
+    }
+    printf("all packets decode to the rows sent\n");
+    return 0;
+}
@@ -0,0 +1,213 @@
+/**
+ * @file tseries.c
+ * @brief lib/tstore.c against a reference model on the host.
+ *
+ * The store is built with TSTORE_UNLOCK/TSTORE_LOCK counting FRAM write windows; its
+ * FRAM ring and headers are ordinary statics, so they survive TStore_Init() like FRAM
+ * survives a reset. A random workload mixes:
+ * - appends with non-decreasing timestamps (equal ones included) and a few older ones,
+ *   which must be rejected
+ * - flushes, and remounts that drop the uncommitted batch; some remounts first tear the
+ *   newest header, and the store must fall back to the previous commit
+ * - range queries: TStore_Seek() must count exactly the model's records in [from, to)
+ *   and TStore_Next() must return them in order with the right values
+ * - lapped cursors: records are appended between reads until the writer overtakes the
+ *   cursor; every record read must still be right and read + lost must cover the range
+ * Exit status 1 on any mismatch.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim.h"
+
+static uint32_t unlocks, locks;
+#define TSTORE_UNLOCK()     (unlocks++, (uint16_t)0)
+#define TSTORE_LOCK(sam)    ((void)(sam), locks++)
+
+#include "../lib/tstore.c"
+
+static uint32_t *model_t;               // timestamp of every record ever appended
+static uint32_t model_cap;
+static uint32_t appended, committed;    // model counts; batch = appended - committed
+static uint32_t bad;
+
+static uint16_t value(uint32_t a, uint8_t i)
+{
+    return (uint16_t)(a * 7u + i);
+}
+
+static uint32_t model_oldest(void)
+{
+    return committed > TSTORE_CAPACITY ? committed - TSTORE_CAPACITY : 0;
+}
+
+static void fail(const char *what, uint32_t a, uint32_t b)
+{
+    if (bad++ < 10)
+        printf("mismatch: %s (%lu, %lu)\n", what, (unsigned long)a, (unsigned long)b);
+}
+
+static void check_rec(uint32_t a, const tstore_rec_t *rec)
+{
+    uint8_t i;
+
+    if (a >= committed || rec->t != model_t[a]) {
+        fail("record time", a, rec->t);
+        return;
+    }
+    for (i = 0; i < TSTORE_VALUES; i++)
+        if (rec->v[i] != value(a, i))
+            fail("record value", a, i);
+}
+
+/* ---------- Operations ---------- */
+
+static void op_append(void)
+{
+    uint32_t last = appended ? model_t[appended - 1u] : 0, t;
+    uint16_t v[TSTORE_VALUES] = { 0 };
+    uint8_t i;
+    int rc;
+
+    if (last > 0 && sim_rand_range(0, 99) == 0) {
+        if (TStore_Append(last - 1u, v) != -1)
+            fail("older timestamp accepted", appended, last - 1u);
+        return;
+    }
+    t = last + sim_rand_range(0, 3) * sim_rand_range(0, 40);
+    for (i = 0; i < TSTORE_VALUES; i++)
+        v[i] = value(appended, i);
+    if (appended == model_cap) {
+        model_cap *= 2u;
+        model_t = realloc(model_t, model_cap * sizeof(*model_t));
+    }
+    model_t[appended] = t;
+    rc = TStore_Append(t, v);
+    if (rc != 0)
+        fail("append refused", appended, t);
+    appended++;
+    if (appended - committed == TSTORE_BATCH)
+        committed = appended;
+}
+
+static void op_remount(void)
+{
+    uint8_t tear = committed > 0 && hdr_valid(&hdr[hdr_cur ^ 1u]) && sim_rand_range(0, 1);
+
+    if (tear) {
+        committed = hdr[hdr_cur ^ 1u].count;
+        hdr[hdr_cur].count_inv ^= 1u;   // reset while the newest header was written
+    }
+    if (TStore_Init() != 0)
+        fail("remount formatted", committed, 0);
+    appended = committed;
+    if (TStore_Count() != committed - model_oldest())
+        fail("count after remount", TStore_Count(), committed);
+}
+
+static void op_query(uint32_t *queries, uint64_t *returned)
+{
+    tstore_cursor_t c;
+    const tstore_rec_t *rec;
+    uint32_t lo = model_oldest(), a, from, to, expect = 0, n, i, first = 0;
+    uint32_t t0 = committed ? model_t[lo] : 0, t1 = committed ? model_t[committed - 1u] : 0;
+    uint8_t found = 0;
+
+    from = sim_rand_range(t0 > 20u ? t0 - 20u : 0, t1 + 20u);
+    to = from + sim_rand_range(0, (t1 - t0) / 4u + 40u);
+    for (a = lo; a < committed; a++)
+        if (model_t[a] >= from && model_t[a] < to) {
+            if (!found) first = a;
+            found = 1;
+            expect++;
+        }
+    n = TStore_Seek(&c, from, to);
+    if (n != expect || (found && c.pos != first))
+        fail("range size", n, expect);
+    a = first;
+    while ((n = TStore_Next(&c, &rec, (uint16_t)sim_rand_range(1, 40))) != 0)
+        for (i = 0; i < n; i++)
+            check_rec(a++, &rec[i]);
+    if (a != first + expect)
+        fail("records streamed", a - first, expect);
+    (*queries)++;
+    *returned += expect;
+}
+
+/* Append behind a slow reader until it is overtaken */
+static void op_lap(uint32_t *lost_max)
+{
+    tstore_cursor_t c;
+    const tstore_rec_t *rec;
+    uint32_t total = TStore_Seek(&c, 0, 0xFFFFFFFFu), read = 0, k, n, i;
+
+    while ((n = TStore_Next(&c, &rec, 4)) != 0) {
+        for (i = 0; i < n; i++)
+            check_rec(c.pos - n + i, &rec[i]);
+        read += n;
+        for (k = 0; k < 30u; k++)
+            op_append();
+    }
+    if (read + c.lost != total)
+        fail("lapped cursor", read + c.lost, total);
+    if (c.lost > *lost_max)
+        *lost_max = c.lost;
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "usage: %s [-n ops] [-S seed]\n"
+            "  -n  operations (default 200000)\n"
+            "  -S  seed (default 1)\n", prog);
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t ops = 200000, seed = 1, i, r, remounts = 0, queries = 0, laps = 0, lost_max = 0;
+    uint64_t returned = 0;
+    const tstore_stats_t *st;
+
+    for (i = 1; i < (uint32_t)argc; i++) {
+        if (!strcmp(argv[i], "-n") && i + 1 < (uint32_t)argc)      ops = strtoul(argv[++i], NULL, 0);
+        else if (!strcmp(argv[i], "-S") && i + 1 < (uint32_t)argc) seed = strtoul(argv[++i], NULL, 0);
+        else { usage(argv[0]); return 2; }
+    }
+
+    sim_reset(8000000u, seed);
+    model_cap = 4096;
+    model_t = malloc(model_cap * sizeof(*model_t));
+    if (TStore_Init() != 1)
+        fail("blank FRAM not formatted", 0, 0);
+
+    for (i = 0; i < ops; i++) {
+        r = sim_rand_range(0, 999);
+        if (r < 900) op_append();
+        else if (r < 930) { TStore_Flush(); committed = appended; }
+        else if (r < 935) { op_remount(); remounts++; }
+        else if (r < 999) op_query(&queries, &returned);
+        else { op_lap(&lost_max); laps++; }
+    }
+    TStore_Flush();
+    committed = appended;
+    op_query(&queries, &returned);
+
+    st = TStore_GetStats();
+    printf("%lu records appended, %lu in the ring, %u commits since the last mount "
+           "(%.1f records per FRAM unlock), %lu remounts\n",
+           (unsigned long)appended, (unsigned long)TStore_Count(), st->commits,
+           st->commits ? (double)st->appended / st->commits : 0.0, (unsigned long)remounts);
+    printf("%lu range queries (%.1f records each), %lu lapped cursors (up to %lu lost)\n",
+           (unsigned long)queries, queries ? (double)returned / queries : 0.0,
+           (unsigned long)laps, (unsigned long)lost_max);
+    if (unlocks != locks)
+        fail("unbalanced FRAM unlocks", unlocks, locks);
+    free(model_t);
+    if (bad) {
+        printf("%lu mismatches\n", (unsigned long)bad);
+        return 1;
+    }
+    printf("all ranges and records match the model\n");
+    return 0;
+}
@@ -0,0 +1,251 @@
+/**
+ * @file txvloop.c
+ * @brief lib/uart.c vectored writes (Uart_WriteV) on host/sim.c with a DMA model.
+ *
+ * The driver is built with UART_DMA_INIT/UART_DMA_START replaced by a model of DMA
+ * channel 2: a segment takes its byte time at the baud rate, then its bytes are copied
+ * to a wire buffer and the segment end is reported from a simulated interrupt, as the
+ * DMA ISR does on the target.
+ *
+ * Two lib/scheduler.c tasks, and now and then the tick ISR, queue framed messages:
+ * a header in SRAM, a payload slice of a const table (FRAM on the target), sometimes an
+ * empty segment, and a CRC in SRAM. The done callback (deferred work) checks that the
+ * whole message is on the wire, then overwrites the header and CRC buffers, so a
+ * segment read after its release corrupts the wire. At the end the wire must equal
+ * every message in submission order, and every message must have been released or
+ * counted by Uart_TxvLostEvents(). Exit status 1 on any mismatch.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim.h"
+
+#define SERVER_CLOCK() ((uint32_t)(sim_now() >> 3))
+
+static void model_start(const void *base, uint16_t len);
+#define UART_DMA_INIT()             ((void)0)
+#define UART_DMA_START(base, len)   model_start(base, len)
+
+#include "../lib/uart.c"
+#include "../lib/server.c"
+#include "../lib/scheduler.c"
+
+#define MCLK_HZ         8000000u
+#define MSGS            6u          // message blocks per submitter
+#define MAX_PAYLOAD     48u
+#define WIRE_MAX        (4u << 20)
+
+/* ---------- DMA model ---------- */
+
+static uint32_t byte_cycles;
+static int dma_src;
+static const uint8_t *dma_base;
+static uint16_t dma_len;
+static uint8_t *wire, *expect;
+static uint32_t wire_len, expect_len;
+static uint64_t busy_cycles;
+
+static void model_start(const void *base, uint16_t len)
+{
+    dma_base = base;
+    dma_len = len;
+    busy_cycles += (uint64_t)len * byte_cycles;
+    sim_trigger(dma_src, sim_now() + (uint64_t)len * byte_cycles);
+}
+
+static void model_isr(void)
+{
+    if (wire_len + dma_len <= WIRE_MAX)
+        memcpy(&wire[wire_len], dma_base, dma_len);
+    wire_len += dma_len;
+    txv_segment_done();
+    __bic_SR_register_on_exit(LPM0_bits);
+}
+
+/* ---------- Workload ---------- */
+
+typedef struct {
+    uart_txv_t txv;                 // first member: done gets the block
+    uart_iov_t iov[4];
+    uint8_t    hdr[4];
+    uint8_t    crc[2];
+    uint32_t   end;                 // wire offset after this message
+    uint8_t    busy;                // queued, done not run yet
+} msg_t;
+
+static msg_t msgs[3][MSGS];         // task 0, task 1, tick ISR
+static uint8_t payload[1024];       // stands in for a FRAM table
+static uint32_t seq, submitted, released, skipped, bad;
+static uint8_t stop;
+
+static void fail(const char *what, uint32_t a, uint32_t b)
+{
+    if (bad++ < 10)
+        printf("mismatch: %s (%lu, %lu)\n", what, (unsigned long)a, (unsigned long)b);
+}
+
+static void msg_done(uintptr_t arg)
+{
+    msg_t *m = (msg_t *)arg;
+
+    if (m->txv.status != UART_OK || wire_len < m->end)
+        fail("released before sent", m->end, wire_len);
+    memset(m->hdr, 0xEE, sizeof(m->hdr));
+    memset(m->crc, 0xEE, sizeof(m->crc));
+    m->busy = 0;
+    released++;
+}
+
+/* Build a frame in a free block of the submitter and queue it (GIE clear) */
+static void submit(uint8_t who)
+{
+    msg_t *m = NULL;
+    uint16_t off, len, crc = 0xFFFF, i;
+    uint8_t n = 0, k;
+
+    for (k = 0; k < MSGS && !m; k++)
+        if (!msgs[who][k].busy)
+            m = &msgs[who][k];
+    if (!m || stop) {
+        skipped += !stop;
+        return;
+    }
+
+    len = (uint16_t)sim_rand_range(0, MAX_PAYLOAD);
+    off = (uint16_t)sim_rand_range(0, sizeof(payload) - MAX_PAYLOAD);
+    m->hdr[0] = 0xA5;
+    m->hdr[1] = (uint8_t)seq;
+    m->hdr[2] = (uint8_t)(seq >> 8);
+    m->hdr[3] = (uint8_t)len;
+    for (i = 0; i < sizeof(m->hdr); i++)
+        crc = (uint16_t)((crc << 8) ^ (crc >> 8) ^ m->hdr[i]);
+    for (i = 0; i < len; i++)
+        crc = (uint16_t)((crc << 8) ^ (crc >> 8) ^ payload[off + i]);
+    m->crc[0] = (uint8_t)crc;
+    m->crc[1] = (uint8_t)(crc >> 8);
+
+    m->iov[n].base = m->hdr;
+    m->iov[n++].len = sizeof(m->hdr);
+    if (sim_rand_range(0, 3) == 0) {
+        m->iov[n].base = NULL;
+        m->iov[n++].len = 0;
+    }
+    m->iov[n].base = &payload[off];
+    m->iov[n++].len = len;
+    m->iov[n].base = m->crc;
+    m->iov[n++].len = sizeof(m->crc);
+    m->txv.iov = m->iov;
+    m->txv.iovcnt = n;
+    m->txv.done = msg_done;
+
+    for (k = 0; k < n; k++)
+        if (expect_len + m->iov[k].len <= WIRE_MAX) {
+            memcpy(&expect[expect_len], m->iov[k].base, m->iov[k].len);
+            expect_len += m->iov[k].len;
+        }
+    m->end = expect_len;
+    m->busy = 1;
+    if (Uart_WriteV(&m->txv) != 0)
+        fail("message refused", seq, n);
+    seq++;
+    submitted++;
+}
+
+static void task_a(uint32_t now_ms)
+{
+    (void)now_ms;
+    sim_consume(200);
+    __disable_interrupt();
+    submit(0);
+    __enable_interrupt();
+}
+
+static void task_b(uint32_t now_ms)
+{
+    uint32_t k;
+
+    (void)now_ms;
+    for (k = sim_rand_range(0, 3); k; k--) {
+        sim_consume(150);
+        __disable_interrupt();
+        submit(1);
+        __enable_interrupt();
+    }
+}
+
+static void tick_isr(void)
+{
+    SysTime_Tick();
+    Scheduler_Tick();
+    if (sim_rand_range(0, 19) == 0)
+        submit(2);                  // Uart_WriteV() from an ISR
+    __bic_SR_register_on_exit(LPM0_bits);
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "usage: %s [-d seconds] [-S seed] [-b baud]\n"
+            "  -d  simulated time (default 10)\n"
+            "  -S  seed (default 1)\n"
+            "  -b  baud rate (default 115200)\n", prog);
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t seconds = 10, seed = 1, baud = 115200u;
+    uint64_t end;
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-d") && i + 1 < argc)      seconds = strtoul(argv[++i], NULL, 0);
+        else if (!strcmp(argv[i], "-S") && i + 1 < argc) seed = strtoul(argv[++i], NULL, 0);
+        else if (!strcmp(argv[i], "-b") && i + 1 < argc) baud = strtoul(argv[++i], NULL, 0);
+        else { usage(argv[0]); return 2; }
+    }
+    if (!baud || baud > MCLK_HZ / 10u) { usage(argv[0]); return 2; }
+
+    wire = malloc(WIRE_MAX);
+    expect = malloc(WIRE_MAX);
+    for (i = 0; i < (int)sizeof(payload); i++)
+        payload[i] = (uint8_t)(i * 13 + 7);
+
+    sim_reset(MCLK_HZ, seed);
+    Clk_Init(CLK_8MHZ);
+    Defer_Init();
+    Uart_Init();
+    byte_cycles = MCLK_HZ * 10u / baud;    // start + 8 data + stop bits
+    dma_src = sim_add_source(model_isr, 0, 0, 40);
+    sim_add_source(tick_isr, MCLK_HZ / 1000u, MCLK_HZ / 1000u, 40);
+    Scheduler_AddTask(task_a, 10, 0, 0);
+    Scheduler_AddTask(task_b, 20, 1, 0);
+
+    end = (uint64_t)seconds * MCLK_HZ;
+    __enable_interrupt();
+    while (sim_now() < end)
+        Scheduler_Dispatch();
+    stop = 1;
+    while (Uart_TxvBusy() || Defer_Pending())
+        Scheduler_Dispatch();
+    __disable_interrupt();
+
+    printf("%lu messages queued, %lu released, %u release posts lost, "
+           "%lu skipped (all blocks pending), %lu bytes, UART busy %.1f%%\n",
+           (unsigned long)submitted, (unsigned long)released, Uart_TxvLostEvents(),
+           (unsigned long)skipped, (unsigned long)wire_len, 100.0 * busy_cycles / sim_now());
+    if (expect_len > WIRE_MAX || wire_len > WIRE_MAX)
+        fail("run too long for the wire buffer", wire_len, WIRE_MAX);
+    else if (wire_len != expect_len || memcmp(wire, expect, wire_len) != 0)
+        fail("wire differs from the messages", wire_len, expect_len);
+    if (released + Uart_TxvLostEvents() != submitted)
+        fail("messages neither released nor counted lost", released, submitted);
+    free(wire);
+    free(expect);
+    if (bad) {
+        printf("%lu mismatches\n", (unsigned long)bad);
+        return 1;
+    }
+    printf("wire matches every message in order; buffers released only after sending\n");
+    return 0;
+}
@@ -0,0 +1,72 @@
+/**
+ * @file adc.c
+ * @brief ADC12_B sampling as aio.h requests.
+ *
+ * Key patterns:
+ * - Single-channel single conversions on MEM0 with the sampling timer (ADC12SHP);
+ *   the ISR reads the result and sets ADC12SC again until the buffer is full
+ * - ADC12MCTL0 only changes with ADC12ENC clear, so ENC is cleared between requests
+ */
+
+#include <msp430.h>
+#include <stddef.h>
+#include "adc.h"
+
+static aio_req_t *adc_req;          // running request, NULL if none
+
+void Adc_Init(void)
+{
+    ADC12CTL0 &= ~ADC12ENC;
+    ADC12CTL0 = ADC12SHT0_4 | ADC12ON;      // 64 ADC12CLK sample-and-hold
+    ADC12CTL1 = ADC12SHP | ADC12SSEL_0;     // sampling timer, MODOSC (~4.8 MHz)
+    ADC12CTL2 = ADC12RES_2;                 // 12 bit, 14 clocks per conversion
+    ADC12IER0 = 0;
+    adc_req = NULL;
+}
+
+static int adc_start(aio_req_t *req)
+{
+    uintptr_t ch = (uintptr_t)req->target;
+
+    if (req->op != AIO_READ || !req->buf || ch >= ADC_CHANNELS || (req->len & 1u))
+        return -1;
+    adc_req = req;
+    ADC12MCTL0 = (uint16_t)ch | ADC12VRSEL_0;   // VR+ = AVCC, VR- = AVSS
+    ADC12IFGR0 &= ~ADC12IFG0;
+    ADC12IER0 = ADC12IE0;
+    ADC12CTL0 |= ADC12ENC | ADC12SC;
+    return 0;
+}
+
+static int adc_cancel(aio_req_t *req)
+{
+    (void)req;
+    ADC12IER0 = 0;
+    ADC12CTL0 &= ~ADC12ENC;
+    adc_req = NULL;
+    return 0;
+}
+
+const aio_ops_t Adc_AioOps = { adc_start, adc_cancel };
+
+void Adc_Isr(void)
+{
+    aio_req_t *req = adc_req;
+    uint16_t v;
+
+    if (ADC12IV != ADC12IV__ADC12IFG0) return;
+    v = ADC12MEM0;                          // clears ADC12IFG0
+    if (!req) return;
+
+    req->buf[req->count++] = (uint8_t)v;
+    req->buf[req->count++] = (uint8_t)(v >> 8);
+    if (req->count < req->len)
+    {
+        ADC12CTL0 |= ADC12SC;
+        return;
+    }
+    ADC12IER0 = 0;
+    ADC12CTL0 &= ~ADC12ENC;
+    adc_req = NULL;
+    Aio_Complete(req, AIO_OK);
+}
@@ -0,0 +1,36 @@
+/**
+ * @file adc.h
+ * @brief ADC12_B sampling as aio.h requests.
+ *
+ * - One request converts one input channel len / 2 times, back to back, into buf as
+ *   little-endian 16-bit results (a uint16_t array passed as bytes)
+ * - Each conversion ends in the ADC12 interrupt, which starts the next one, so the CPU
+ *   sleeps in between; call Adc_Isr() from the ADC12 ISR
+ * - The application selects the analog function of the input pins (PxSEL1/PxSEL0 = 11)
+ */
+
+#ifndef ADC_H
+#define ADC_H
+
+#include <stdint.h>
+#include "aio.h"
+
+#define ADC_CHANNELS    32u     // A0 .. A31 (ADC12INCH_x)
+
+/**
+ * @brief Power up ADC12_B: 12 bit, AVCC reference, MODOSC clock, 64-clock sample time.
+ */
+void Adc_Init(void);
+
+/**
+ * @brief aio.h driver: AIO_READ with target = (const void *)(uintptr_t)channel and an
+ *        even len. Cancel stops at once; count holds the finished samples.
+ */
+extern const aio_ops_t Adc_AioOps;
+
+/**
+ * @brief Conversion result: call from the ADC12 ISR.
+ */
+void Adc_Isr(void);
+
+#endif /* ADC_H */
@@ -0,0 +1,210 @@
+/**
+ * @file aio.c
+ * @brief Asynchronous I/O requests: device queues, completion queue, cancellation.
+ *
+ * Key patterns:
+ * - Device and completion queues are intrusive lists of caller-owned blocks linked
+ *   through req->next: no allocation, no capacity limit and no lost completions
+ * - A request is on exactly one list: its device queue (the head is running) or the
+ *   completion queue. Every list update is a few pointer writes with GIE clear
+ * - The result is parked in req->result until Aio_Run() publishes it, so a task that
+ *   sees status != AIO_PENDING may resubmit the block at once
+ * - Hardware-free: drivers live next to their peripheral code (uart.c, bus.c, adc.c)
+ */
+
+#include <msp430.h>
+#include <stddef.h>
+#include "aio.h"
+#include "hot.h"
+
+typedef struct {
+    const aio_ops_t *ops;
+    aio_req_t       *head;      // running request, NULL if idle
+    aio_req_t       *tail;
+    uint8_t          depth;
+    aio_stats_t      stats;
+} aio_dev_t;
+
+static aio_dev_t devs[AIO_DEVICES];
+static aio_req_t *volatile cq_head;   // written by drivers' ISRs
+static aio_req_t *cq_tail;
+
+/* ---------- Queues (GIE clear) ---------- */
+
+static void cq_push(aio_req_t *req, int8_t status)
+{
+    aio_dev_t *d = &devs[req->dev];
+
+    if (status == AIO_OK) d->stats.completed++;
+    else if (status == AIO_CANCELED) d->stats.canceled++;
+    else d->stats.errors++;
+
+    req->result = status;
+    req->next = NULL;
+    if (cq_tail) cq_tail->next = req;
+    else cq_head = req;
+    cq_tail = req;
+}
+
+/* Start the head of a device queue; requests the driver refuses complete at once */
+static void start_head(aio_dev_t *d)
+{
+    while (d->head)
+    {
+        aio_req_t *req = d->head;
+
+        if (d->ops->start(req) == 0) return;
+        d->head = req->next;
+        d->depth--;
+        req->count = 0;
+        cq_push(req, AIO_ERR_INVAL);
+    }
+    d->tail = NULL;
+}
+
+/* ---------- API ---------- */
+
+int Aio_Attach(uint8_t dev, const aio_ops_t *ops)
+{
+    aio_dev_t *d;
+
+    if (dev >= AIO_DEVICES || !ops || !ops->start) return -1;
+    d = &devs[dev];
+    d->ops = ops;
+    d->head = NULL;
+    d->tail = NULL;
+    d->depth = 0;
+    d->stats.submitted = 0;
+    d->stats.completed = 0;
+    d->stats.errors = 0;
+    d->stats.canceled = 0;
+    d->stats.max_queue = 0;
+    return 0;
+}
+
+int Aio_Submit(aio_req_t *req)
+{
+    aio_dev_t *d;
+    uint16_t sr;
+
+    if (!req || req->dev >= AIO_DEVICES || req->len == 0) return -1;
+    d = &devs[req->dev];
+    if (!d->ops) return -1;
+
+    sr = __get_interrupt_state();
+    __disable_interrupt();
+    if (req->status == AIO_PENDING)
+    {
+        __set_interrupt_state(sr);
+        return -1;
+    }
+    req->status = AIO_PENDING;
+    req->count = 0;
+    req->next = NULL;
+    d->stats.submitted++;
+    if (++d->depth > d->stats.max_queue) d->stats.max_queue = d->depth;
+    if (d->head)
+    {
+        d->tail->next = req;
+        d->tail = req;
+    }
+    else
+    {
+        d->head = req;
+        d->tail = req;
+        start_head(d);
+    }
+    __set_interrupt_state(sr);
+    return 0;
+}
+
+int Aio_Cancel(aio_req_t *req)
+{
+    aio_dev_t *d;
+    aio_req_t *prev;
+    int rc = -1;
+    uint16_t sr;
+
+    if (!req || req->dev >= AIO_DEVICES) return -1;
+    d = &devs[req->dev];
+
+    sr = __get_interrupt_state();
+    __disable_interrupt();
+    if (req->status == AIO_PENDING && d->head)
+    {
+        if (req == d->head)
+        {
+            /* Running: only the driver can stop it */
+            if (d->ops->cancel && d->ops->cancel(req) == 0)
+            {
+                Aio_Complete(req, AIO_CANCELED);
+                rc = 0;
+            }
+        }
+        else
+        {
+            /* Queued: unlink; the walk is bounded by the caller's request blocks */
+            prev = d->head;
+            while (prev->next && prev->next != req) prev = prev->next;
+            if (prev->next == req)
+            {
+                prev->next = req->next;
+                if (d->tail == req) d->tail = prev;
+                d->depth--;
+                req->count = 0;
+                cq_push(req, AIO_CANCELED);
+                rc = 0;
+            }
+        }
+    }
+    __set_interrupt_state(sr);
+    return rc;
+}
+
+HOT_FN void Aio_Complete(aio_req_t *req, int8_t status)
+{
+    aio_dev_t *d = &devs[req->dev];
+    uint16_t sr;
+
+    sr = __get_interrupt_state();
+    __disable_interrupt();
+    if (d->head == req)
+    {
+        d->head = req->next;
+        if (!d->head) d->tail = NULL;
+        d->depth--;
+        cq_push(req, status);
+        start_head(d);
+    }
+    __set_interrupt_state(sr);
+}
+
+HOT_FN uint16_t Aio_Run(void)
+{
+    uint16_t count = 0;
+    aio_req_t *req;
+
+    while (cq_head)                         // only this loop removes entries
+    {
+        __disable_interrupt();
+        req = cq_head;
+        cq_head = req->next;
+        if (!cq_head) cq_tail = NULL;
+        __enable_interrupt();
+
+        req->status = req->result;          // the block is the caller's again
+        if (req->done) req->done(req);
+        count++;
+    }
+    return count;
+}
+
+uint8_t Aio_Pending(void)
+{
+    return cq_head != NULL;
+}
+
+const aio_stats_t *Aio_GetStats(uint8_t dev)
+{
+    return dev < AIO_DEVICES ? &devs[dev].stats : NULL;
+}
@@ -0,0 +1,142 @@
+/**
+ * @file aio.h
+ * @brief Asynchronous I/O requests: one submit/complete/cancel interface for all drivers.
+ *
+ * - A request block (aio_req_t) is caller-owned and usually static; Aio_Submit() queues
+ *   it on its device and returns, so a task can keep several requests in flight and
+ *   let the CPU sleep while the hardware works
+ * - Drivers plug in behind a device number with Aio_Attach(dev, ops): UART TX/RX
+ *   (uart.h), SPI/I2C transactions (bus.h) and ADC12 sampling (adc.h). Each device runs
+ *   one request at a time, in submission order
+ * - A finished request goes to the completion queue, which Scheduler_Dispatch() drains
+ *   ahead of the periodic tasks (Aio_Run()): status leaves AIO_PENDING and the done
+ *   callback runs there, never in an ISR
+ * - Aio_Cancel() removes a queued request, or stops a running one if its driver can
+ */
+
+#ifndef AIO_H
+#define AIO_H
+
+#include <stdint.h>
+
+#define AIO_DEVICES     6u      // device numbers 0 .. AIO_DEVICES-1, chosen by the app
+
+/* Operations */
+#define AIO_READ        0u
+#define AIO_WRITE       1u
+
+/* Request status */
+#define AIO_PENDING     1       // queued, running or waiting in the completion queue
+#define AIO_OK          0
+#define AIO_ERR_IO      (-1)    // device error (e.g. I2C NACK)
+#define AIO_ERR_INVAL   (-2)    // rejected by the driver at start
+#define AIO_CANCELED    (-3)
+
+typedef struct aio_req aio_req_t;
+
+/**
+ * @typedef aio_fn_t
+ * @brief Completion callback, called from Scheduler_Dispatch() with GIE set.
+ */
+typedef void (*aio_fn_t)(aio_req_t *req);
+
+/**
+ * @struct aio_req
+ * @brief One request. The engine owns it while status is AIO_PENDING.
+ */
+struct aio_req {
+    struct aio_req  *next;      /**< Device queue, then completion queue link */
+    uint8_t          dev;       /**< Device number given to Aio_Attach() */
+    uint8_t          op;        /**< AIO_READ or AIO_WRITE */
+    volatile int8_t  status;    /**< AIO_PENDING until drained, then the result */
+    int8_t           result;    /**< Result waiting in the completion queue (private) */
+    const void      *target;    /**< Driver-specific: bus_dev_t *, ADC input channel */
+    const uint8_t   *cmd;       /**< Bus devices: bytes written before buf, NULL = none */
+    uint16_t         cmd_len;
+    uint8_t         *buf;
+    uint16_t         len;       /**< Bytes to move, > 0 */
+    uint16_t         count;     /**< Bytes moved, set at completion */
+    aio_fn_t         done;      /**< NULL: poll status instead */
+    uintptr_t        user;      /**< Free for the caller */
+};
+
+/**
+ * @struct aio_ops_t
+ * @brief Driver interface. Both functions are called with GIE clear.
+ */
+typedef struct {
+    /** Start req on the idle device; return 0, or -1 to fail it with AIO_ERR_INVAL.
+     *  The driver later calls Aio_Complete() from its ISR or deferred work. */
+    int (*start)(aio_req_t *req);
+    /** Stop the running req and set req->count; return 0, or -1 if it cannot be
+     *  stopped. NULL if the device has no way to abort a transfer. */
+    int (*cancel)(aio_req_t *req);
+} aio_ops_t;
+
+/**
+ * @struct aio_stats_t
+ * @brief Counters per device since Aio_Attach().
+ */
+typedef struct {
+    uint32_t submitted;         /**< Requests accepted */
+    uint32_t completed;         /**< Requests finished with AIO_OK */
+    uint16_t errors;            /**< Requests finished with a device or start error */
+    uint16_t canceled;          /**< Requests finished with AIO_CANCELED */
+    uint8_t  max_queue;         /**< Deepest queue, running request included */
+} aio_stats_t;
+
+/**
+ * @brief Bind a driver to a device number and clear its queue and counters.
+ *
+ * Call with interrupts disabled, after the driver's own init.
+ *
+ * @return 0 on success, -1 on bad arguments.
+ */
+int Aio_Attach(uint8_t dev, const aio_ops_t *ops);
+
+/**
+ * @brief Queue a request. Callable from tasks and ISRs.
+ *
+ * @param req dev, op, buf and len set; status must not be AIO_PENDING.
+ * @return 0 if queued, -1 if the device has no driver, req is in use or empty.
+ */
+int Aio_Submit(aio_req_t *req);
+
+/**
+ * @brief Cancel a request. A queued request completes with AIO_CANCELED; a running
+ *        one only if its driver can stop it (count then tells how far it got).
+ *
+ * @return 0 if canceled, -1 if it is not pending, already finished or cannot be stopped.
+ */
+int Aio_Cancel(aio_req_t *req);
+
+/**
+ * @brief Driver side: the running request of a device has finished.
+ *
+ * Moves req to the completion queue and starts the next queued request.
+ * Call from the driver's ISR or deferred work, with req->count set.
+ *
+ * @param status AIO_OK or a negative AIO_ERR_ value.
+ */
+void Aio_Complete(aio_req_t *req, int8_t status);
+
+/**
+ * @brief Drain the completion queue: publish each status and call its callback.
+ *
+ * Called by Scheduler_Dispatch(); requests finishing meanwhile are drained too.
+ *
+ * @return Number of requests drained.
+ */
+uint16_t Aio_Run(void);
+
+/**
+ * @brief Non-zero if the completion queue holds requests (call with GIE clear).
+ */
+uint8_t Aio_Pending(void);
+
+/**
+ * @brief Counters of a device (NULL if out of range).
+ */
+const aio_stats_t *Aio_GetStats(uint8_t dev);
+
+#endif /* AIO_H */
@@ -0,0 +1,89 @@
+/**
+ * @file background.c
+ * @brief Slack-stealing background jobs: best-effort work in the gaps between releases.
+ *
+ * Key patterns:
+ * - The slack is supplied by the scheduler, which knows its next release; this module
+ *   only compares it with the declared chunk cost
+ * - One chunk per call: the scheduler re-checks releases and deferred work between
+ *   chunks, so background work never delays a periodic release
+ * - The awake flags are single bytes: Background_Wake() from an ISR is one store
+ */
+
+#include <msp430.h>
+#include <stddef.h>
+#include "systime.h"
+#include "background.h"
+
+typedef struct {
+    bg_fn_t  fn;
+    uint16_t chunk_us;
+    volatile uint8_t awake;
+} bg_job_t;
+
+static bg_job_t jobs[BG_MAX_JOBS];
+static uint8_t job_count = 0;
+static uint8_t next_job = 0;        // round-robin start
+static bg_stats_t bg_stats;
+
+void Background_Init(void)
+{
+    job_count = 0;
+    next_job = 0;
+    bg_stats.chunks = 0;
+    bg_stats.completed = 0;
+    bg_stats.no_slack = 0;
+}
+
+int8_t Background_Add(bg_fn_t fn, uint16_t chunk_us)
+{
+    if (!fn || job_count >= BG_MAX_JOBS) return -1;
+    jobs[job_count].fn = fn;
+    jobs[job_count].chunk_us = chunk_us;
+    jobs[job_count].awake = 0;
+    return (int8_t)job_count++;
+}
+
+void Background_Wake(uint8_t id)
+{
+    if (id < job_count) jobs[id].awake = 1;
+}
+
+uint8_t Background_Run(uint16_t slack_ticks)
+{
+    uint32_t tick_us = (uint32_t)SysTime_TickMs() * 1000u;     // over 16 bits past 65 ms
+    uint32_t slack_us = (uint32_t)slack_ticks * (tick_us - BG_TICK_LOAD_US);
+    uint8_t n, i = next_job, any = 0;
+    bg_job_t *job;
+
+    slack_us = slack_us > BG_GUARD_US ? slack_us - BG_GUARD_US : 0;
+
+    for (n = 0; n < job_count; n++, i = (uint8_t)((i + 1u) % job_count))
+    {
+        if (!jobs[i].awake) continue;
+        any = 1;
+        if (jobs[i].chunk_us <= slack_us) break;
+    }
+    if (n == job_count)
+    {
+        if (any) bg_stats.no_slack++;
+        return 0;
+    }
+
+    job = &jobs[i];
+    next_job = (uint8_t)((i + 1u) % job_count);
+    job->awake = 0;                 // a wake during the chunk re-arms the job
+    __enable_interrupt();
+
+    bg_stats.chunks++;
+    if (job->fn())
+        job->awake = 1;
+    else
+        bg_stats.completed++;
+    return 1;
+}
+
+const bg_stats_t *Background_GetStats(void)
+{
+    return &bg_stats;
+}
@@ -0,0 +1,77 @@
+/**
+ * @file background.h
+ * @brief Slack-stealing background jobs: best-effort work in the gaps between releases.
+ *
+ * - A job is a function that does one bounded chunk of work per call (at most
+ *   chunk_us at the current clock) and returns non-zero while work remains
+ * - Scheduler_Dispatch() computes the slack before the next periodic release from
+ *   its task table when nothing is due, and calls Background_Run() instead of
+ *   sleeping; a chunk only starts if it ends before that release
+ * - Jobs sleep until Background_Wake() (from tasks or ISRs), so an idle system still
+ *   drops into LPM0
+ */
+
+#ifndef BACKGROUND_H
+#define BACKGROUND_H
+
+#include <stdint.h>
+
+#define BG_MAX_JOBS      4
+#define BG_GUARD_US      200  // tick ISR latency and dispatch, once per slack interval
+#define BG_TICK_LOAD_US  100  // interrupt time per tick while a chunk runs
+
+/**
+ * @typedef bg_fn_t
+ * @brief One chunk of background work, called from the main loop with GIE set.
+ * @return Non-zero if more work remains, 0 when done (the job sleeps until woken).
+ */
+typedef uint8_t (*bg_fn_t)(void);
+
+/**
+ * @struct bg_stats_t
+ * @brief Counters since Background_Init().
+ */
+typedef struct {
+    uint32_t chunks;              /**< Chunks run */
+    uint32_t completed;           /**< Jobs that returned 0 (work finished) */
+    uint32_t no_slack;            /**< Idle passes with a job awake but too little slack */
+} bg_stats_t;
+
+/**
+ * @brief Remove all jobs and clear the counters.
+ */
+void Background_Init(void);
+
+/**
+ * @brief Register a job, initially asleep.
+ *
+ * @param fn Chunk function.
+ * @param chunk_us Worst-case duration of one call to fn, in microseconds.
+ * @return Job id (>= 0), or -1 if the table is full.
+ */
+int8_t Background_Add(bg_fn_t fn, uint16_t chunk_us);
+
+/**
+ * @brief Mark a job as having work. Safe from ISRs.
+ */
+void Background_Wake(uint8_t id);
+
+/**
+ * @brief Run one chunk of the next awake job that fits in the slack (round robin).
+ *
+ * A chunk fits if chunk_us <= slack_ticks * (tick ms * 1000 - BG_TICK_LOAD_US) -
+ * BG_GUARD_US. Call with GIE clear. If a chunk fits, interrupts are enabled, the chunk
+ * runs and 1 is returned; otherwise 0 is returned with GIE still clear, so the caller
+ * can enter LPM0 without a race.
+ *
+ * @param slack_ticks Whole ticks guaranteed to start before the next periodic release,
+ *                    after the next tick.
+ */
+uint8_t Background_Run(uint16_t slack_ticks);
+
+/**
+ * @brief Counters since Background_Init().
+ */
+const bg_stats_t *Background_GetStats(void);
+
+#endif /* BACKGROUND_H */
@@ -0,0 +1,389 @@
+/**
+ * @file blklog.c
+ * @brief Append-only block logger: records packed into 512-byte sectors on SPI NOR flash.
+ *
+ * Key patterns:
+ * - Double buffering: `fill` takes records while the writer owns the other buffer;
+ *   Append, Sync and Service all run in task context, so no locking is needed
+ * - The media layer is five macros: read (blocking), start a sector write or a block
+ *   erase, poll it.
+ *   The flash implementation below runs on lib/bus.c; host builds define LOG_MEDIA_*
+ *   with a file backend (host/logfile.c)
+ * - Flash steps (WREN, erase or page program, RDSR) are queued back to back on the
+ *   bus; BlkLog_Service() only reads the RDSR result, resubmits it while the flash is
+ *   busy and starts the next step, so a sector costs a few 1 ms polls of CPU time
+ * - Erase runs ahead: while no sector waits, the block after the current one is erased,
+ *   so a 4 KB erase (tens of ms) overlaps filling instead of stalling a sealed buffer
+ * - Pages are programmed last to first, so the header (page 0) reaches the flash only
+ *   after the rest of the sector: a sector torn by a reset never has a valid header
+ */
+
+#include <msp430.h>
+#include <stddef.h>
+#include <string.h>
+#include "blklog.h"
+
+#define LOG_BUSY        1
+
+#define OP_NONE         0u
+#define OP_WRITE        1u
+#define OP_ERASE        2u
+
+/* ---------- Media layer: SPI NOR flash (25-series command set) ---------- */
+
+#ifndef LOG_MEDIA_WRITE
+#define LOG_MEDIA_INIT(dev)                 flash_init(dev)
+#define LOG_MEDIA_READ(sector, off, buf, n) flash_read(sector, off, buf, n)
+#define LOG_MEDIA_WRITE(sector, buf)        flash_write(sector, buf)
+#define LOG_MEDIA_ERASE(sector)             flash_erase(sector)
+#define LOG_MEDIA_POLL(now_ms)              flash_poll()
+
+#define FL_WREN         0x06u
+#define FL_RDSR         0x05u
+#define FL_READ         0x03u
+#define FL_PP           0x02u       // page program, 256 bytes
+#define FL_SE           0x20u       // 4 KB sector erase
+#define FL_WIP          0x01u       // status: write in progress
+#define FL_PAGE         256u
+
+#define FL_ERASE_STEP   0u
+#define FL_PAGE_STEP    1u          // first page program: the sector's last page
+#define FL_LAST_STEP    (FL_PAGE_STEP + BLKLOG_SECTOR / FL_PAGE - 1u)
+
+static const bus_dev_t *fl_dev;
+static const uint8_t fl_wren = FL_WREN;
+static const uint8_t fl_rdsr = FL_RDSR;
+static uint8_t fl_cmd[4];
+static uint8_t fl_status;
+static bus_xfer_t fl_wren_x, fl_cmd_x, fl_data_x, fl_rdsr_x, fl_sr_x;
+static uint32_t fl_addr;
+static const uint8_t *fl_src;
+static uint8_t fl_step;
+
+static void flash_init(const bus_dev_t *dev)
+{
+    fl_dev = dev;
+}
+
+static void fl_set_cmd(uint8_t op, uint32_t addr)
+{
+    fl_cmd[0] = op;
+    fl_cmd[1] = (uint8_t)(addr >> 16);
+    fl_cmd[2] = (uint8_t)(addr >> 8);
+    fl_cmd[3] = (uint8_t)addr;
+}
+
+static int fl_submit_rdsr(void)
+{
+    fl_rdsr_x.dev = fl_dev;
+    fl_rdsr_x.tx = &fl_rdsr;
+    fl_rdsr_x.len = 1;
+    fl_rdsr_x.chain = &fl_sr_x;
+    fl_sr_x.rx = &fl_status;
+    fl_sr_x.len = 1;
+    return Bus_Submit(&fl_rdsr_x);
+}
+
+/* Queue WREN, then erase or program for the current step, then a status read */
+static int fl_issue(void)
+{
+    fl_wren_x.dev = fl_dev;
+    fl_wren_x.tx = &fl_wren;
+    fl_wren_x.len = 1;
+    fl_cmd_x.dev = fl_dev;
+    fl_cmd_x.tx = fl_cmd;
+    fl_cmd_x.len = sizeof(fl_cmd);
+    if (fl_step == FL_ERASE_STEP)
+    {
+        fl_set_cmd(FL_SE, fl_addr);
+        fl_cmd_x.chain = NULL;
+    }
+    else
+    {
+        uint16_t off = (uint16_t)(FL_LAST_STEP - fl_step) * FL_PAGE;
+
+        fl_set_cmd(FL_PP, fl_addr + off);
+        fl_data_x.tx = fl_src + off;
+        fl_data_x.len = FL_PAGE;
+        fl_cmd_x.chain = &fl_data_x;
+    }
+    if (Bus_Submit(&fl_wren_x) != 0 || Bus_Submit(&fl_cmd_x) != 0) return -1;
+    return fl_submit_rdsr();
+}
+
+static int flash_write(uint32_t sector, const uint8_t *buf)
+{
+    fl_addr = sector * BLKLOG_SECTOR;
+    fl_src = buf;
+    fl_step = FL_PAGE_STEP;
+    return fl_issue();
+}
+
+static int flash_erase(uint32_t sector)
+{
+    fl_addr = sector * BLKLOG_SECTOR;
+    fl_step = FL_ERASE_STEP;
+    return fl_issue();
+}
+
+static int flash_poll(void)
+{
+    if (fl_rdsr_x.status == BUS_PENDING) return LOG_BUSY;
+    if (fl_rdsr_x.status != BUS_OK) return -1;
+    if (fl_status & FL_WIP) return fl_submit_rdsr() == 0 ? LOG_BUSY : -1;
+    if (fl_step == FL_ERASE_STEP || fl_step == FL_LAST_STEP) return 0;
+    fl_step++;
+    return fl_issue() == 0 ? LOG_BUSY : -1;
+}
+
+/* Blocking read: waits for the bus, including transactions queued before it */
+static int flash_read(uint32_t sector, uint16_t off, uint8_t *buf, uint16_t n)
+{
+    static bus_xfer_t rd_x, rd_data_x;
+    static uint8_t rd_cmd[4];
+    uint32_t addr = sector * BLKLOG_SECTOR + off;
+
+    rd_cmd[0] = FL_READ;
+    rd_cmd[1] = (uint8_t)(addr >> 16);
+    rd_cmd[2] = (uint8_t)(addr >> 8);
+    rd_cmd[3] = (uint8_t)addr;
+    rd_x.dev = fl_dev;
+    rd_x.tx = rd_cmd;
+    rd_x.len = sizeof(rd_cmd);
+    rd_x.chain = &rd_data_x;
+    rd_data_x.rx = buf;
+    rd_data_x.len = n;
+    if (Bus_Submit(&rd_x) != 0) return -1;
+    while (rd_x.status == BUS_PENDING)
+    {
+        /* DMA and the bus ISR finish the transfer */
+    }
+    return rd_x.status == BUS_OK ? 0 : -1;
+}
+#endif /* LOG_MEDIA_WRITE */
+
+/* ---------- Logger ---------- */
+
+static uint8_t buf[2][BLKLOG_SECTOR];
+static uint8_t fill;                // buffer taking records
+static uint16_t fill_pos;           // next free byte in buf[fill]
+static int8_t sealed;               // buffer owned by the writer, -1 if none
+static uint8_t media_op;            // OP_ running on the media
+static uint32_t region_first;
+static uint32_t region_count;
+static uint32_t next_seq;
+static uint32_t erased_to;          // sectors from next_seq up to here are erased
+static blklog_stats_t stats;
+
+static void put16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put32(uint8_t *p, uint32_t v)
+{
+    put16(p, (uint16_t)v);
+    put16(p + 2, (uint16_t)(v >> 16));
+}
+
+static uint16_t get16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | ((uint16_t)p[1] << 8));
+}
+
+static uint32_t get32(const uint8_t *p)
+{
+    return get16(p) | ((uint32_t)get16(p + 2) << 16);
+}
+
+/* Decode a header; 0 if it is not a valid sector of this region */
+static uint8_t hdr_valid(const uint8_t *p, blklog_hdr_t *h)
+{
+    h->magic = get16(p);
+    h->used = get16(p + 2);
+    h->seq = get32(p + 4);
+    h->seq_inv = get32(p + 8);
+    return h->magic == BLKLOG_MAGIC && h->seq_inv == ~h->seq &&
+           h->used >= BLKLOG_HDR && h->used <= BLKLOG_SECTOR;
+}
+
+static uint32_t sector_of(uint32_t seq)
+{
+    return region_first + seq % region_count;
+}
+
+/* All 0xFF; uses buf[0], so only before the first append */
+static uint8_t sector_blank(uint32_t sector)
+{
+    uint16_t i;
+
+    if (LOG_MEDIA_READ(sector, 0, buf[0], BLKLOG_SECTOR) != 0) return 0;
+    for (i = 0; i < BLKLOG_SECTOR; i++)
+        if (buf[0][i] != 0xFFu) return 0;
+    return 1;
+}
+
+/* Hand buf[fill] to the writer and start filling the other buffer */
+static void seal(void)
+{
+    sealed = (int8_t)fill;
+    put16(&buf[fill][2], fill_pos);
+    fill ^= 1u;
+    fill_pos = BLKLOG_HDR;
+}
+
+int BlkLog_Init(const bus_dev_t *flash, uint32_t first, uint32_t count)
+{
+    uint8_t raw[BLKLOG_HDR];
+    blklog_hdr_t h;
+    uint32_t s;
+    uint8_t found = 0;
+
+    if (first % BLKLOG_ERASE || count % BLKLOG_ERASE || count < 2u * BLKLOG_ERASE) return -1;
+    LOG_MEDIA_INIT(flash);
+    region_first = first;
+    region_count = count;
+    fill = 0;
+    fill_pos = BLKLOG_HDR;
+    sealed = -1;
+    media_op = OP_NONE;
+    memset(&stats, 0, sizeof(stats));
+
+    /* Newest valid header stored where its seq belongs */
+    next_seq = 0;
+    for (s = 0; s < count; s++)
+    {
+        if (LOG_MEDIA_READ(first + s, 0, raw, BLKLOG_HDR) != 0) continue;
+        if (!hdr_valid(raw, &h) || h.seq % count != s) continue;
+        if (!found || h.seq >= next_seq)
+        {
+            next_seq = h.seq + 1u;
+            found = 1;
+        }
+    }
+    /* A block is erased before its first sector is written: the rest of it is blank,
+     * unless a reset tore the write of next_seq (data pages programmed, no header yet).
+     * NOR cannot be programmed twice, so move on to the next block, erased before use */
+    erased_to = (next_seq + BLKLOG_ERASE - 1u) / BLKLOG_ERASE * BLKLOG_ERASE;
+    if (next_seq < erased_to && !sector_blank(sector_of(next_seq)))
+        next_seq = erased_to;
+    return 0;
+}
+
+int BlkLog_Append(uint8_t type, const void *data, uint8_t len)
+{
+    uint8_t *p;
+
+    if (fill_pos + 2u + len > BLKLOG_SECTOR)
+    {
+        if (sealed >= 0)
+        {
+            stats.dropped++;
+            return -1;
+        }
+        seal();
+    }
+    p = &buf[fill][fill_pos];
+    p[0] = len;
+    p[1] = type;
+    memcpy(p + 2, data, len);
+    fill_pos += 2u + len;
+    stats.records++;
+    stats.bytes += len;
+    return 0;
+}
+
+int BlkLog_Sync(void)
+{
+    if (fill_pos == BLKLOG_HDR) return 0;
+    if (sealed >= 0) return -1;
+    seal();
+    return 0;
+}
+
+static void start_write(void)
+{
+    uint8_t *b = buf[(uint8_t)sealed];
+
+    put16(b, BLKLOG_MAGIC);
+    put32(b + 4, next_seq);
+    put32(b + 8, ~next_seq);
+    if (LOG_MEDIA_WRITE(sector_of(next_seq), b) == 0)
+    {
+        media_op = OP_WRITE;
+        return;
+    }
+    stats.errors++;
+    next_seq++;
+    sealed = -1;
+}
+
+static void start_erase(void)
+{
+    if (LOG_MEDIA_ERASE(sector_of(erased_to)) == 0) media_op = OP_ERASE;
+    else stats.errors++;
+}
+
+void BlkLog_Service(uint32_t now_ms)
+{
+    int rc;
+
+    (void)now_ms;
+    if (media_op != OP_NONE)
+    {
+        rc = LOG_MEDIA_POLL(now_ms);
+        if (rc == LOG_BUSY) return;
+        if (media_op == OP_WRITE)
+        {
+            if (rc == 0) stats.sectors++;
+            else stats.errors++;
+            next_seq++;             // a failed sector is skipped, not retried
+            sealed = -1;
+        }
+        else if (rc == 0) erased_to += BLKLOG_ERASE;
+        else stats.errors++;        // erase retried on the next call
+        media_op = OP_NONE;
+    }
+
+    if (sealed >= 0 && next_seq < erased_to)
+        start_write();
+    else if (sealed >= 0 || erased_to < next_seq / BLKLOG_ERASE * BLKLOG_ERASE + 2u * BLKLOG_ERASE)
+        start_erase();
+}
+
+uint8_t BlkLog_Busy(void)
+{
+    return sealed >= 0 || media_op != OP_NONE;
+}
+
+uint32_t BlkLog_NextSeq(void)
+{
+    return next_seq;
+}
+
+int BlkLog_ReadSector(uint32_t seq, uint8_t *sector)
+{
+    blklog_hdr_t h;
+
+    if (LOG_MEDIA_READ(sector_of(seq), 0, sector, BLKLOG_SECTOR) != 0) return -1;
+    return hdr_valid(sector, &h) && h.seq == seq ? 0 : -1;
+}
+
+uint8_t BlkLog_Next(const uint8_t *sector, uint16_t *pos, blklog_rec_t *rec)
+{
+    uint16_t used = get16(sector + 2);
+    uint16_t p = *pos < BLKLOG_HDR ? BLKLOG_HDR : *pos;
+
+    if (used > BLKLOG_SECTOR || p + 2u > used || p + 2u + sector[p] > used) return 0;
+    rec->len = sector[p];
+    rec->type = sector[p + 1];
+    rec->data = &sector[p + 2];
+    *pos = (uint16_t)(p + 2u + rec->len);
+    return 1;
+}
+
+const blklog_stats_t *BlkLog_GetStats(void)
+{
+    return &stats;
+}
@@ -0,0 +1,129 @@
+/**
+ * @file blklog.h
+ * @brief Append-only block logger: records packed into 512-byte sectors on SPI NOR flash.
+ *
+ * - BlkLog_Append() copies a record into one of two SRAM sector buffers and returns;
+ *   a full buffer is handed to the writer and the other one takes the next records.
+ *   If the writer still holds the other buffer, the record is dropped, never waited for
+ * - BlkLog_Service() is a scheduler task (1 ms): it writes sealed sectors by DMA through
+ *   lib/bus.c (two 256-byte page programs) and polls the flash status register between
+ *   steps, so no task waits on the media. Between sectors it erases the next 4 KB block
+ *   ahead of the writer, so up to 16 sectors before the oldest are blank
+ * - Layout: the region is a ring of sectors numbered by a sequence counter (sector
+ *   seq % count). Each starts with a header (magic, bytes used, seq, ~seq) followed by
+ *   records [len][type][data]. Reading in seq order gives the records in append order;
+ *   BlkLog_Init() finds the append point from the newest valid header, or the next
+ *   erase block if a reset left the sector after it partly programmed
+ * - Host builds replace the flash layer with a file (LOG_MEDIA_*, host/logfile.c)
+ */
+
+#ifndef BLKLOG_H
+#define BLKLOG_H
+
+#include <stdint.h>
+#include "bus.h"
+
+#define BLKLOG_SECTOR       512u
+#define BLKLOG_HDR          12u
+#define BLKLOG_ERASE        8u      // sectors per 4 KB erase block
+#define BLKLOG_MAGIC        0x4C42u
+#define BLKLOG_MAX_DATA     255u    // record payload bytes
+
+/**
+ * @struct blklog_hdr_t
+ * @brief Sector header, little-endian as stored.
+ */
+typedef struct {
+    uint16_t magic;
+    uint16_t used;              /**< Bytes used, header included */
+    uint32_t seq;
+    uint32_t seq_inv;           /**< ~seq: an erased or torn header never validates */
+} blklog_hdr_t;
+
+/**
+ * @struct blklog_rec_t
+ * @brief One record as returned by BlkLog_Next().
+ */
+typedef struct {
+    uint8_t        type;
+    uint8_t        len;
+    const uint8_t *data;
+} blklog_rec_t;
+
+/**
+ * @struct blklog_stats_t
+ * @brief Counters since BlkLog_Init().
+ */
+typedef struct {
+    uint32_t records;           /**< Records accepted */
+    uint32_t bytes;             /**< Payload bytes accepted */
+    uint32_t sectors;           /**< Sectors written */
+    uint32_t dropped;           /**< Records rejected: both buffers busy */
+    uint16_t errors;            /**< Sector writes that failed */
+} blklog_stats_t;
+
+/**
+ * @brief Mount the region and find the append point.
+ *
+ * Reads every sector header and blank-checks the append sector (blocking), so call it
+ * with interrupts enabled before the scheduler starts, after Bus_Init() of the flash
+ * port. A torn sector (programmed without its header) is skipped with the rest of its
+ * erase block.
+ *
+ * @param flash SPI flash on a BUS_SPI port (ignored by host builds).
+ * @param first First sector of the region, multiple of BLKLOG_ERASE.
+ * @param count Sectors in the region, multiple of BLKLOG_ERASE, >= 2 * BLKLOG_ERASE.
+ * @return 0 on success, -1 on bad arguments.
+ */
+int BlkLog_Init(const bus_dev_t *flash, uint32_t first, uint32_t count);
+
+/**
+ * @brief Append a record. Call from tasks (not ISRs); never blocks.
+ *
+ * @return 0 if buffered, -1 if both buffers are busy (the record is dropped).
+ */
+int BlkLog_Append(uint8_t type, const void *data, uint8_t len);
+
+/**
+ * @brief Seal a partly filled buffer so it is written by the next BlkLog_Service().
+ *
+ * @return 0 if sealed or empty, -1 if the writer still holds the other buffer.
+ */
+int BlkLog_Sync(void);
+
+/**
+ * @brief Writer state machine; register as a 1 ms task (task_fn_t signature).
+ */
+void BlkLog_Service(uint32_t now_ms);
+
+/**
+ * @brief Non-zero while a sealed buffer waits or the media is writing or erasing.
+ */
+uint8_t BlkLog_Busy(void);
+
+/**
+ * @brief Sequence number the next written sector will get.
+ */
+uint32_t BlkLog_NextSeq(void);
+
+/**
+ * @brief Read the sector with sequence number seq (blocking, writer idle).
+ *
+ * @return 0 if it holds that seq, -1 if it was overwritten, erased or never written.
+ */
+int BlkLog_ReadSector(uint32_t seq, uint8_t *buf);
+
+/**
+ * @brief Walk the records of a sector read by BlkLog_ReadSector().
+ *
+ * @param pos Cursor, start at 0.
+ * @return 1 with *rec filled, 0 at the end of the sector.
+ */
+uint8_t BlkLog_Next(const uint8_t *sector, uint16_t *pos, blklog_rec_t *rec);
+
+/**
+ * @brief Counters since BlkLog_Init().
+ */
+const blklog_stats_t *BlkLog_GetStats(void);
+
+#endif /* BLKLOG_H */
@@ -0,0 +1,443 @@
+/**
+ * @file bus.c
+ * @brief Queued SPI/I2C transactions on eUSCI_B0/B1 with DMA and deferred completion.
+ *
+ * Key patterns:
+ * - Queue and chain logic is hardware-free; the hardware layer only starts a segment
+ *   (BUS_HW_START) and reports its end through segment_done(). Host builds replace
+ *   BUS_HW_INIT/BUS_HW_START with a device model (host/busloop.c)
+ * - The queue is an intrusive list of caller-owned blocks: no allocation, and a
+ *   submit from an ISR costs a few pointer writes with GIE clear
+ * - SPI: RX DMA completion ends a segment (the last byte has been clocked in);
+ *   TX DMA is started by re-raising UCTXIFG, since DMA triggers are edge-sensitive
+ * - I2C: TX DMA end -> next UCTXIFG0 (last byte in the shift register) -> repeated
+ *   START or STOP; RX DMA moves len - 1 bytes, then STOP is set while the last byte
+ *   is received. A transaction ends at UCSTPIFG, so the bus is idle for the next one
+ * - Bus_AioOps maps an aio.h request to a static segment pair per device number; its
+ *   done callback (deferred work) hands the result to Aio_Complete()
+ */
+
+#include <msp430.h>
+#include <stddef.h>
+#include "clock.h"
+#include "bus.h"
+#include "wcet.h"
+
+/* Hardware layer phases (per port) */
+#define PH_IDLE         0u
+#define PH_DMA          1u      // DMA moving the segment's bytes
+#define PH_TAIL         2u      // I2C: waiting for the last byte
+#define PH_STOP         3u      // I2C: STOP requested, waiting for UCSTPIFG
+
+#define BUS_STT_POLLS   2000u   // one-byte I2C read: static bound of the address wait
+#define BUS_STT_BITS    40u     // ... and its run-time limit, in bit times
+#define BUS_POLL_CYCLES 10u     // MCLK cycles per UCTXSTT poll
+
+typedef struct {
+    uint8_t      mode;
+    uint8_t      phase;
+    int8_t       hw_status;     // result reported at UCSTPIFG
+    uint8_t      depth;
+    uint8_t      spi_mode;      // clock mode the SPI port is configured for
+    uint16_t     stt_polls;     // UCTXSTT polls in BUS_STT_BITS bit times
+    bus_xfer_t  *head;          // running transaction, NULL if idle
+    bus_xfer_t  *tail;
+    bus_xfer_t  *seg;           // running segment of head
+    bus_stats_t  stats;
+} bus_port_t;
+
+static bus_port_t bus[BUS_PORTS];
+
+static void segment_done(uint8_t p, int8_t status);
+
+/* ---------- Hardware layer ---------- */
+
+#ifndef BUS_HW_START
+#define BUS_HW_INIT(p, mode, hz)    hw_init(p, mode, hz)
+#define BUS_HW_START(p, seg, first) hw_start(p, seg, first)
+
+/* eUSCI_B register offsets from UCBxCTLW0 */
+#define UCB_CTLW0       0x00u
+#define UCB_CTLW1       0x02u
+#define UCB_BRW         0x06u
+#define UCB_RXBUF       0x0Cu
+#define UCB_TXBUF       0x0Eu
+#define UCB_I2CSA       0x20u
+#define UCB_IE          0x2Au
+#define UCB_IFG         0x2Cu
+#define UCB_IV          0x2Eu
+#define UCB(p, off)     (*(volatile uint16_t *)((volatile uint8_t *)ucb_regs[p] + (off)))
+
+/* DMA channel block: CTL, SA (20 bit), DA (20 bit), SZ */
+#define DMA_CTL         0u
+#define DMA_SA          1u
+#define DMA_DA          3u
+#define DMA_SZ          5u
+#define DMA_TRIG_RX     18u     // UCB0RXIFG0 on channels 0-2, UCB1RXIFG0 on 3-5
+#define DMA_TRIG_TX     19u     // UCB0TXIFG0 / UCB1TXIFG0
+#define DMA_BYTES       (DMADT_0 | DMASRCBYTE | DMADSTBYTE)
+
+static volatile uint16_t *const ucb_regs[BUS_PORTS] = { &UCB0CTLW0, &UCB1CTLW0 };
+static volatile uint16_t *const dma_rx[BUS_PORTS] = { &DMA0CTL, &DMA3CTL };
+static volatile uint16_t *const dma_tx[BUS_PORTS] = { &DMA1CTL, &DMA4CTL };
+static const uint8_t dma_rx_iv[BUS_PORTS] = { DMAIV_DMA0IFG, DMAIV_DMA3IFG };
+static const uint8_t dma_tx_iv[BUS_PORTS] = { DMAIV_DMA1IFG, DMAIV_DMA4IFG };
+
+static const uint8_t dummy_tx = 0xFF;
+static uint8_t sink_rx;
+
+/* Addresses are written as two words, low first (a word write clears bits 19-16) */
+static void dma_arm(volatile uint16_t *ch, const volatile void *src, volatile void *dst,
+                    uint16_t len, uint16_t ctl)
+{
+    ch[DMA_CTL] = 0;
+    *(volatile uint32_t *)&ch[DMA_SA] = (uint32_t)(uintptr_t)src;
+    *(volatile uint32_t *)&ch[DMA_DA] = (uint32_t)(uintptr_t)dst;
+    ch[DMA_SZ] = len;
+    ch[DMA_CTL] = DMA_BYTES | ctl | DMAEN;
+}
+
+/* CPOL is UCCKPL; UCCKPH is the inverse of CPHA (1 = capture on the first edge) */
+static uint16_t spi_clock_bits(uint8_t spi_mode)
+{
+    return (uint16_t)(((spi_mode & 1u) ? 0u : UCCKPH) | ((spi_mode & 2u) ? UCCKPL : 0u));
+}
+
+static void hw_init(uint8_t p, uint8_t mode, uint32_t bit_hz)
+{
+    uint32_t div = Clk_GetHz() / bit_hz;
+    uint32_t polls = div * BUS_STT_BITS / BUS_POLL_CYCLES;     // MCLK = SMCLK
+
+    bus[p].stt_polls = (uint16_t)(polls == 0 ? 1u : polls > BUS_STT_POLLS ? BUS_STT_POLLS
+                                                                         : polls);
+    UCB(p, UCB_CTLW0) = UCSWRST;
+    if (mode == BUS_SPI)
+        UCB(p, UCB_CTLW0) |= spi_clock_bits(bus[p].spi_mode) | UCMSB | UCMST | UCSYNC |
+                             UCMODE_0 | UCSSEL__SMCLK;
+    else
+    {
+        UCB(p, UCB_CTLW0) |= UCMODE_3 | UCMST | UCSYNC | UCSSEL__SMCLK;
+        UCB(p, UCB_CTLW1) = UCASTP_0;               // STOP set by the engine
+    }
+    UCB(p, UCB_BRW) = (uint16_t)(div == 0 ? 1u : div > 0xFFFFu ? 0xFFFFu : div);
+
+    if (p == BUS_B0)
+    {
+        P1SEL1 |= BIT6 | BIT7;                      // UCB0SIMO/SDA, UCB0SOMI/SCL
+        P1SEL0 &= ~(BIT6 | BIT7);
+        if (mode == BUS_SPI) { P2SEL1 |= BIT2; P2SEL0 &= ~BIT2; }   // UCB0CLK
+        DMACTL0 = (uint16_t)(DMA_TRIG_TX << 8) | DMA_TRIG_RX;      // ch1 TX, ch0 RX
+    }
+    else
+    {
+        P5SEL0 |= BIT0 | BIT1;                      // UCB1SIMO/SDA, UCB1SOMI/SCL
+        P5SEL1 &= ~(BIT0 | BIT1);
+        if (mode == BUS_SPI) { P5SEL0 |= BIT2; P5SEL1 &= ~BIT2; }  // UCB1CLK
+        DMACTL1 = (DMACTL1 & 0x00FFu) | (uint16_t)(DMA_TRIG_RX << 8); // ch3 RX
+        DMACTL2 = (DMACTL2 & 0xFF00u) | DMA_TRIG_TX;                 // ch4 TX
+    }
+    DMACTL4 = DMARMWDIS;        // DMA waits for CPU read-modify-write instructions
+
+    UCB(p, UCB_CTLW0) &= ~UCSWRST;
+}
+
+static void hw_start(uint8_t p, const bus_xfer_t *seg, uint8_t first)
+{
+    const bus_dev_t *dev = bus[p].head->dev;
+    uint16_t n;
+
+    if (bus[p].mode == BUS_SPI)
+    {
+        if (first && dev->spi_mode != bus[p].spi_mode)
+        {
+            /* Chip select is still high: the clock can change polarity now */
+            UCB(p, UCB_CTLW0) |= UCSWRST;
+            UCB(p, UCB_CTLW0) = (UCB(p, UCB_CTLW0) & ~(UCCKPH | UCCKPL)) |
+                                spi_clock_bits(dev->spi_mode);
+            UCB(p, UCB_CTLW0) &= ~UCSWRST;
+            bus[p].spi_mode = dev->spi_mode;
+        }
+        if (first && dev->cs_out) *dev->cs_out &= (uint8_t)~dev->cs_bit;
+        (void)UCB(p, UCB_RXBUF);                    // clear a stale UCRXIFG
+        dma_arm(dma_rx[p], &UCB(p, UCB_RXBUF), seg->rx ? (void *)seg->rx : (void *)&sink_rx,
+                seg->len, DMAIE | DMASRCINCR_0 | (seg->rx ? DMADSTINCR_3 : DMADSTINCR_0));
+        dma_arm(dma_tx[p], seg->tx ? (const void *)seg->tx : (const void *)&dummy_tx,
+                &UCB(p, UCB_TXBUF), seg->len,       // no DMAIE: RX completion ends it
+                DMADSTINCR_0 | (seg->tx ? DMASRCINCR_3 : DMASRCINCR_0));
+        bus[p].phase = PH_DMA;
+        UCB(p, UCB_IFG) &= ~UCTXIFG;
+        UCB(p, UCB_IFG) |= UCTXIFG;                 // edge: first TX DMA transfer
+        return;
+    }
+
+    if (first) UCB(p, UCB_I2CSA) = dev->addr;
+    bus[p].hw_status = BUS_OK;
+    UCB(p, UCB_IE) = UCNACKIE | UCSTPIE;
+    if (seg->tx)
+    {
+        UCB(p, UCB_CTLW0) |= UCTR;
+        UCB(p, UCB_IFG) &= ~UCTXIFG0;
+        dma_arm(dma_tx[p], seg->tx, &UCB(p, UCB_TXBUF), seg->len,
+                DMAIE | DMASRCINCR_3 | DMADSTINCR_0);
+        bus[p].phase = PH_DMA;
+        UCB(p, UCB_CTLW0) |= UCTXSTT;               // TXIFG0 after the address starts DMA
+    }
+    else if (seg->len > 1u)
+    {
+        UCB(p, UCB_CTLW0) &= ~UCTR;
+        dma_arm(dma_rx[p], &UCB(p, UCB_RXBUF), seg->rx, seg->len - 1u,
+                DMAIE | DMASRCINCR_0 | DMADSTINCR_3);
+        bus[p].phase = PH_DMA;
+        UCB(p, UCB_CTLW0) |= UCTXSTT;
+    }
+    else
+    {
+        /* One byte: STOP must be requested as soon as the address has been sent. The
+         * wait is bounded in bit times, as it may run in the DMA or USCI ISR (bus.h) */
+        UCB(p, UCB_CTLW0) &= ~UCTR;
+        UCB(p, UCB_CTLW0) |= UCTXSTT;
+        for (n = bus[p].stt_polls; (UCB(p, UCB_CTLW0) & UCTXSTT) && n; n--)
+        {
+            WCET_LOOP_BOUND(BUS_STT_POLLS);
+        }
+        UCB(p, UCB_CTLW0) |= UCTXSTP;
+        if (!n) bus[p].hw_status = BUS_ERR_TIMEOUT;
+        bus[p].phase = PH_TAIL;
+        UCB(p, UCB_IE) |= UCRXIE0;
+    }
+}
+
+uint8_t Bus_DmaIsr(uint16_t dmaiv)
+{
+    uint8_t p;
+
+    for (p = 0; p < BUS_PORTS; p++)
+    {
+        if (bus[p].phase != PH_DMA) continue;
+        if (bus[p].mode == BUS_SPI && dmaiv == dma_rx_iv[p])
+        {
+            const bus_xfer_t *seg = bus[p].seg;
+            const bus_dev_t *dev = bus[p].head->dev;
+
+            bus[p].phase = PH_IDLE;
+            if (!seg->chain && dev->cs_out) *dev->cs_out |= dev->cs_bit;
+            segment_done(p, BUS_OK);
+            return 1;
+        }
+        if (bus[p].mode == BUS_I2C && (dmaiv == dma_rx_iv[p] || dmaiv == dma_tx_iv[p]))
+        {
+            bus[p].phase = PH_TAIL;
+            if (dmaiv == dma_rx_iv[p])
+                UCB(p, UCB_CTLW0) |= UCTXSTP;       // NACK + STOP after the last byte
+            UCB(p, UCB_IE) |= (dmaiv == dma_rx_iv[p]) ? UCRXIE0 : UCTXIE0;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+void Bus_UsciIsr(uint8_t port)
+{
+    bus_port_t *b;
+
+    if (port >= BUS_PORTS) return;
+    b = &bus[port];
+
+    switch (UCB(port, UCB_IV))
+    {
+        case USCI_I2C_UCNACKIFG:
+            dma_rx[port][DMA_CTL] = 0;
+            dma_tx[port][DMA_CTL] = 0;
+            UCB(port, UCB_IE) &= ~(UCTXIE0 | UCRXIE0);
+            UCB(port, UCB_CTLW0) |= UCTXSTP;
+            b->hw_status = BUS_ERR_NACK;
+            b->phase = PH_STOP;
+            break;
+        case USCI_I2C_UCRXIFG0:                     // last byte of a read
+            UCB(port, UCB_IE) &= ~UCRXIE0;
+            b->seg->rx[b->seg->len - 1u] = (uint8_t)UCB(port, UCB_RXBUF);
+            b->phase = PH_STOP;
+            break;
+        case USCI_I2C_UCTXIFG0:                     // last written byte is shifting out
+            UCB(port, UCB_IE) &= ~UCTXIE0;
+            if (b->phase != PH_TAIL) break;
+            if (b->seg->chain)
+            {
+                b->phase = PH_IDLE;
+                segment_done(port, BUS_OK);         // next segment: repeated START
+            }
+            else
+            {
+                UCB(port, UCB_CTLW0) |= UCTXSTP;
+                b->phase = PH_STOP;
+            }
+            break;
+        case USCI_I2C_UCSTPIFG:
+            UCB(port, UCB_IE) &= ~(UCTXIE0 | UCRXIE0);
+            b->phase = PH_IDLE;
+            segment_done(port, b->hw_status);
+            break;
+        default:
+            break;
+    }
+}
+#endif /* BUS_HW_START */
+
+/* ---------- Engine ---------- */
+
+int Bus_Init(uint8_t port, uint8_t mode, uint32_t bit_hz)
+{
+    bus_port_t *b;
+
+    if (port >= BUS_PORTS || (mode != BUS_SPI && mode != BUS_I2C) || bit_hz == 0) return -1;
+    b = &bus[port];
+    b->mode = mode;
+    b->phase = PH_IDLE;
+    b->hw_status = BUS_OK;
+    b->depth = 0;
+    b->spi_mode = BUS_SPI_MODE0;
+    b->head = NULL;
+    b->tail = NULL;
+    b->seg = NULL;
+    b->stats.submitted = 0;
+    b->stats.completed = 0;
+    b->stats.errors = 0;
+    b->stats.lost_events = 0;
+    b->stats.max_queue = 0;
+    BUS_HW_INIT(port, mode, bit_hz);
+    return 0;
+}
+
+static int valid(const bus_port_t *b, const bus_xfer_t *x)
+{
+    for (; x; x = x->chain)
+    {
+        if (x->len == 0 || (!x->tx && !x->rx)) return 0;
+        if (b->mode == BUS_I2C && ((x->tx && x->rx) || (x->rx && x->chain))) return 0;
+    }
+    return 1;
+}
+
+int Bus_Submit(bus_xfer_t *x)
+{
+    bus_port_t *b;
+    uint16_t sr;
+
+    if (!x || !x->dev || x->dev->port >= BUS_PORTS || x->dev->spi_mode > BUS_SPI_MODE3)
+        return -1;
+    b = &bus[x->dev->port];
+    if (b->mode == BUS_OFF || !valid(b, x)) return -1;
+
+    sr = __get_interrupt_state();
+    __disable_interrupt();
+    if (x->status == BUS_PENDING)
+    {
+        __set_interrupt_state(sr);
+        return -1;
+    }
+    x->status = BUS_PENDING;
+    x->next = NULL;
+    b->stats.submitted++;
+    if (++b->depth > b->stats.max_queue) b->stats.max_queue = b->depth;
+    if (b->head)
+    {
+        b->tail->next = x;
+        b->tail = x;
+    }
+    else
+    {
+        b->head = x;
+        b->tail = x;
+        b->seg = x;
+        BUS_HW_START(x->dev->port, x, 1);
+    }
+    __set_interrupt_state(sr);
+    return 0;
+}
+
+/* Called by the hardware layer (ISR context) when a segment has finished */
+static void segment_done(uint8_t p, int8_t status)
+{
+    bus_port_t *b = &bus[p];
+    bus_xfer_t *x = b->head;
+
+    if (status == BUS_OK && b->seg->chain)
+    {
+        b->seg = b->seg->chain;
+        BUS_HW_START(p, b->seg, 0);
+        return;
+    }
+
+    b->head = x->next;
+    if (!b->head) b->tail = NULL;
+    b->depth--;
+    if (status == BUS_OK) b->stats.completed++;
+    else b->stats.errors++;
+    x->status = status;
+    if (x->done && Defer_Post(DEFER_PRIO_NORMAL, x->done, (uintptr_t)x) != 0)
+        b->stats.lost_events++;
+
+    if (b->head)
+    {
+        b->seg = b->head;
+        BUS_HW_START(p, b->head, 1);
+    }
+}
+
+/* ---------- aio.h driver ---------- */
+
+/* One segment pair per device number: requests of one device run one at a time */
+static bus_xfer_t aio_seg[AIO_DEVICES][2];
+static aio_req_t *aio_req[AIO_DEVICES];
+
+static void aio_done(uintptr_t arg)
+{
+    const bus_xfer_t *x = (const bus_xfer_t *)arg;
+    uint8_t d = (uint8_t)((x - &aio_seg[0][0]) / 2);
+    aio_req_t *req = aio_req[d];
+
+    aio_req[d] = NULL;
+    req->count = x->status == BUS_OK ? req->len : 0;
+    Aio_Complete(req, x->status == BUS_OK ? AIO_OK : AIO_ERR_IO);
+}
+
+static int aio_start(aio_req_t *req)
+{
+    bus_xfer_t *x = aio_seg[req->dev];
+    bus_xfer_t *seg = x;
+
+    x->dev = (const bus_dev_t *)req->target;
+    x->done = aio_done;
+    if (req->cmd_len)
+    {
+        x->tx = req->cmd;
+        x->rx = NULL;
+        x->len = req->cmd_len;
+        x->chain = &x[1];
+        seg = &x[1];
+    }
+    seg->chain = NULL;
+    seg->tx = req->op == AIO_WRITE ? req->buf : NULL;
+    seg->rx = req->op == AIO_READ ? req->buf : NULL;
+    seg->len = req->len;
+
+    aio_req[req->dev] = req;
+    if (Bus_Submit(x) != 0)
+    {
+        aio_req[req->dev] = NULL;
+        return -1;
+    }
+    return 0;
+}
+
+const aio_ops_t Bus_AioOps = { aio_start, NULL };
+
+uint8_t Bus_Busy(uint8_t port)
+{
+    return port < BUS_PORTS && bus[port].head != NULL;
+}
+
+const bus_stats_t *Bus_GetStats(uint8_t port)
+{
+    return port < BUS_PORTS ? &bus[port].stats : NULL;
+}
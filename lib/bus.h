@@ -0,0 +1,143 @@
+/**
+ * @file bus.h
+ * @brief Queued SPI/I2C transactions on eUSCI_B0/B1 with DMA and deferred completion.
+ *
+ * - A transaction is a chain of segments (bus_xfer_t.chain) executed back to back with
+ *   the bus held: SPI keeps chip select low, I2C uses a repeated START; e.g. a register
+ *   read is a one-byte write segment chained to a read segment
+ * - Bus_Submit() queues the transaction and returns; each port runs one transaction at
+ *   a time, in submission order. Bytes move by DMA (B0: channels 0/1, B1: 3/4)
+ * - At the end the first segment's status is set and its done callback is posted as
+ *   deferred work (defer.h), so it runs in the main loop, never in the ISR
+ * - The application owns the DMA and USCI_Bx ISRs and calls Bus_DmaIsr() /
+ *   Bus_UsciIsr() from them
+ * - Buffers and transfer blocks belong to the engine until the callback runs
+ * - The SPI clock mode is per device: the port is switched, with chip select high,
+ *   when a transaction for a device in another mode starts
+ * - A one-byte I2C read cannot use DMA: the engine spins on UCTXSTT for the START and
+ *   address, 10 bit times (25 us at 400 kHz), then sets STOP. After a chained write
+ *   this runs in the DMA or USCI ISR; a slave holding SCL ends it after 40 bit times
+ *   (100 us at 400 kHz) with BUS_ERR_TIMEOUT
+ */
+
+#ifndef BUS_H
+#define BUS_H
+
+#include <stdint.h>
+#include "defer.h"
+#include "aio.h"
+
+#define BUS_B0          0u
+#define BUS_B1          1u
+#define BUS_PORTS       2u
+
+#define BUS_OFF         0u      // port not initialised
+#define BUS_SPI         1u      // master, MSB first, software chip select
+#define BUS_I2C         2u      // master, 7-bit addressing
+
+/* SPI clock modes (bus_dev_t.spi_mode): CPOL << 1 | CPHA */
+#define BUS_SPI_MODE0   0u      // clock idles low, data sampled on the rising edge
+#define BUS_SPI_MODE1   1u      // clock idles low, sampled on the falling edge
+#define BUS_SPI_MODE2   2u      // clock idles high, sampled on the falling edge
+#define BUS_SPI_MODE3   3u      // clock idles high, sampled on the rising edge
+
+/* Transfer status */
+#define BUS_PENDING     1
+#define BUS_OK          0
+#define BUS_ERR_NACK    (-1)    // I2C address or data byte not acknowledged
+#define BUS_ERR_TIMEOUT (-2)    // I2C START not completed (bus held low)
+
+/**
+ * @struct bus_dev_t
+ * @brief A device on a port.
+ */
+typedef struct {
+    uint8_t           port;     /**< BUS_B0 or BUS_B1 */
+    uint8_t           addr;     /**< I2C 7-bit slave address */
+    volatile uint8_t *cs_out;   /**< SPI chip select PxOUT (active low), NULL if none */
+    uint8_t           cs_bit;
+    uint8_t           spi_mode; /**< SPI clock mode, BUS_SPI_MODE0-3 (0 if omitted) */
+} bus_dev_t;
+
+/**
+ * @struct bus_xfer_t
+ * @brief One segment; the first segment of a chain stands for the whole transaction.
+ *
+ * tx only: write. rx only: read (SPI clocks out 0xFF). Both: SPI full duplex.
+ * On I2C a read segment must be the last of its chain (it ends with STOP).
+ */
+typedef struct bus_xfer {
+    struct bus_xfer *next;      /**< Engine queue link */
+    struct bus_xfer *chain;     /**< Next segment of the same transaction, NULL = last */
+    const bus_dev_t *dev;       /**< Device (first segment only) */
+    const uint8_t   *tx;
+    uint8_t         *rx;
+    uint16_t         len;       /**< Bytes, > 0 */
+    volatile int8_t  status;    /**< BUS_PENDING while queued or running (first segment) */
+    defer_fn_t       done;      /**< Posted with arg = first segment, NULL = none */
+} bus_xfer_t;
+
+/**
+ * @struct bus_stats_t
+ * @brief Counters per port since Bus_Init().
+ */
+typedef struct {
+    uint32_t submitted;         /**< Transactions accepted */
+    uint32_t completed;         /**< Transactions finished with BUS_OK */
+    uint16_t errors;            /**< Transactions finished with an error */
+    uint16_t lost_events;       /**< Callbacks not posted (defer ring full) */
+    uint8_t  max_queue;         /**< Deepest queue, running transaction included */
+} bus_stats_t;
+
+/**
+ * @brief Configure a port as SPI or I2C master at bit_hz from SMCLK (after Clk_Init()).
+ *
+ * Selects the port pins (B0: P1.6/P1.7, SPI clock P2.2; B1: P5.0/P5.1, clock P5.2)
+ * and the DMA triggers. Call with interrupts disabled, before any Bus_Submit().
+ *
+ * @return 0 on success, -1 on bad arguments.
+ */
+int Bus_Init(uint8_t port, uint8_t mode, uint32_t bit_hz);
+
+/**
+ * @brief Queue a transaction. Callable from tasks and ISRs.
+ *
+ * @param x First segment; dev must be set, status must not be BUS_PENDING.
+ * @return 0 if queued, -1 if the port is off, x is already queued, the device's SPI
+ *         clock mode is out of range or a segment is invalid for the port's mode.
+ */
+int Bus_Submit(bus_xfer_t *x);
+
+/**
+ * @brief Non-zero while the port has a transaction running or queued.
+ */
+uint8_t Bus_Busy(uint8_t port);
+
+/**
+ * @brief DMA completion: call from the DMA ISR with the value read from DMAIV.
+ *
+ * @return 1 if the channel belongs to the engine, 0 otherwise.
+ */
+uint8_t Bus_DmaIsr(uint16_t dmaiv);
+
+/**
+ * @brief I2C events (NACK, last byte, STOP): call from the USCI_B0/B1 ISR.
+ */
+void Bus_UsciIsr(uint8_t port);
+
+/**
+ * @brief Counters of a port (NULL if out of range).
+ */
+const bus_stats_t *Bus_GetStats(uint8_t port);
+
+/**
+ * @brief aio.h driver for any number of device numbers on either port.
+ *
+ * req->target is the bus_dev_t; cmd (if cmd_len > 0) is written first, then buf is
+ * written (AIO_WRITE) or read (AIO_READ) in a chained segment, i.e. after a repeated
+ * START on I2C. Requests of different device numbers share the port queue; a running
+ * transaction cannot be canceled. Completion: AIO_OK or AIO_ERR_IO (NACK, timeout).
+ */
+extern const aio_ops_t Bus_AioOps;
+
+#endif /* BUS_H */
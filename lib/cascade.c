@@ -0,0 +1,92 @@
+/**
+ * @file cascade.c
+ * @brief Multi-rate flag engine for superloops: harmonic counters in a cascade.
+ *
+ * Key patterns:
+ * - Counters count down to zero and reload their divider (period / previous period):
+ *   the common tick is one decrement and a branch, whatever the number of rates
+ * - Flags are one word: the ISR sets bits, the main loop clears what it read with one
+ *   BIC written as inline asm (C gives no guarantee that `&= ~` on a volatile compiles
+ *   to a single instruction). A read-modify-write instruction cannot be split by an
+ *   interrupt, so no flag is lost and GIE is never cleared. Other compilers and host
+ *   builds clear the bits with GIE clear instead
+ * - Cascade_Tick() is HOT_FN (lib/hot.h), like the scheduler tick
+ */
+
+#include <msp430.h>
+#include "cascade.h"
+#include "wcet.h"
+#include "hot.h"
+
+static uint16_t divider[CASCADE_MAX_RATES];
+static uint16_t count[CASCADE_MAX_RATES];
+static uint16_t missed[CASCADE_MAX_RATES];
+static uint8_t rate_count = 0;
+static volatile uint16_t flags = 0;
+
+int Cascade_Init(const uint16_t *periods, uint8_t n)
+{
+    uint16_t prev = 1;
+    uint8_t i;
+
+    if (!periods || n == 0 || n > CASCADE_MAX_RATES) return -1;
+    for (i = 0; i < n; i++)
+    {
+        if (periods[i] == 0 || periods[i] % prev != 0) return -1;
+        if (i > 0 && periods[i] == prev) return -1;
+        prev = periods[i];
+    }
+
+    prev = 1;
+    for (i = 0; i < n; i++)
+    {
+        divider[i] = periods[i] / prev;
+        count[i] = divider[i];
+        missed[i] = 0;
+        prev = periods[i];
+    }
+    rate_count = n;
+    flags = 0;
+    return 0;
+}
+
+HOT_FN void Cascade_Tick(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < rate_count; i++)
+    {
+        WCET_LOOP_BOUND(CASCADE_MAX_RATES);
+        if (--count[i] != 0) return;    // stages above only move on a rollover
+        count[i] = divider[i];
+        if (flags & (1u << i)) missed[i]++;
+        flags |= (uint16_t)(1u << i);
+    }
+}
+
+uint16_t Cascade_Take(void)
+{
+    uint16_t seen = flags;
+
+    /* Bits raised since the read stay set */
+#if defined(__GNUC__) && defined(__MSP430__)
+    __asm__ volatile ("bic.w %1, %0" : "+m" (flags) : "r" (seen));
+#else
+    uint16_t sr = __get_interrupt_state();
+
+    __disable_interrupt();
+    flags &= (uint16_t)~seen;
+    __set_interrupt_state(sr);
+#endif
+    return seen;
+}
+
+uint16_t Cascade_Pending(void)
+{
+    return flags;
+}
+
+uint16_t Cascade_Missed(uint8_t i)
+{
+    return i < rate_count ? missed[i] : 0;
+}
@@ -0,0 +1,52 @@
+/**
+ * @file cascade.h
+ * @brief Multi-rate flag engine for superloops: harmonic counters in a cascade.
+ *
+ * - Rate i has a period in ticks that is a multiple of the period of rate i - 1. Each
+ *   stage counts the rollovers of the stage below it, so Cascade_Tick() decrements one
+ *   counter per tick and only touches stage i + 1 when stage i rolls over
+ * - A rollover sets bit i of one flag word; the main loop fetches and clears the
+ *   flags it has seen with Cascade_Take() (one BIC instruction on the target, no
+ *   critical section)
+ * - A rate that rolls over while its flag is still set counts a miss
+ */
+
+#ifndef CASCADE_H
+#define CASCADE_H
+
+#include <stdint.h>
+
+#define CASCADE_MAX_RATES   16  // one bit each in the flag word
+
+/**
+ * @brief Configure the rates; call before the tick ISR is enabled.
+ *
+ * @param periods Period of each rate in ticks, ascending, each a multiple of the one
+ *                before (e.g. 100, 500, 1000, 5000 with a 1 ms tick).
+ * @param n Number of rates, 1..CASCADE_MAX_RATES.
+ * @return 0 on success, -1 on a bad count, a zero period or a non-harmonic period.
+ */
+int Cascade_Init(const uint16_t *periods, uint8_t n);
+
+/**
+ * @brief Advance the cascade by one tick. Call from the tick ISR.
+ */
+void Cascade_Tick(void);
+
+/**
+ * @brief Fetch and clear the raised flags (bit i = rate i). Safe against the ISR:
+ *        only the bits returned are cleared.
+ */
+uint16_t Cascade_Take(void);
+
+/**
+ * @brief Raised flags, without clearing them (e.g. to decide whether to sleep).
+ */
+uint16_t Cascade_Pending(void);
+
+/**
+ * @brief Rollovers of rate i that found its flag still set (0 if i is out of range).
+ */
+uint16_t Cascade_Missed(uint8_t i);
+
+#endif /* CASCADE_H */
@@ -0,0 +1,185 @@
+/**
+ * @file ccsched.c
+ * @brief Tickless task releases: one Timer_B0 compare channel (CCR1-CCR6) per task.
+ *
+ * Key patterns:
+ * - The next compare is the last one plus the period, never TB0R plus the period: the
+ *   release grid is exact in timer counts whatever the interrupt latency
+ * - No step is longer than CCSCHED_MAX_STEP, so "has TB0R passed the compare" is one
+ *   16-bit subtraction from the previous compare. An ISR that arms a compare already
+ *   passed raises CCIFG itself; a flag whose compare is not reached yet is ignored
+ * - The ISR does one channel per TB0IV read and no scan; dispatch is the pending-counter
+ *   loop of scheduler.c
+ * - Host builds replace the CCSCHED_* register macros with a TB0 model
+ *   (host/ccsched.c)
+ */
+
+#include <msp430.h>
+#include <stddef.h>
+#include "clock.h"
+#include "ccsched.h"
+#include "wcet.h"
+#include "hot.h"
+
+/* Longest compare step. Interrupts may stay disabled for 0x10000 - CCSCHED_MAX_STEP
+ * counts (4096: 4 ms at 8 MHz) before a passed compare could look not yet reached */
+#define CCSCHED_MAX_STEP    0xF000u
+
+/* ---------- Hardware layer: TB0, continuous mode, SMCLK/8 ---------- */
+
+#ifndef CCSCHED_SET
+#define CCSCHED_STOP()          (TB0CTL = MC__STOP | TBCLR)
+#define CCSCHED_RUN()           (TB0CTL = TBSSEL__SMCLK | ID__8 | MC__CONTINUOUS)
+#define CCSCHED_NOW()           TB0R
+#define CCSCHED_SET(ch, ccr)    ((&TB0CCR0)[ch] = (ccr))        // CCR1-6 follow CCR0
+#define CCSCHED_ENABLE(ch)      ((&TB0CCTL0)[ch] = CCIE)
+#define CCSCHED_FORCE(ch)       ((&TB0CCTL0)[ch] |= CCIFG)
+#endif
+
+static ccsched_task_t cc_tasks[CCSCHED_MAX_TASKS];
+static uint16_t cc_from[CCSCHED_MAX_TASKS];     // compare that fired last (ISR only)
+static uint16_t cc_armed[CCSCHED_MAX_TASKS];    // compare programmed now (ISR only)
+static uint8_t cc_count = 0;
+
+/* ---------- Setup ---------- */
+
+uint16_t CcSched_CountsPerMs(void)
+{
+    return (uint16_t)(Clk_GetHz() / 8u / 1000u);
+}
+
+/* us -> counts, -1 if not a whole number of counts or over 32 bits */
+static int to_counts(uint32_t us, uint32_t *counts)
+{
+    uint16_t cpm = CcSched_CountsPerMs();
+    uint32_t frac = (us % 1000u) * cpm;
+
+    if (frac % 1000u != 0 || us / 1000u > (0xFFFFFFFFUL - frac / 1000u) / cpm) return -1;
+    *counts = us / 1000u * cpm + frac / 1000u;
+    return 0;
+}
+
+void CcSched_Init(void)
+{
+    CCSCHED_STOP();
+    cc_count = 0;
+}
+
+int CcSched_AddTask(ccsched_fn_t fn, uint32_t period_us, uint32_t offset_us)
+{
+    ccsched_task_t *t;
+    uint32_t period, offset;
+
+    if (!fn || cc_count >= CCSCHED_MAX_TASKS) return -1;
+    if (to_counts(period_us, &period) != 0 || to_counts(offset_us, &offset) != 0) return -1;
+    if (period < CCSCHED_MIN_COUNTS || offset > 0xFFFFFFFFUL - period) return -1;
+
+    t = &cc_tasks[cc_count];
+    t->fn = fn;
+    t->period = period;
+    t->left = period + offset;
+    t->release = 0;
+    t->max_late = 0;
+    t->late_arms = 0;
+    t->pending = 0;
+    return cc_count++;
+}
+
+/* ---------- Compare channels ---------- */
+
+/* Program the next step towards the release; hops split long periods so that no step
+ * is longer than CCSCHED_MAX_STEP and none shorter than half of it */
+static void arm(uint8_t i)
+{
+    ccsched_task_t *t = &cc_tasks[i];
+    uint16_t step;
+
+    if (t->left <= CCSCHED_MAX_STEP) step = (uint16_t)t->left;
+    else if (t->left >= 2u * (uint32_t)CCSCHED_MAX_STEP) step = CCSCHED_MAX_STEP;
+    else step = (uint16_t)(t->left / 2u);
+
+    t->left -= step;
+    cc_from[i] = cc_armed[i];
+    cc_armed[i] += step;
+    CCSCHED_SET(i + 1u, cc_armed[i]);
+    if ((uint16_t)(CCSCHED_NOW() - cc_from[i]) >= step)
+    {
+        t->late_arms++;             // passed while we got here: no match will come
+        CCSCHED_FORCE(i + 1u);
+    }
+}
+
+void CcSched_Start(void)
+{
+    uint8_t i;
+
+    CCSCHED_STOP();                 // TB0R = 0 while the first compares are armed
+    for (i = 0; i < cc_count; i++)
+    {
+        cc_armed[i] = 0;
+        arm(i);
+        CCSCHED_ENABLE(i + 1u);
+    }
+    CCSCHED_RUN();
+}
+
+HOT_FN uint8_t CcSched_Isr(uint16_t tbiv)
+{
+    uint8_t i = (uint8_t)(tbiv >> 1) - 1u;  // TB0IV: 2 = CCR1 ... 12 = CCR6
+    ccsched_task_t *t;
+
+    if ((tbiv & 1u) || i >= cc_count) return 0;
+    t = &cc_tasks[i];
+    if ((uint16_t)(CCSCHED_NOW() - cc_from[i]) < (uint16_t)(cc_armed[i] - cc_from[i]))
+        return 0;                   // stale flag: compare not reached yet
+    if (t->left != 0)
+    {
+        arm(i);                     // intermediate hop of a long period
+        return 0;
+    }
+    t->release = cc_armed[i];
+    if (t->pending < 0xFFFFu) t->pending++;
+    t->left = t->period;
+    arm(i);
+    return 1;
+}
+
+/* ---------- Dispatch ---------- */
+
+HOT_FN void CcSched_Dispatch(void)
+{
+    uint8_t i, have_work = 0;
+
+    /* GIE clear between the check and LPM entry: a release cannot slip in between */
+    __disable_interrupt();
+    for (i = 0; i < cc_count; i++)
+    {
+        WCET_LOOP_BOUND(CCSCHED_MAX_TASKS);
+        if (cc_tasks[i].pending) { have_work = 1; break; }
+    }
+    if (!have_work)
+        __bis_SR_register(LPM0_bits | GIE);     // the compare ISR wakes us
+    __enable_interrupt();
+
+    for (i = 0; i < cc_count; i++)
+    {
+        ccsched_task_t *t = &cc_tasks[i];
+        uint16_t run_cnt, late;
+
+        WCET_LOOP_BOUND(CCSCHED_MAX_TASKS);
+        __disable_interrupt();
+        run_cnt = t->pending;
+        t->pending = 0;
+        late = (uint16_t)(CCSCHED_NOW() - t->release);
+        __enable_interrupt();
+
+        if (!run_cnt) continue;
+        if (late > t->max_late) t->max_late = late;
+        while (run_cnt--) t->fn();
+    }
+}
+
+const ccsched_task_t *CcSched_GetTask(uint8_t idx)
+{
+    return (idx < cc_count) ? &cc_tasks[idx] : NULL;
+}
@@ -0,0 +1,90 @@
+/**
+ * @file ccsched.h
+ * @brief Tickless task releases: one Timer_B0 compare channel (CCR1-CCR6) per task.
+ *
+ * - TB0 runs continuously from SMCLK/8 (the TA0 count rate); task i owns CCR(i + 1),
+ *   which holds the count of its next release
+ * - The application owns the TIMER0_B1 ISR and calls CcSched_Isr(TB0IV) from it: each
+ *   interrupt is one release of one task, there is no periodic tick to count
+ * - A period longer than 0xF000 counts (61 ms at 8 MHz) is reached in hops; only the
+ *   last hop releases the task
+ * - CcSched_Dispatch() sleeps in LPM0 until a release, then runs the released tasks in
+ *   channel order (CCR1 first, as TB0IV reports it), coalescing missed runs
+ * - TB0 is used in continuous mode: not together with the high-rate tier (hirate.h),
+ *   which runs it in up mode
+ * - Task i is released at offset_us + k * period_us, k >= 1, after CcSched_Start()
+ */
+
+#ifndef CCSCHED_H
+#define CCSCHED_H
+
+#include <stdint.h>
+
+#define CCSCHED_MAX_TASKS   6       // TB0 CCR1-CCR6
+#define CCSCHED_MIN_COUNTS  64u     // shortest period, so the ISR re-arms in time
+
+/**
+ * @typedef ccsched_fn_t
+ * @brief Task prototype, called from CcSched_Dispatch() with GIE set.
+ */
+typedef void (*ccsched_fn_t)(void);
+
+/**
+ * @struct ccsched_task_t
+ * @brief Task descriptor (one per compare channel).
+ */
+typedef struct {
+    ccsched_fn_t fn;              /**< Task function */
+    uint32_t     period;          /**< Period in TB0 counts */
+    uint32_t     left;            /**< Counts after the armed compare until the release */
+    uint16_t     release;         /**< TB0R of the last release (ISR only) */
+    uint16_t     max_late;        /**< Worst dispatch after the latest release, in counts */
+    uint16_t     late_arms;       /**< Compares already passed when armed (forced) */
+    volatile uint16_t pending;    /**< Releases not yet run */
+} ccsched_task_t;
+
+/**
+ * @brief Clear the task table and stop TB0.
+ */
+void CcSched_Init(void);
+
+/**
+ * @brief Register a task on the next free compare channel. Call before CcSched_Start().
+ *
+ * @param fn Task function.
+ * @param period_us Period in us, a whole number of TB0 counts (1 us at 8 MHz, 8 us at
+ *                  1 MHz) and at least CCSCHED_MIN_COUNTS counts.
+ * @param offset_us Phase offset of the first release, a whole number of counts.
+ * @return Task index (channel - 1), or -1 on bad arguments or a full table.
+ */
+int CcSched_AddTask(ccsched_fn_t fn, uint32_t period_us, uint32_t offset_us);
+
+/**
+ * @brief Arm every channel from count 0 and start TB0 in continuous mode.
+ */
+void CcSched_Start(void);
+
+/**
+ * @brief Handle one compare interrupt. Call from the TIMER0_B1 ISR with TB0IV.
+ *
+ * @return 1 if a task was released (wake the main loop), 0 for an intermediate hop,
+ *         a flag that is not a compare of a registered task, or a stale flag.
+ */
+uint8_t CcSched_Isr(uint16_t tbiv);
+
+/**
+ * @brief Sleep until a release, then run every released task once per release.
+ */
+void CcSched_Dispatch(void);
+
+/**
+ * @brief Task descriptor by index, or NULL.
+ */
+const ccsched_task_t *CcSched_GetTask(uint8_t idx);
+
+/**
+ * @brief TB0 counts per ms (SMCLK / 8000).
+ */
+uint16_t CcSched_CountsPerMs(void);
+
+#endif /* CCSCHED_H */
@@ -0,0 +1,82 @@
+/**
+ * @file clock.c
+ * @brief Clock system (CS) setup for MSP430FR5994.
+ */
+
+#include <msp430.h>
+#include "clock.h"
+
+static ClockSpeed_t systemClock = CLK_1MHZ;
+
+void Clk_Init(ClockSpeed_t speed)
+{
+    systemClock = speed;
+
+    /* FRAM runs at 8 MHz max without wait states */
+    if (speed == CLK_16MHZ)
+    {
+        FRCTL0 = FRCTLPW | NWAITS_1;
+    }
+
+    CSCTL0_H = CSKEY >> 8;                       // Unlock CS registers
+    switch (speed)
+    {
+        case CLK_8MHZ:
+            CSCTL1 = DCOFSEL_6;                  // DCO = 8 MHz
+            break;
+        case CLK_16MHZ:
+            CSCTL1 = DCORSEL | DCOFSEL_4;        // DCO = 16 MHz
+            break;
+        case CLK_1MHZ:
+        default:
+            systemClock = CLK_1MHZ;
+            CSCTL1 = DCOFSEL_0;                  // DCO = 1 MHz
+            break;
+    }
+    CSCTL2 = SELA__VLOCLK | SELS__DCOCLK | SELM__DCOCLK;
+    CSCTL3 = DIVA__1 | DIVS__1 | DIVM__1;        // No dividers
+    CSCTL0_H = 0;                                // Lock CS registers
+
+    if (speed != CLK_16MHZ)
+    {
+        FRCTL0 = FRCTLPW | NWAITS_0;
+    }
+
+    __delay_cycles(10000);  // Wait for clock set
+}
+
+ClockSpeed_t Clk_GetSpeed(void)
+{
+    return systemClock;
+}
+
+uint32_t Clk_GetHz(void)
+{
+    switch (systemClock)
+    {
+        case CLK_8MHZ:  return 8000000UL;
+        case CLK_16MHZ: return 16000000UL;
+        case CLK_1MHZ:
+        default:        return 1000000UL;
+    }
+}
+
+void Delay_ms(uint16_t ms)
+{
+    while (ms--)
+    {
+        switch (systemClock)
+        {
+            case CLK_8MHZ:
+                __delay_cycles(8000);
+                break;
+            case CLK_16MHZ:
+                __delay_cycles(16000);
+                break;
+            case CLK_1MHZ:
+            default:
+                __delay_cycles(1000);
+                break;
+        }
+    }
+}
@@ -0,0 +1,45 @@
+/**
+ * @file clock.h
+ * @brief Clock system (CS) setup for MSP430FR5994.
+ *
+ * - DCO drives MCLK and SMCLK, VLO drives ACLK
+ * - 16 MHz needs one FRAM wait state, set before the DCO is raised
+ */
+
+#ifndef CLOCK_H
+#define CLOCK_H
+
+#include <stdint.h>
+
+typedef enum {
+    CLK_1MHZ,
+    CLK_8MHZ,
+    CLK_16MHZ,
+    CLK_SPEEDS          // number of speeds
+} ClockSpeed_t;
+
+/**
+ * @brief Configure DCO/MCLK/SMCLK for the requested speed.
+ *
+ * @param speed Target clock speed.
+ */
+void Clk_Init(ClockSpeed_t speed);
+
+/**
+ * @brief Speed set by the last Clk_Init().
+ */
+ClockSpeed_t Clk_GetSpeed(void);
+
+/**
+ * @brief Current MCLK/SMCLK frequency in Hz.
+ */
+uint32_t Clk_GetHz(void);
+
+/**
+ * @brief Busy-wait for a number of milliseconds at the current clock speed.
+ *
+ * @param ms Delay in milliseconds.
+ */
+void Delay_ms(uint16_t ms);
+
+#endif /* CLOCK_H */
@@ -0,0 +1,137 @@
+/**
+ * @file defer.c
+ * @brief Deferred interrupt work (bottom halves): ISRs post, the main loop runs.
+ *
+ * Key patterns:
+ * - Single-consumer rings with free-running 8-bit indices: head is written only by
+ *   producers (ISRs), tail only by the main loop, both with one byte store
+ * - An item is copied out before tail advances, so producers never overwrite it
+ * - Timestamps are the low 16 bits of SysTime_Counts() (TA0 counts, SMCLK/8)
+ * - Defer_Post() and Defer_Run() sit on the tick path and run from SRAM (HOT_FN)
+ */
+
+#include <msp430.h>
+#include <stddef.h>
+#include "clock.h"
+#include "systime.h"
+#include "defer.h"
+#include "hot.h"
+
+#define DEFER_MASK (DEFER_QUEUE_LEN - 1u)
+
+#if (DEFER_QUEUE_LEN & DEFER_MASK) != 0 || DEFER_QUEUE_LEN > 128
+#error DEFER_QUEUE_LEN must be a power of two <= 128
+#endif
+
+typedef struct {
+    defer_fn_t fn;
+    uintptr_t  arg;
+    uint16_t   stamp;         // defer_clock() at post
+} defer_item_t;
+
+typedef struct {
+    defer_item_t     item[DEFER_QUEUE_LEN];
+    volatile uint8_t head;    // next free slot (producers)
+    volatile uint8_t tail;    // next item to run (main loop)
+} defer_ring_t;
+
+static defer_ring_t rings[DEFER_PRIOS];
+static defer_stats_t defer_stats;
+
+/* TA0 counts (SMCLK/8) since start-up, modulo 2^16 */
+static inline uint16_t defer_clock(void)
+{
+    return (uint16_t)SysTime_Counts();
+}
+
+void Defer_Init(void)
+{
+    uint8_t p;
+
+    for (p = 0; p < DEFER_PRIOS; p++)
+    {
+        rings[p].head = 0;
+        rings[p].tail = 0;
+    }
+    defer_stats.posted = 0;
+    defer_stats.run = 0;
+    defer_stats.dropped = 0;
+    defer_stats.max_depth = 0;
+    defer_stats.max_latency = 0;
+    defer_stats.total_latency = 0;
+}
+
+HOT_FN int Defer_Post(uint8_t prio, defer_fn_t fn, uintptr_t arg)
+{
+    defer_ring_t *r;
+    uint8_t head, depth;
+
+    if (!fn || prio >= DEFER_PRIOS) return -1;
+    r = &rings[prio];
+    head = r->head;
+    depth = (uint8_t)(head - r->tail);
+    if (depth >= DEFER_QUEUE_LEN)
+    {
+        defer_stats.dropped++;
+        return -1;
+    }
+
+    r->item[head & DEFER_MASK].fn = fn;
+    r->item[head & DEFER_MASK].arg = arg;
+    r->item[head & DEFER_MASK].stamp = defer_clock();
+    r->head = (uint8_t)(head + 1u);       // publish
+
+    defer_stats.posted++;
+    if (depth + 1u > defer_stats.max_depth) defer_stats.max_depth = depth + 1u;
+    return 0;
+}
+
+HOT_FN uint16_t Defer_Run(void)
+{
+    uint16_t count = 0;
+    uint8_t p = 0;
+
+    while (p < DEFER_PRIOS)
+    {
+        defer_ring_t *r = &rings[p];
+        defer_item_t it;
+        uint16_t latency;
+
+        if (r->head == r->tail) { p++; continue; }
+
+        it = r->item[r->tail & DEFER_MASK];
+        r->tail = (uint8_t)(r->tail + 1u);  // release the slot
+
+        latency = (uint16_t)(defer_clock() - it.stamp);
+        if (latency > defer_stats.max_latency) defer_stats.max_latency = latency;
+        defer_stats.total_latency += latency;
+        defer_stats.run++;
+
+        it.fn(it.arg);
+        count++;
+        p = 0;                              // higher priority work may have arrived
+    }
+    return count;
+}
+
+uint8_t Defer_Pending(void)
+{
+    uint8_t p;
+
+    for (p = 0; p < DEFER_PRIOS; p++)
+    {
+        if (rings[p].head != rings[p].tail) return 1;
+    }
+    return 0;
+}
+
+const defer_stats_t *Defer_GetStats(void)
+{
+    return &defer_stats;
+}
+
+uint32_t Defer_MaxLatencyUs(void)
+{
+    /* one count = 8 SMCLK cycles */
+    return (uint32_t)defer_stats.max_latency * 8u / (Clk_GetHz() / 1000000u);
+}
@@ -0,0 +1,88 @@
+/**
+ * @file defer.h
+ * @brief Deferred interrupt work (bottom halves): ISRs post, the main loop runs.
+ *
+ * - Defer_Post() from an ISR queues fn(arg) in a lock-free ring, one ring per priority;
+ *   O(1) with no loops, so ISRs keep a fixed cycle cost however much work they hand off
+ * - Scheduler_Dispatch() runs queued work before going to sleep and before every
+ *   periodic task, highest priority first (Defer_Run())
+ * - Latency from post to start is measured on the TA0 time base (systime.h) and
+ *   exported with Defer_GetStats()
+ */
+
+#ifndef DEFER_H
+#define DEFER_H
+
+#include <stdint.h>
+
+#define DEFER_PRIOS       3   // 0 = highest
+#define DEFER_QUEUE_LEN   8   // items per priority, power of two
+
+#define DEFER_PRIO_HIGH   0
+#define DEFER_PRIO_NORMAL 1
+#define DEFER_PRIO_LOW    2
+
+/**
+ * @typedef defer_fn_t
+ * @brief Deferred work prototype, called from the main loop with GIE set.
+ * @param arg Value given to Defer_Post(): an integer or a pointer (e.g. a pool block).
+ */
+typedef void (*defer_fn_t)(uintptr_t arg);
+
+/**
+ * @struct defer_stats_t
+ * @brief Counters since start-up. Latencies are in TA0 counts (SMCLK/8).
+ */
+typedef struct {
+    uint32_t posted;              /**< Items queued */
+    uint32_t run;                 /**< Items executed */
+    uint16_t dropped;             /**< Defer_Post() calls rejected on a full ring */
+    uint8_t  max_depth;           /**< Deepest ring occupancy seen by Defer_Post() */
+    uint16_t max_latency;         /**< Worst post-to-start delay */
+    uint32_t total_latency;       /**< Sum of post-to-start delays (mean = total / run) */
+} defer_stats_t;
+
+/**
+ * @brief Empty all rings and clear the counters. Call before enabling interrupts.
+ */
+void Defer_Init(void);
+
+/**
+ * @brief Queue fn(arg) at a priority. Call from ISRs, or from main with GIE clear.
+ *
+ * A ring has one consumer (the main loop) and its producers never preempt each other
+ * (MSP430 ISRs do not nest unless GIE is set in an ISR), so no lock is needed.
+ *
+ * @param prio DEFER_PRIO_HIGH .. DEFER_PRIOS-1.
+ * @param fn Work function.
+ * @param arg Argument passed to fn.
+ * @return 0 on success, -1 if the ring is full or the arguments are invalid.
+ */
+int Defer_Post(uint8_t prio, defer_fn_t fn, uintptr_t arg);
+
+/**
+ * @brief Run queued work, highest priority first, until all rings are empty.
+ *
+ * Items posted while running are picked up in the same call, so the caller can sleep
+ * right after it returns once the rings are checked with GIE clear (Defer_Pending()).
+ *
+ * @return Number of items run.
+ */
+uint16_t Defer_Run(void);
+
+/**
+ * @brief Non-zero if any ring holds work (call with GIE clear before entering LPM).
+ */
+uint8_t Defer_Pending(void);
+
+/**
+ * @brief Counters since start-up.
+ */
+const defer_stats_t *Defer_GetStats(void);
+
+/**
+ * @brief Worst post-to-start latency converted to microseconds at the current clock.
+ */
+uint32_t Defer_MaxLatencyUs(void);
+
+#endif /* DEFER_H */
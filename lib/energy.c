@@ -0,0 +1,151 @@
+/**
+ * @file energy.c
+ * @brief Energy-per-task accounting from measured active and LPM intervals.
+ *
+ * Key patterns:
+ * - Accounting only adds cycles; the current model is applied when a figure is read,
+ *   so changing the model re-prices the whole history
+ * - Accounts are split per clock speed because active and LPM0/1 currents scale with
+ *   the DCO setting
+ * - ENERGY_CYCLES() is the stamp source; the host build (host/energy.c) overrides it
+ *   with the simulator's cycle counter
+ */
+
+#include <msp430.h>
+#include <stddef.h>
+#include "clock.h"
+#include "systime.h"
+#include "energy.h"
+
+#ifndef ENERGY_CYCLES
+#define ENERGY_CYCLES() (SysTime_Counts() << 3)   // TA0 runs from SMCLK/8
+#endif
+
+#define OVERHEAD ENERGY_MAX_TASKS
+
+/*                                  1 MHz     8 MHz     16 MHz */
+const energy_model_t energy_model_fr5994 = {
+    3000,
+    {                                220000,  1020000,  2150000 },
+    {
+        /* LPM0    LPM1    LPM2  LPM3  LPM4 */
+        {   80000,  40000,  700,  500,  350 },  // 1 MHz
+        {  170000, 110000,  700,  500,  350 },  // 8 MHz
+        {  280000, 200000,  700,  500,  350 },  // 16 MHz
+    },
+};
+
+static const uint8_t clk_mhz[CLK_SPEEDS] = { 1, 8, 16 };
+
+static const energy_model_t *model = &energy_model_fr5994;
+static uint64_t task_cycles[ENERGY_MAX_TASKS + 1][CLK_SPEEDS];
+static uint64_t sleep_cycles[CLK_SPEEDS][ENERGY_LPM_LEVELS];
+static uint32_t last_end;           // end of the last accounted interval
+static uint16_t wake_cycles = 0;    // ISR that ends each LPM interval, charged as overhead
+
+void Energy_Init(const energy_model_t *m)
+{
+    uint8_t i, j;
+
+    model = m ? m : &energy_model_fr5994;
+    for (i = 0; i < CLK_SPEEDS; i++)
+    {
+        for (j = 0; j <= ENERGY_MAX_TASKS; j++) task_cycles[j][i] = 0;
+        for (j = 0; j < ENERGY_LPM_LEVELS; j++) sleep_cycles[i][j] = 0;
+    }
+    last_end = ENERGY_CYCLES();
+}
+
+uint32_t Energy_Stamp(void)
+{
+    return ENERGY_CYCLES();
+}
+
+/* Time between the previous interval and this one: ISRs, dispatch, deferred work */
+static uint32_t close_interval(uint32_t start, ClockSpeed_t clk)
+{
+    uint32_t now = ENERGY_CYCLES();
+
+    if ((int32_t)(start - last_end) > 0)
+        task_cycles[OVERHEAD][clk] += start - last_end;
+    last_end = now;
+    return now - start;
+}
+
+void Energy_EndTask(uint8_t task, uint32_t start)
+{
+    ClockSpeed_t clk = Clk_GetSpeed();
+
+    if (task > OVERHEAD) task = OVERHEAD;
+    task_cycles[task][clk] += close_interval(start, clk);
+}
+
+void Energy_EndSleep(EnergyLpm_t lpm, uint32_t start)
+{
+    ClockSpeed_t clk = Clk_GetSpeed();
+    uint32_t cycles;
+
+    if (lpm >= ENERGY_LPM_LEVELS) lpm = ENERGY_LPM0;
+    cycles = close_interval(start, clk);
+    if (cycles > wake_cycles)
+    {
+        cycles -= wake_cycles;
+        task_cycles[OVERHEAD][clk] += wake_cycles;
+    }
+    sleep_cycles[clk][lpm] += cycles;
+}
+
+void Energy_SetWakeCycles(uint16_t cycles)
+{
+    wake_cycles = cycles;
+}
+
+/* nJ = I[nA] * t[us] * U[mV] / 1e12, split to stay within 64 bits */
+static uint64_t nanojoules(uint64_t cycles, ClockSpeed_t clk, uint32_t na)
+{
+    uint64_t us = cycles / clk_mhz[clk];
+    uint64_t pc = (us / 1000u) * na + (us % 1000u) * na / 1000u;      // pC
+
+    return (pc / 1000u) * model->supply_mv / 1000u +
+           (pc % 1000u) * model->supply_mv / 1000000u;
+}
+
+uint64_t Energy_TaskNanojoules(uint8_t task)
+{
+    uint64_t nj = 0;
+    uint8_t clk;
+
+    if (task > OVERHEAD) return 0;
+    for (clk = 0; clk < CLK_SPEEDS; clk++)
+        nj += nanojoules(task_cycles[task][clk], (ClockSpeed_t)clk, model->active_na[clk]);
+    return nj;
+}
+
+uint64_t Energy_SleepNanojoules(void)
+{
+    uint64_t nj = 0;
+    uint8_t clk, lpm;
+
+    for (clk = 0; clk < CLK_SPEEDS; clk++)
+        for (lpm = 0; lpm < ENERGY_LPM_LEVELS; lpm++)
+            nj += nanojoules(sleep_cycles[clk][lpm], (ClockSpeed_t)clk, model->lpm_na[clk][lpm]);
+    return nj;
+}
+
+uint64_t Energy_ElapsedUs(void)
+{
+    uint64_t us = 0;
+    uint8_t clk, i;
+
+    for (clk = 0; clk < CLK_SPEEDS; clk++)
+    {
+        for (i = 0; i <= OVERHEAD; i++) us += task_cycles[i][clk] / clk_mhz[clk];
+        for (i = 0; i < ENERGY_LPM_LEVELS; i++) us += sleep_cycles[clk][i] / clk_mhz[clk];
+    }
+    return us;
+}
+
+uint64_t Energy_TaskCycles(uint8_t task, ClockSpeed_t speed)
+{
+    return (task <= OVERHEAD && speed < CLK_SPEEDS) ? task_cycles[task][speed] : 0;
+}
@@ -0,0 +1,96 @@
+/**
+ * @file energy.h
+ * @brief Energy-per-task accounting from measured active and LPM intervals.
+ *
+ * - Scheduler_Dispatch() stamps every task run and every LPM interval
+ *   (Energy_Stamp() / Energy_EndTask() / Energy_EndSleep())
+ * - Cycles are accumulated per task, per clock speed and per LPM level; time between
+ *   intervals (ISRs, dispatch) is charged to an overhead account
+ * - An energy_model_t gives the supply current per clock speed in active mode and in
+ *   each LPM; energy is only computed when read, so accounting costs two stamps and
+ *   one 64-bit add per interval
+ * - The same code runs on the host simulator (host/energy.c) to predict battery life
+ */
+
+#ifndef ENERGY_H
+#define ENERGY_H
+
+#include <stdint.h>
+#include "clock.h"
+
+#define ENERGY_MAX_TASKS  8   // accounts, one per scheduler task (MAX_TASKS)
+
+typedef enum {
+    ENERGY_LPM0,
+    ENERGY_LPM1,
+    ENERGY_LPM2,
+    ENERGY_LPM3,
+    ENERGY_LPM4,
+    ENERGY_LPM_LEVELS
+} EnergyLpm_t;
+
+/**
+ * @struct energy_model_t
+ * @brief Supply currents in nA at supply_mv, per clock speed (ClockSpeed_t).
+ */
+typedef struct {
+    uint16_t supply_mv;                                 /**< Supply voltage */
+    uint32_t active_na[CLK_SPEEDS];                     /**< Active mode, code in FRAM */
+    uint32_t lpm_na[CLK_SPEEDS][ENERGY_LPM_LEVELS];     /**< CPU off, per LPM level */
+} energy_model_t;
+
+/**
+ * @brief Typical MSP430FR5994 figures at 3 V, 25 C (datasheet order of magnitude).
+ *
+ * Replace with currents measured on the board for budgeting.
+ */
+extern const energy_model_t energy_model_fr5994;
+
+/**
+ * @brief Clear all accounts and select the current model (NULL = energy_model_fr5994).
+ */
+void Energy_Init(const energy_model_t *model);
+
+/**
+ * @brief MCLK cycles since start-up, modulo 2^32 (SysTime_Counts() * 8).
+ */
+uint32_t Energy_Stamp(void);
+
+/**
+ * @brief Charge the interval since start to task, at the current clock speed.
+ */
+void Energy_EndTask(uint8_t task, uint32_t start);
+
+/**
+ * @brief Charge the interval since start to an LPM level, at the current clock speed.
+ */
+void Energy_EndSleep(EnergyLpm_t lpm, uint32_t start);
+
+/**
+ * @brief Cycles of the ISR that ends each LPM interval (e.g. the tick ISR bound from
+ *        tools/wcet.py). They are moved from the LPM account to overhead, since the
+ *        CPU is active while the waking ISR runs.
+ */
+void Energy_SetWakeCycles(uint16_t cycles);
+
+/**
+ * @brief Energy in nJ of task (ENERGY_MAX_TASKS = overhead), computed from the model.
+ */
+uint64_t Energy_TaskNanojoules(uint8_t task);
+
+/**
+ * @brief Energy in nJ spent in LPM.
+ */
+uint64_t Energy_SleepNanojoules(void);
+
+/**
+ * @brief Accounted time in us: tasks, overhead and sleep.
+ */
+uint64_t Energy_ElapsedUs(void);
+
+/**
+ * @brief Accounted cycles of task (ENERGY_MAX_TASKS = overhead) at one clock speed.
+ */
+uint64_t Energy_TaskCycles(uint8_t task, ClockSpeed_t speed);
+
+#endif /* ENERGY_H */
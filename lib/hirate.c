@@ -0,0 +1,96 @@
+/**
+ * @file hirate.c
+ * @brief High-rate task tier on Timer_B0 CCR0 (sub-millisecond periods).
+ *
+ * Key patterns:
+ * - Admission control instead of run-time policing: the reserved budget is checked
+ *   once per task in HiRate_AddTask(), the ISR only counts overruns
+ * - TB0 counts MCLK cycles from the CCR0 match, so TB0R at the end of the ISR is the
+ *   tick's full occupancy (interrupt latency included) for one register read
+ */
+
+#include <msp430.h>
+#include <stddef.h>
+#include "clock.h"
+#include "hirate.h"
+#include "wcet.h"
+
+static hirate_task_t hr_tasks[HIRATE_MAX_TASKS];
+static uint8_t hr_count = 0;
+static uint16_t hr_budget = 0;      // reserved cycles per tick, 0 = not initialised
+static uint16_t hr_demand = HIRATE_ISR_OVERHEAD_CYCLES;
+static hirate_stats_t hr_stats;
+
+int HiRate_Init(uint16_t rate_hz)
+{
+    uint32_t period;
+
+    if (rate_hz == 0) return -1;
+    period = Clk_GetHz() / rate_hz;
+    if (period == 0 || period > 0x10000UL) return -1;
+
+    hr_budget = (uint16_t)(period * HIRATE_BUDGET_PCT / 100u);
+    hr_stats.ticks = 0;
+    hr_stats.max_cycles = 0;
+    hr_stats.overruns = 0;
+
+    /* SMCLK = MCLK, no divider: 8 MHz / 4 kHz -> 1999 */
+    TB0CTL   = MC__STOP | TBCLR;
+    TB0CCR0  = (uint16_t)(period - 1u);
+    TB0CCTL0 = CCIE;
+    TB0CTL   = TBSSEL__SMCLK | ID__1 | MC__UP | TBCLR;
+    return 0;
+}
+
+int HiRate_AddTask(hirate_fn_t fn, uint16_t divider, uint16_t wcet_cycles)
+{
+    uint32_t demand = (uint32_t)hr_demand + wcet_cycles;
+
+    if (!fn || divider == 0 || hr_count >= HIRATE_MAX_TASKS) return -1;
+    /* Worst tick: every task released at once (dividers share tick 0) */
+    if (hr_budget == 0 || demand > hr_budget) return -1;
+
+    hr_tasks[hr_count].fn = fn;
+    hr_tasks[hr_count].divider = divider;
+    hr_tasks[hr_count].countdown = divider;
+    hr_tasks[hr_count].wcet_cycles = wcet_cycles;
+    hr_count++;
+    hr_demand = (uint16_t)demand;
+    return 0;
+}
+
+void HiRate_Tick(void)
+{
+    uint16_t elapsed;
+    uint8_t i;
+
+    for (i = 0; i < hr_count; i++)
+    {
+        WCET_LOOP_BOUND(HIRATE_MAX_TASKS);
+        if (--hr_tasks[i].countdown == 0)
+        {
+            hr_tasks[i].countdown = hr_tasks[i].divider;
+            hr_tasks[i].fn();
+        }
+    }
+
+    elapsed = TB0R;
+    hr_stats.ticks++;
+    if (elapsed > hr_stats.max_cycles) hr_stats.max_cycles = elapsed;
+    if (elapsed > hr_budget) hr_stats.overruns++;
+}
+
+uint16_t HiRate_BudgetCycles(void)
+{
+    return hr_budget;
+}
+
+uint16_t HiRate_DemandCycles(void)
+{
+    return hr_demand;
+}
+
+const hirate_stats_t *HiRate_GetStats(void)
+{
+    return &hr_stats;
+}
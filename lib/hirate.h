@@ -0,0 +1,88 @@
+/**
+ * @file hirate.h
+ * @brief High-rate task tier on Timer_B0 CCR0 (sub-millisecond periods).
+ *
+ * - HiRate_Init() programs TB0 for an up-mode tick at rate_hz from SMCLK (no divider)
+ * - The application owns the TIMER0_B0 ISR and calls HiRate_Tick() from it;
+ *   tasks run inside the ISR, so they must be short and must not sleep
+ * - HIRATE_BUDGET_PCT of every tick is reserved for the tier; HiRate_AddTask()
+ *   rejects a task if the worst tick (all tasks released together) would exceed it
+ * - The 1 ms tier (systime.h, scheduler.h) keeps TA0 and sees at most the reserved
+ *   share as interference
+ */
+
+#ifndef HIRATE_H
+#define HIRATE_H
+
+#include <stdint.h>
+
+#define HIRATE_MAX_TASKS            4
+#define HIRATE_BUDGET_PCT           25  // share of each tick reserved for the tier
+#define HIRATE_ISR_OVERHEAD_CYCLES  60  // entry/exit, task loop and measurement
+
+/**
+ * @typedef hirate_fn_t
+ * @brief High-rate task prototype, called from the TIMER0_B0 ISR with GIE clear.
+ */
+typedef void (*hirate_fn_t)(void);
+
+/**
+ * @struct hirate_task_t
+ * @brief High-rate task descriptor.
+ */
+typedef struct {
+    hirate_fn_t fn;               /**< Task function */
+    uint16_t    divider;          /**< Runs every divider ticks (1 = every tick) */
+    uint16_t    countdown;        /**< Ticks until next run (ISR only) */
+    uint16_t    wcet_cycles;      /**< Declared worst-case execution time */
+} hirate_task_t;
+
+/**
+ * @struct hirate_stats_t
+ * @brief Measured ISR occupancy (TB0R at the end of the ISR, in MCLK cycles).
+ */
+typedef struct {
+    uint32_t ticks;               /**< ISR executions */
+    uint16_t max_cycles;          /**< Worst tick: latency + tasks */
+    uint16_t overruns;            /**< Ticks that exceeded the reserved budget */
+} hirate_stats_t;
+
+/**
+ * @brief Program TB0 CCR0 for a rate_hz tick at the current SMCLK (see Clk_Init()).
+ *
+ * @param rate_hz Tick rate, e.g. 4000 for a 250 us period.
+ * @return 0 on success, -1 if the rate is 0 or not reachable with a 16-bit CCR0.
+ */
+int HiRate_Init(uint16_t rate_hz);
+
+/**
+ * @brief Register a high-rate task. Call after HiRate_Init(), before enabling GIE.
+ *
+ * @param fn Task function.
+ * @param divider Run every divider ticks (>0).
+ * @param wcet_cycles Worst-case cycles of fn (e.g. from tools/wcet.py).
+ * @return 0 on success, -1 on bad arguments, full table or exceeded CPU budget.
+ */
+int HiRate_AddTask(hirate_fn_t fn, uint16_t divider, uint16_t wcet_cycles);
+
+/**
+ * @brief Run due tasks and record ISR occupancy. Call from the TIMER0_B0 ISR.
+ */
+void HiRate_Tick(void);
+
+/**
+ * @brief Reserved cycles per tick (HIRATE_BUDGET_PCT of the tick period).
+ */
+uint16_t HiRate_BudgetCycles(void);
+
+/**
+ * @brief Worst-tick demand of the registered tasks in cycles, including overhead.
+ */
+uint16_t HiRate_DemandCycles(void);
+
+/**
+ * @brief Measured occupancy since HiRate_Init().
+ */
+const hirate_stats_t *HiRate_GetStats(void);
+
+#endif /* HIRATE_H */
@@ -0,0 +1,35 @@
+/**
+ * @file hot.h
+ * @brief Run hot code (tick ISR, dispatch loop) from SRAM instead of FRAM.
+ *
+ * - At 16 MHz FRAM needs one wait state (NWAITS = 1), paid on every FRAM cache miss;
+ *   SRAM is always zero-wait. Up to 8 MHz FRAM runs without wait states
+ * - HOT_FN places a function in .data.hot: the stock linker script collects .data.*
+ *   into .data (load address in FRAM, run address in SRAM) and crt0 copies it before
+ *   main(), so call sites and the vector table need no changes
+ * - HOT_FN implies noinline, so the function cannot be folded back into a FRAM caller
+ * - Build with HOT=0 to leave everything in FRAM; tools/cycles.py reports where each
+ *   function landed and its straight-line cycles at 16 MHz from FRAM and from SRAM
+ */
+
+#ifndef HOT_H
+#define HOT_H
+
+#ifndef HOT_IN_SRAM
+#define HOT_IN_SRAM 1
+#endif
+
+#if defined(__GNUC__) && defined(__MSP430__) && HOT_IN_SRAM
+
+#define HOT_FN __attribute__((section(".data.hot"), noinline))
+
+/* .data.hot may be the only initialized data: make sure crt0 links its copy loop */
+__asm__ ("\t.global __crt0_movedata\n");
+
+#else
+
+#define HOT_FN
+
+#endif
+
+#endif /* HOT_H */
@@ -0,0 +1,126 @@
+/**
+ * @file pool.c
+ * @brief O(1) fixed-block memory pools with size classes, safe from ISRs.
+ *
+ * Key patterns:
+ * - MSP430 has no compare-and-swap, so the free-list pop/push runs with GIE briefly
+ *   cleared (a handful of instructions, interrupt state restored, so no lock to hold)
+ * - Untouched storage is handed out through a bump pointer before the free list is
+ *   populated: init is O(1) and FRAM storage needs no start-up writes
+ * - Classes are kept sorted by block size; Pool_Free() finds the owner by address
+ */
+
+#include <msp430.h>
+#include <stddef.h>
+#include "pool.h"
+#include "wcet.h"
+
+static pool_t *classes[POOL_MAX_CLASSES];
+static uint8_t class_count = 0;
+
+void Pool_Reset(pool_t *p)
+{
+    uint16_t sr = __get_interrupt_state();
+
+    __disable_interrupt();
+    p->free = NULL;
+    p->fresh = p->start;
+    p->used = 0;
+    p->high_water = 0;
+    p->exhausted = 0;
+    __set_interrupt_state(sr);
+}
+
+void *Pool_Get(pool_t *p)
+{
+    uint16_t sr = __get_interrupt_state();
+    pool_block_t *blk;
+
+    __disable_interrupt();
+    blk = p->free;
+    if (blk)
+    {
+        p->free = blk->next;
+    }
+    else if (p->fresh < p->end)
+    {
+        blk = (pool_block_t *)p->fresh;
+        p->fresh += p->block_size;
+    }
+
+    if (blk)
+    {
+        if (++p->used > p->high_water) p->high_water = p->used;
+    }
+    else
+    {
+        p->exhausted++;
+    }
+    __set_interrupt_state(sr);
+    return blk;
+}
+
+void Pool_Put(pool_t *p, void *blk)
+{
+    uint16_t sr = __get_interrupt_state();
+
+    __disable_interrupt();
+    ((pool_block_t *)blk)->next = p->free;
+    p->free = (pool_block_t *)blk;
+    p->used--;
+    __set_interrupt_state(sr);
+}
+
+uint8_t Pool_Owns(const pool_t *p, const void *blk)
+{
+    return (const uint8_t *)blk >= p->start && (const uint8_t *)blk < p->end;
+}
+
+int Pool_AddClass(pool_t *p)
+{
+    uint8_t i;
+
+    if (!p || class_count >= POOL_MAX_CLASSES) return -1;
+
+    /* insertion sort by block size */
+    i = class_count++;
+    while (i > 0 && classes[i - 1]->block_size > p->block_size)
+    {
+        classes[i] = classes[i - 1];
+        i--;
+    }
+    classes[i] = p;
+    return 0;
+}
+
+void *Pool_Alloc(uint16_t size)
+{
+    uint8_t i;
+
+    for (i = 0; i < class_count; i++)
+    {
+        WCET_LOOP_BOUND(POOL_MAX_CLASSES);
+        if (classes[i]->block_size >= size)
+        {
+            void *blk = Pool_Get(classes[i]);
+            if (blk) return blk;
+        }
+    }
+    return NULL;
+}
+
+void Pool_Free(void *blk)
+{
+    uint8_t i;
+
+    if (!blk) return;
+    for (i = 0; i < class_count; i++)
+    {
+        WCET_LOOP_BOUND(POOL_MAX_CLASSES);
+        if (Pool_Owns(classes[i], blk))
+        {
+            Pool_Put(classes[i], blk);
+            return;
+        }
+    }
+}
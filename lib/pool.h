@@ -0,0 +1,119 @@
+/**
+ * @file pool.h
+ * @brief O(1) fixed-block memory pools with size classes, safe from ISRs.
+ *
+ * - POOL_DEFINE() / POOL_DEFINE_FRAM() create a pool with static storage in SRAM or
+ *   FRAM (.persistent); no init loop, blocks are carved from the storage on first use
+ * - Pool_Get()/Pool_Put() pop/push a LIFO free list in a few-instruction critical
+ *   section, so they are constant-time and callable from ISRs and the main loop
+ * - Pool_AddClass() registers pools as size classes for Pool_Alloc(size)/Pool_Free()
+ * - Each pool counts blocks in use, the high-water mark and failed allocations
+ */
+
+#ifndef POOL_H
+#define POOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define POOL_MAX_CLASSES  4   // size classes searched by Pool_Alloc()
+
+/* Block size actually used: room for the free-list link, rounded up to a word */
+#define POOL_BLOCK_SIZE(size) \
+    ((((size) < sizeof(void *) ? sizeof(void *) : (size)) + 1u) & ~(size_t)1u)
+
+/* FRAM storage keeps its contents over reset; pools re-initialise the free list anyway */
+#if defined(__GNUC__) && defined(__MSP430__)
+#define POOL_FRAM_ATTR __attribute__((section(".persistent")))
+#else
+#define POOL_FRAM_ATTR
+#endif
+
+/* Free blocks hold the link in their first bytes */
+typedef struct pool_block {
+    struct pool_block *next;
+} pool_block_t;
+
+/**
+ * @struct pool_t
+ * @brief One pool of count blocks of block_size bytes. Counters are read-only for users.
+ */
+typedef struct {
+    pool_block_t *free;           /**< Recycled blocks (LIFO) */
+    uint8_t      *fresh;          /**< First block never handed out */
+    uint8_t      *start;          /**< Storage bounds, for Pool_Free() and checks */
+    uint8_t      *end;
+    uint16_t      block_size;     /**< Bytes per block (POOL_BLOCK_SIZE()) */
+    uint16_t      count;          /**< Blocks in the pool */
+    uint16_t      used;           /**< Blocks currently allocated */
+    uint16_t      high_water;     /**< Maximum of used since init */
+    uint16_t      exhausted;      /**< Pool_Get() calls that found no block */
+} pool_t;
+
+#define POOL_STORAGE_WORDS(size, count) ((POOL_BLOCK_SIZE(size) * (count)) / 2u)
+
+#define POOL_INITIALIZER(storage, size, count)                          \
+    { NULL, (uint8_t *)(storage), (uint8_t *)(storage),                 \
+      (uint8_t *)(storage) + POOL_BLOCK_SIZE(size) * (count),           \
+      POOL_BLOCK_SIZE(size), (count), 0, 0, 0 }
+
+/**
+ * @brief Define pool name with count blocks of at least size bytes in SRAM.
+ */
+#define POOL_DEFINE(name, size, count)                                  \
+    static uint16_t name##_storage[POOL_STORAGE_WORDS(size, count)];    \
+    pool_t name = POOL_INITIALIZER(name##_storage, size, count)
+
+/**
+ * @brief Same as POOL_DEFINE() with the storage in FRAM (saves SRAM; at 16 MHz every
+ *        access to a block costs an FRAM wait state).
+ */
+#define POOL_DEFINE_FRAM(name, size, count)                             \
+    static uint16_t name##_storage[POOL_STORAGE_WORDS(size, count)] POOL_FRAM_ATTR; \
+    pool_t name = POOL_INITIALIZER(name##_storage, size, count)
+
+/**
+ * @brief Return every block to the pool and clear the counters.
+ *
+ * Only needed to reuse a pool; POOL_DEFINE() pools start ready.
+ */
+void Pool_Reset(pool_t *p);
+
+/**
+ * @brief Take one block. ISR-safe, constant time.
+ *
+ * @return Block of p->block_size bytes (word aligned), or NULL if the pool is empty.
+ */
+void *Pool_Get(pool_t *p);
+
+/**
+ * @brief Return a block obtained from the same pool. ISR-safe, constant time.
+ */
+void Pool_Put(pool_t *p, void *blk);
+
+/**
+ * @brief Non-zero if blk points into the storage of p.
+ */
+uint8_t Pool_Owns(const pool_t *p, const void *blk);
+
+/**
+ * @brief Register a pool as a size class for Pool_Alloc(). Call before enabling GIE.
+ *
+ * @return 0 on success, -1 if POOL_MAX_CLASSES classes are registered.
+ */
+int Pool_AddClass(pool_t *p);
+
+/**
+ * @brief Allocate from the smallest class of at least size bytes, falling back to
+ *        larger classes when it is exhausted. ISR-safe, bounded by POOL_MAX_CLASSES.
+ *
+ * @return Block or NULL.
+ */
+void *Pool_Alloc(uint16_t size);
+
+/**
+ * @brief Free a block from Pool_Alloc() into the class that owns it (NULL is ignored).
+ */
+void Pool_Free(void *blk);
+
+#endif /* POOL_H */
@@ -0,0 +1,52 @@
+/**
+ * @file ramvec.c
+ * @brief RAM interrupt vector table (SYSRIVECT): rebind ISRs at run time.
+ *
+ * Key patterns:
+ * - The table is a fixed SRAM address, not a C object: the linker script knows nothing
+ *   about it, so defining __stack here overrides the script's PROVIDE() and starts the
+ *   stack below the table (only in images that link this module)
+ * - Entries are 16-bit: interrupt functions live in .lowtext (or SRAM), below 64 KB,
+ *   in both memory models
+ */
+
+#include <msp430.h>
+#include <stddef.h>
+#include "ramvec.h"
+
+#define RAMVEC_RESET   RAMVEC_COUNT
+
+#if defined(__GNUC__) && defined(__MSP430__)
+__asm__ ("\t.global __stack\n"
+         "\t.equ __stack, 0x3B80\n");     // RAMVEC_RAM_BASE
+#endif
+
+static volatile uint16_t *const fram_vec = (volatile uint16_t *)RAMVEC_FRAM_BASE;
+static volatile uint16_t *const ram_vec = (volatile uint16_t *)RAMVEC_RAM_BASE;
+
+void RamVec_Init(void)
+{
+    uint16_t sr = __get_interrupt_state();
+    uint8_t i;
+
+    __disable_interrupt();
+    for (i = 0; i < RAMVEC_COUNT; i++)
+        ram_vec[i] = fram_vec[i];
+    SYSCTL |= SYSRIVECT;
+    __set_interrupt_state(sr);
+}
+
+int RamVec_Set(uint8_t vector, ramvec_isr_t isr)
+{
+    uintptr_t addr = (uintptr_t)isr;
+
+    if (vector == 0 || vector >= RAMVEC_RESET || !isr || addr > 0xFFFFu) return -1;
+    ram_vec[vector - 1u] = (uint16_t)addr;
+    return 0;
+}
+
+ramvec_isr_t RamVec_Get(uint8_t vector)
+{
+    if (vector == 0 || vector > RAMVEC_COUNT) return NULL;
+    return (ramvec_isr_t)(uintptr_t)ram_vec[vector - 1u];
+}
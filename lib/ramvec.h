@@ -0,0 +1,62 @@
+/**
+ * @file ramvec.h
+ * @brief RAM interrupt vector table (SYSRIVECT): rebind ISRs at run time.
+ *
+ * - RamVec_Init() copies the FRAM table (0xFF80..0xFFFF) to the top 128 bytes of SRAM
+ *   and sets SYSCTL.SYSRIVECT; from then on the CPU fetches vectors from SRAM
+ * - RamVec_Set() swaps one entry with a single word store, so a tick or port ISR can
+ *   be replaced by a specialised fast path (per power mode or scheduler mode) without
+ *   a rebuild and without a dispatching wrapper
+ * - Linking lib/ramvec.c moves the initial stack pointer below the table
+ * - ISRs bound only at run time are declared with RAMVEC_ISR(name): an interrupt
+ *   function with no vector of its own
+ * - The reset vector is always read from FRAM
+ */
+
+#ifndef RAMVEC_H
+#define RAMVEC_H
+
+#include <stdint.h>
+
+#define RAMVEC_COUNT      64        // vectors 1..64 at 0xFF80 + 2 * (n - 1)
+#define RAMVEC_FRAM_BASE  0xFF80u
+#define RAMVEC_RAM_BASE   0x3B80u   // top of SRAM (0x1C00..0x3BFF)
+
+#if defined(__TI_COMPILER_VERSION__) || defined(__IAR_SYSTEMS_ICC__)
+#define RAMVEC_ISR(name) __interrupt void name(void)
+#elif defined(__GNUC__) && defined(__MSP430__)
+#define RAMVEC_ISR(name) void __attribute__((interrupt)) name(void)
+#else
+#define RAMVEC_ISR(name) void name(void)   // host builds call ISRs directly
+#endif
+
+/**
+ * @typedef ramvec_isr_t
+ * @brief Interrupt entry point; must be an interrupt function below 64 KB.
+ */
+typedef void (*ramvec_isr_t)(void);
+
+/**
+ * @brief Copy the FRAM vector table to SRAM and switch the CPU to it.
+ *
+ * Call once before enabling interrupts; statically bound ISRs keep working.
+ */
+void RamVec_Init(void);
+
+/**
+ * @brief Bind isr to a vector (the *_VECTOR number from the device header).
+ *
+ * Safe with interrupts enabled: the entry is one word. An interrupt already being
+ * accepted uses the old entry.
+ *
+ * @return 0 on success, -1 for the reset vector, an invalid number or an isr above
+ *         64 KB.
+ */
+int RamVec_Set(uint8_t vector, ramvec_isr_t isr);
+
+/**
+ * @brief Entry point currently bound to a vector (NULL if out of range).
+ */
+ramvec_isr_t RamVec_Get(uint8_t vector);
+
+#endif /* RAMVEC_H */
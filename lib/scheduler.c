@@ -0,0 +1,290 @@
+/**
+ * @file scheduler.c
+ * @brief Cooperative periodic task scheduler (pending-counter design).
+ *
+ * Key patterns:
+ * - Keep ISR minimal: one countdown per task, kept in SRAM
+ * - Pending counters are accessed in main with interrupts briefly disabled
+ * - The application ISR calls __bic_SR_register_on_exit(LPM0_bits) to wake main loop
+ * - Tick and dispatch entry points are HOT_FN (lib/hot.h): copied to SRAM at start-up
+ * - Countdowns count ticks, not ms: Scheduler_Start() may stretch the tick to the GCD
+ *   of the task set, and slices are timed in TA0 counts so they need no fine tick
+ */
+
+#include <msp430.h>
+#include <stddef.h>
+#include "scheduler.h"
+#include "systime.h"
+#include "defer.h"
+#include "aio.h"
+#include "background.h"
+#include "energy.h"
+#include "wcet.h"
+#include "hot.h"
+
+#ifndef SCHEDULER_CLOCK
+#define SCHEDULER_CLOCK() SysTime_Counts()      // TA0 counts (SMCLK/8)
+#endif
+
+/* ---------- Scheduler storage ---------- */
+static task_t tasks[MAX_TASKS];
+static uint8_t task_count = 0;
+
+static server_t *servers[MAX_SERVERS];
+static uint8_t server_count = 0;
+
+static uint16_t counts_per_ms = 0;     // SCHEDULER_CLOCK() counts per ms, for slices
+
+/* Deferred tick: ticks counted by the ISR, not yet applied to the countdowns */
+static volatile uint16_t ticks_owed = 0;
+static volatile uint8_t tick_queued = 0;
+
+int Scheduler_AddTask(task_fn_t fn, uint16_t period_ms, uint16_t offset_ms, uint16_t slice_ms)
+{
+    uint16_t tick = SysTime_TickMs();
+
+    if (!fn || period_ms == 0 || task_count >= MAX_TASKS) return -1;
+    if (period_ms % tick != 0 || offset_ms % tick != 0) return -1;
+    counts_per_ms = SysTime_CountsPerMs();
+    tasks[task_count].fn = fn;
+    tasks[task_count].period_ms = period_ms;
+    tasks[task_count].offset_ms = offset_ms;
+    tasks[task_count].slice_ms = slice_ms;
+    tasks[task_count].overruns = 0;
+    tasks[task_count].period_ticks = period_ms / tick;
+    tasks[task_count].countdown_ticks = (uint16_t)((period_ms + offset_ms) / tick);
+    tasks[task_count].pending = 0;
+    task_count++;
+    return 0;
+}
+
+uint16_t Scheduler_UtilizationPermille(void)
+{
+    uint32_t permille = 0;
+    uint8_t i;
+
+    for (i = 0; i < task_count; i++)
+        permille += (uint32_t)tasks[i].slice_ms * 1000u / tasks[i].period_ms;
+    for (i = 0; i < server_count; i++)
+        permille += Server_CapacityUs(servers[i]) / Server_PeriodMs(servers[i]);  // us/ms
+    return permille > 0xFFFFu ? 0xFFFFu : (uint16_t)permille;
+}
+
+int Scheduler_AddServer(server_t *s)
+{
+    if (!s || server_count >= MAX_SERVERS || Server_PeriodMs(s) == 0) return -1;
+    servers[server_count++] = s;
+    if (Scheduler_UtilizationPermille() > 1000u)
+    {
+        server_count--;
+        return -1;
+    }
+    return 0;
+}
+
+static uint16_t gcd(uint16_t a, uint16_t b)
+{
+    while (b)
+    {
+        uint16_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+uint16_t Scheduler_Start(void)
+{
+    uint16_t g = 0, tick;
+    uint8_t i;
+
+    /* gcd(0, x) = x: zero offsets do not constrain the tick */
+    for (i = 0; i < task_count; i++)
+        g = gcd(gcd(g, tasks[i].period_ms), tasks[i].offset_ms);
+    for (i = 0; i < server_count; i++)
+        g = gcd(g, Server_PeriodMs(servers[i]));
+
+    tick = SysTime_FitTickMs(g);
+    SysTime_SetTickMs(tick);
+    for (i = 0; i < task_count; i++)
+    {
+        tasks[i].period_ticks = tasks[i].period_ms / tick;
+        tasks[i].countdown_ticks = (uint16_t)((tasks[i].period_ms + tasks[i].offset_ms) / tick);
+    }
+    return tick;
+}
+
+uint16_t Scheduler_MaxStartDelayMs(void)
+{
+    uint32_t base = SysTime_TickMs(), delay, prev = 0;
+    uint8_t i;
+
+    for (i = 0; i < task_count; i++) base += tasks[i].slice_ms;
+    delay = base;
+    while (delay != prev && delay <= 0xFFFFu)
+    {
+        prev = delay;
+        delay = base;
+        for (i = 0; i < server_count; i++)
+        {
+            uint32_t t = Server_PeriodMs(servers[i]);
+            uint32_t c = (Server_CapacityUs(servers[i]) + 999u) / 1000u;
+            delay += (prev + t - 1u) / t * c;
+        }
+    }
+    return delay > 0xFFFFu ? 0xFFFFu : (uint16_t)delay;
+}
+
+const task_t *Scheduler_GetTask(uint8_t idx)
+{
+    return (idx < task_count) ? &tasks[idx] : NULL;
+}
+
+HOT_FN void Scheduler_Tick(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < task_count; i++)
+    {
+        WCET_LOOP_BOUND(MAX_TASKS);
+        if (--tasks[i].countdown_ticks == 0)
+        {
+            tasks[i].countdown_ticks = tasks[i].period_ticks;
+            if (tasks[i].pending < 0xFFFF) tasks[i].pending++;
+        }
+    }
+}
+
+static void tick_work(uintptr_t arg)
+{
+    uint16_t n;
+
+    (void)arg;
+    __disable_interrupt();
+    n = ticks_owed;
+    ticks_owed = 0;
+    tick_queued = 0;
+    __enable_interrupt();
+
+    while (n--) Scheduler_Tick();
+}
+
+HOT_FN void Scheduler_TickDeferred(void)
+{
+    ticks_owed++;
+    if (!tick_queued)
+    {
+        /* retried on the next tick if the ring is full */
+        tick_queued = (Defer_Post(DEFER_PRIO_HIGH, tick_work, 0) == 0);
+    }
+}
+
+/* Slack before the next release, with GIE clear: each countdown reaches zero on a tick,
+ * and countdown - 1 whole ticks (less those not yet applied) come before that one */
+static uint16_t slack_ticks(void)
+{
+    uint16_t min = 0xFFFF, owed = ticks_owed;
+    uint8_t i;
+
+    for (i = 0; i < task_count; i++)
+    {
+        WCET_LOOP_BOUND(MAX_TASKS);
+        if (tasks[i].countdown_ticks < min) min = tasks[i].countdown_ticks;
+    }
+    return min > owed + 1u ? (uint16_t)(min - owed - 1u) : 0;
+}
+
+/* Bottom halves, I/O completions, then server handlers within their budget */
+static void run_aperiodic(void)
+{
+    uint8_t i;
+
+    Defer_Run();
+    Aio_Run();
+    for (i = 0; i < server_count; i++)
+    {
+        WCET_LOOP_BOUND(MAX_SERVERS);
+        Server_Run(servers[i]);
+    }
+}
+
+static uint8_t servers_ready(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < server_count; i++)
+    {
+        WCET_LOOP_BOUND(MAX_SERVERS);
+        if (Server_Ready(servers[i])) return 1;
+    }
+    return 0;
+}
+
+HOT_FN void Scheduler_Dispatch(void)
+{
+    uint8_t i;
+    uint8_t have_work = 0;
+
+    /* Check if any pending tasks exist atomically. If none, enter LPM0.
+     * We disable interrupts briefly to avoid a race where ISR sets pending
+     * between checking and sleeping.
+     */
+    __disable_interrupt();
+    for (i = 0; i < task_count; i++) {
+        if (tasks[i].pending) { have_work = 1; break; }
+    }
+    if (!have_work && !Defer_Pending() && !Aio_Pending() && !servers_ready()) {
+        /* Idle: steal the slack for one background chunk, re-check on the next pass */
+        if (Background_Run(slack_ticks()))
+            return;
+#if SCHEDULER_ENERGY
+        uint32_t slept = Energy_Stamp();
+#endif
+        /* sleep until next tick (ISR will wake via __bic_SR_register_on_exit) */
+        __bis_SR_register(LPM0_bits | GIE);
+#if SCHEDULER_ENERGY
+        Energy_EndSleep(ENERGY_LPM0, slept);    // includes the waking ISR
+#endif
+    }
+    __enable_interrupt();
+
+    /* Bottom halves first: a deferred tick may release tasks for this pass */
+    run_aperiodic();
+
+    /* Snapshot and clear pending in a short atomic window, then call handlers
+     * while interrupts are enabled so ISR keeps running.
+     */
+    for (i = 0; i < task_count; i++) {
+        uint16_t run_cnt = 0;
+
+        __disable_interrupt();
+        if (tasks[i].pending) {
+            run_cnt = tasks[i].pending;
+            tasks[i].pending = 0;   // consume all pending occurrences (coalesced execution)
+        }
+        __enable_interrupt();
+
+        /* run the task 'run_cnt' times (usually 0 or 1). Keep each invocation short. */
+        while (run_cnt--) {
+            uint32_t start, counts;
+#if SCHEDULER_ENERGY
+            uint32_t stamp;
+#endif
+
+            run_aperiodic();    // aperiodic work never waits behind more than one task
+            start = SysTime_Now();
+            counts = SCHEDULER_CLOCK();
+#if SCHEDULER_ENERGY
+            stamp = Energy_Stamp();
+            tasks[i].fn(start);
+            Energy_EndTask(i, stamp);
+#else
+            tasks[i].fn(start);
+#endif
+            if (tasks[i].slice_ms &&
+                SCHEDULER_CLOCK() - counts > (uint32_t)tasks[i].slice_ms * counts_per_ms) {
+                tasks[i].overruns++;
+            }
+        }
+    }
+}
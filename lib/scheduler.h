@@ -0,0 +1,130 @@
+/**
+ * @file scheduler.h
+ * @brief Cooperative periodic task scheduler (pending-counter design).
+ *
+ * - Tick ISR calls Scheduler_Tick(): per-task countdowns, pending++ on release,
+ *   or Scheduler_TickDeferred() to keep the ISR O(1) and run the countdowns as
+ *   deferred work (defer.h)
+ * - Main loop calls Scheduler_Dispatch(): sleeps in LPM0 when idle, otherwise runs
+ *   deferred work, then snapshots pending counters atomically and runs tasks with
+ *   interrupts enabled; deferred work also runs ahead of every task
+ * - Finished I/O requests (aio.h) are drained right after deferred work
+ * - Sporadic servers (server.h) run budgeted aperiodic handlers next to deferred work;
+ *   Scheduler_AddServer() rejects a server that would push utilization over 100 %
+ * - When idle, a background chunk (background.h) runs instead of sleeping if it fits
+ *   in the slack before the next release, computed from the countdowns
+ * - With SCHEDULER_ENERGY, every task run and LPM interval is charged to energy.h
+ * - Scheduler_Start() stretches the tick to the GCD of all periods and offsets: a
+ *   10/50/100 ms set with zero offsets wakes the CPU every 10 ms instead of every 1 ms
+ * - Task i is released at offset_ms + k * period_ms, k >= 1
+ */
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <stdint.h>
+#include "server.h"
+
+#define MAX_TASKS    8   // increase if needed
+#define MAX_SERVERS  2
+#ifndef SCHEDULER_ENERGY
+#define SCHEDULER_ENERGY 1  // per-task energy accounting (energy.h), 0 to compile out
+#endif
+
+/**
+ * @typedef task_fn_t
+ * @brief Task function prototype.
+ * @param now_ms System time (SysTime_Now()) at dispatch.
+ */
+typedef void (*task_fn_t)(uint32_t now_ms);
+
+/**
+ * @struct task_t
+ * @brief Task descriptor.
+ */
+typedef struct {
+    task_fn_t  fn;                /**< Task function */
+    uint16_t   period_ms;         /**< Period in ms (multiple of TICK_MS) */
+    uint16_t   offset_ms;         /**< Phase offset of the first release */
+    uint16_t   slice_ms;          /**< Allowed execution window, 0 = unchecked */
+    uint16_t   overruns;          /**< Runs that exceeded slice_ms */
+    uint16_t   period_ticks;      /**< Period in ticks (see Scheduler_Start()) */
+    uint16_t   countdown_ticks;   /**< Ticks until next release (tick context only) */
+    volatile uint16_t pending;    /**< Pending executions queued by ISR */
+} task_t;
+
+/**
+ * @brief Register a periodic task.
+ *
+ * @param fn Task function.
+ * @param period_ms Period in ms (>0).
+ * @param offset_ms Phase offset in ms.
+ * @param slice_ms Allowed execution window in ms (0 = unchecked).
+ * @return 0 on success, -1 on failure (full table, or after Scheduler_Start() a period
+ *         or offset that is not a multiple of the tick).
+ */
+int Scheduler_AddTask(task_fn_t fn, uint16_t period_ms, uint16_t offset_ms, uint16_t slice_ms);
+
+/**
+ * @brief Finalize the task set: set the tick to the GCD of all task periods and offsets
+ *        and of the server periods (SysTime_SetTickMs()), and count in those ticks.
+ *
+ * Call after the tasks and servers are added, before interrupts are enabled. Release
+ * times do not change; slices are measured with SysTime_Counts() and do not limit the
+ * tick. Without this call the tick stays TICK_MS.
+ *
+ * @return Tick in ms; the GCD, or its largest divisor that TA0 can count.
+ */
+uint16_t Scheduler_Start(void);
+
+/**
+ * @brief Advance task countdowns by one tick. Call from the tick ISR.
+ */
+void Scheduler_Tick(void);
+
+/**
+ * @brief Count one tick and post the countdown update as DEFER_PRIO_HIGH work.
+ *
+ * Call from the tick ISR instead of Scheduler_Tick(). Ticks that arrive before the
+ * main loop runs the work are coalesced into one item, so none are lost on a full ring.
+ */
+void Scheduler_TickDeferred(void);
+
+/**
+ * @brief One main-loop pass: if no task or deferred work is pending, run one background
+ *        chunk that fits the slack or sleep in LPM0; then run deferred work and pending
+ *        tasks.
+ */
+void Scheduler_Dispatch(void);
+
+/**
+ * @brief Register a sporadic server (Server_Init() first); its handlers run ahead of
+ *        periodic tasks while it has budget.
+ *
+ * @return 0 on success, -1 if the table is full or task slices plus server capacities
+ *         would exceed 100 % utilization.
+ */
+int Scheduler_AddServer(server_t *s);
+
+/**
+ * @brief Utilization in permille: sum of slice_ms / period_ms over tasks (unchecked
+ *        tasks count as 0) plus capacity / period over servers.
+ */
+uint16_t Scheduler_UtilizationPermille(void);
+
+/**
+ * @brief Worst release-to-start delay of a task in ms, 0xFFFF if unbounded.
+ *
+ * One tick to notice the release, one slice of every task (the pass in progress and the
+ * tasks ahead in the next one), and the server capacity that fits in that window:
+ * L = tick + sum(slice) + sum(ceil(L / T_s) * ceil(C_s)). Deferred work, ISRs and a
+ * handler overrunning the budget are not included.
+ */
+uint16_t Scheduler_MaxStartDelayMs(void);
+
+/**
+ * @brief Read-only access to a registered task (NULL if out of range).
+ */
+const task_t *Scheduler_GetTask(uint8_t idx);
+
+#endif /* SCHEDULER_H */
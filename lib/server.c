@@ -0,0 +1,146 @@
+/**
+ * @file server.c
+ * @brief Sporadic server: budgeted execution of aperiodic handlers (events, RX bursts).
+ *
+ * Key patterns:
+ * - Single-consumer ring with 8-bit indices, as in defer.c: ISRs only move head
+ * - Replenishments are applied lazily when the main loop looks at the server, so
+ *   the tick ISR does no server work; a server with work but no budget is picked up
+ *   again on the first dispatch pass after its replenishment time
+ * - SERVER_CLOCK() is the consumption clock; host builds override it with the
+ *   simulator's cycle counter
+ * - Each run is one activation: its consumption is returned one period after it
+ *   started; with SERVER_REPL entries in use the newest one is extended (later, so
+ *   still safe)
+ */
+
+#include <msp430.h>
+#include <stddef.h>
+#include "clock.h"
+#include "systime.h"
+#include "server.h"
+
+#ifndef SERVER_CLOCK
+#define SERVER_CLOCK() SysTime_Counts()     // TA0 counts (SMCLK/8)
+#endif
+
+#define SERVER_MASK (SERVER_QUEUE_LEN - 1u)
+
+#if (SERVER_QUEUE_LEN & SERVER_MASK) != 0 || SERVER_QUEUE_LEN > 128
+#error SERVER_QUEUE_LEN must be a power of two <= 128
+#endif
+
+void Server_Init(server_t *s, uint16_t capacity_us, uint16_t period_ms)
+{
+    s->capacity = (uint32_t)capacity_us * (Clk_GetHz() / 1000000u) / 8u;   // SMCLK/8
+    s->capacity_us = capacity_us;
+    s->period_ms = period_ms;
+    s->budget = (int32_t)s->capacity;
+    s->repl_count = 0;
+    s->head = 0;
+    s->tail = 0;
+    s->stats.posted = 0;
+    s->stats.run = 0;
+    s->stats.dropped = 0;
+    s->stats.exhausted = 0;
+    s->stats.max_backlog = 0;
+}
+
+int Server_Post(server_t *s, defer_fn_t fn, uintptr_t arg)
+{
+    uint8_t head = s->head;
+    uint8_t depth = (uint8_t)(head - s->tail);
+
+    if (!fn || depth >= SERVER_QUEUE_LEN)
+    {
+        s->stats.dropped++;
+        return -1;
+    }
+    s->item[head & SERVER_MASK].fn = fn;
+    s->item[head & SERVER_MASK].arg = arg;
+    s->head = (uint8_t)(head + 1u);     // publish
+
+    s->stats.posted++;
+    if (depth + 1u > s->stats.max_backlog) s->stats.max_backlog = depth + 1u;
+    return 0;
+}
+
+/* Return the budget of every activation that started at least one period ago */
+static void replenish(server_t *s)
+{
+    uint32_t now = SysTime_Now();
+    uint8_t i;
+
+    while (s->repl_count && (int32_t)(now - s->repl[0].at_ms) >= 0)
+    {
+        s->budget += (int32_t)s->repl[0].amount;
+        for (i = 1; i < s->repl_count; i++) s->repl[i - 1] = s->repl[i];
+        s->repl_count--;
+    }
+    if (s->budget > (int32_t)s->capacity) s->budget = (int32_t)s->capacity;
+}
+
+uint8_t Server_Ready(server_t *s)
+{
+    if (s->head == s->tail) return 0;
+    replenish(s);
+    return s->budget > 0;
+}
+
+uint16_t Server_Run(server_t *s)
+{
+    uint32_t start_ms, used = 0;
+    uint16_t count = 0;
+
+    if (!Server_Ready(s)) return 0;
+
+    start_ms = SysTime_Now();
+    while (s->head != s->tail)
+    {
+        server_item_t it;
+        uint32_t t0;
+
+        if ((int32_t)used >= s->budget)
+        {
+            s->stats.exhausted++;       // rest waits for a replenishment
+            break;
+        }
+        it = s->item[s->tail & SERVER_MASK];
+        s->tail = (uint8_t)(s->tail + 1u);   // release the slot
+
+        t0 = SERVER_CLOCK();
+        it.fn(it.arg);
+        used += SERVER_CLOCK() - t0;
+        s->stats.run++;
+        count++;
+    }
+    s->budget -= (int32_t)used;
+
+    if (s->repl_count < SERVER_REPL)
+    {
+        s->repl[s->repl_count].at_ms = start_ms + s->period_ms;
+        s->repl[s->repl_count].amount = used;
+        s->repl_count++;
+    }
+    else
+    {
+        s->repl[SERVER_REPL - 1].at_ms = start_ms + s->period_ms;
+        s->repl[SERVER_REPL - 1].amount += used;
+    }
+    return count;
+}
+
+uint16_t Server_CapacityUs(const server_t *s)
+{
+    return s->capacity_us;
+}
+
+uint16_t Server_PeriodMs(const server_t *s)
+{
+    return s->period_ms;
+}
+
+const server_stats_t *Server_GetStats(const server_t *s)
+{
+    return &s->stats;
+}
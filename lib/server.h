@@ -0,0 +1,104 @@
+/**
+ * @file server.h
+ * @brief Sporadic server: budgeted execution of aperiodic handlers (events, RX bursts).
+ *
+ * - ISRs post handlers with Server_Post() (same ring design as defer.h)
+ * - Scheduler_Dispatch() runs them ahead of periodic tasks while the server has
+ *   budget, and leaves them queued once it is exhausted
+ * - Budget consumed from a time t is given back at t + period_ms (sporadic server
+ *   rule), so in any window of period_ms the handlers take at most capacity plus the
+ *   overrun of the last handler started: to the periodic tasks the server looks like one
+ *   more task with that WCET and period (Scheduler_AddServer() checks utilization)
+ * - Consumption is measured with SysTime_Counts() (TA0 counts, SMCLK/8), including the
+ *   interrupts that land inside a handler
+ */
+
+#ifndef SERVER_H
+#define SERVER_H
+
+#include <stdint.h>
+#include "defer.h"
+
+#define SERVER_QUEUE_LEN  16  // queued handlers, power of two
+#define SERVER_REPL       4   // outstanding replenishments, merged when full
+
+typedef struct {
+    defer_fn_t fn;
+    uintptr_t  arg;
+} server_item_t;
+
+typedef struct {
+    uint32_t at_ms;
+    uint32_t amount;              // TA0 counts
+} server_repl_t;
+
+/**
+ * @struct server_stats_t
+ * @brief Counters since Server_Init().
+ */
+typedef struct {
+    uint32_t posted;              /**< Handlers queued */
+    uint32_t run;                 /**< Handlers executed */
+    uint16_t dropped;             /**< Server_Post() calls rejected on a full ring */
+    uint16_t exhausted;           /**< Runs stopped with handlers left (budget used up) */
+    uint8_t  max_backlog;         /**< Deepest ring occupancy seen by Server_Post() */
+} server_stats_t;
+
+/**
+ * @struct server_t
+ * @brief One server. Fields are private; read counters with Server_GetStats().
+ */
+typedef struct server {
+    uint32_t         capacity;    // TA0 counts per period
+    uint16_t         period_ms;
+    uint16_t         capacity_us;
+    int32_t          budget;      // counts left, negative after a handler overran it
+    server_repl_t    repl[SERVER_REPL];
+    uint8_t          repl_count;
+    server_item_t    item[SERVER_QUEUE_LEN];
+    volatile uint8_t head;        // next free slot (ISRs)
+    volatile uint8_t tail;        // next handler to run (main loop)
+    server_stats_t   stats;
+} server_t;
+
+/**
+ * @brief Empty the server and give it its full capacity.
+ *
+ * Call after Clk_Init(): the capacity is converted to TA0 counts at the current clock.
+ *
+ * @param capacity_us Handler time allowed per period.
+ * @param period_ms Replenishment period.
+ */
+void Server_Init(server_t *s, uint16_t capacity_us, uint16_t period_ms);
+
+/**
+ * @brief Queue fn(arg) on the server. Call from ISRs, or from main with GIE clear.
+ *
+ * @return 0 on success, -1 if the ring is full.
+ */
+int Server_Post(server_t *s, defer_fn_t fn, uintptr_t arg);
+
+/**
+ * @brief Non-zero if handlers are queued and budget is left (main loop, GIE clear ok).
+ */
+uint8_t Server_Ready(server_t *s);
+
+/**
+ * @brief Run queued handlers in order while budget is left.
+ *
+ * @return Number of handlers run.
+ */
+uint16_t Server_Run(server_t *s);
+
+/**
+ * @brief Capacity in us and period in ms given to Server_Init().
+ */
+uint16_t Server_CapacityUs(const server_t *s);
+uint16_t Server_PeriodMs(const server_t *s);
+
+/**
+ * @brief Counters since Server_Init().
+ */
+const server_stats_t *Server_GetStats(const server_t *s);
+
+#endif /* SERVER_H */
@@ -0,0 +1,178 @@
+/**
+ * @file static_scheduler.hpp
+ * @brief Compile-time task set for the pending-counter scheduler (C++17, header only).
+ *
+ * - Same release and dispatch rules as scheduler.h: task i is released at
+ *   offset + k * period (k >= 1), the tick ISR counts releases, the main loop runs
+ *   deferred work and then every pending task in list order, coalesced runs included
+ * - The task set is a type: StaticScheduler<Task<fn, period, offset, slice>, ...>.
+ *   Functions, periods and offsets are template arguments, so tick() and dispatch()
+ *   expand to straight-line code with constant reloads and direct (inlinable) calls;
+ *   nothing goes through a task_fn_t table in RAM
+ * - Invalid periods, offsets, slices and a total slice utilization above 100 % are
+ *   rejected by static_assert at compile time instead of Scheduler_AddTask() at run time
+ * - Not covered: servers, aio.h, background.h and energy.h accounting; use scheduler.h
+ *   where those are needed. Build with -fno-exceptions -fno-rtti (Makefile CXXFLAGS)
+ */
+
+#ifndef STATIC_SCHEDULER_HPP
+#define STATIC_SCHEDULER_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+#include <utility>
+
+extern "C" {
+#include <msp430.h>
+#include "systime.h"
+#include "defer.h"
+}
+
+namespace sched {
+
+/* I-th type of a pack */
+template <size_t I, class T, class... Rest>
+struct type_at { using type = typename type_at<I - 1u, Rest...>::type; };
+
+template <class T, class... Rest>
+struct type_at<0, T, Rest...> { using type = T; };
+
+/**
+ * @brief One periodic task: fn(now_ms) every period_ms after offset_ms.
+ *
+ * @tparam Fn Task function, called directly.
+ * @tparam PeriodMs Period in ms (multiple of TICK_MS).
+ * @tparam OffsetMs Phase offset of the first release.
+ * @tparam SliceMs Allowed execution window in ms, 0 = unchecked.
+ */
+template <void (*Fn)(uint32_t), uint16_t PeriodMs, uint16_t OffsetMs = 0, uint16_t SliceMs = 0>
+struct Task {
+    static_assert(PeriodMs > 0, "task period must be > 0");
+    static_assert(PeriodMs % TICK_MS == 0 && OffsetMs % TICK_MS == 0,
+                  "task period and offset must be multiples of TICK_MS");
+    static_assert((uint32_t)PeriodMs + OffsetMs <= 0xFFFFu,
+                  "period + offset must fit the 16-bit countdown");
+    static_assert(SliceMs <= PeriodMs, "task slice longer than its period");
+
+    static constexpr uint16_t period_ms = PeriodMs;
+    static constexpr uint16_t offset_ms = OffsetMs;
+    static constexpr uint16_t slice_ms = SliceMs;
+
+    static inline void run(uint32_t now_ms) { Fn(now_ms); }
+};
+
+/**
+ * @brief Scheduler for a fixed task list; all state is static, one instance per type.
+ */
+template <class... Tasks>
+class StaticScheduler {
+public:
+    static constexpr size_t task_count = sizeof...(Tasks);
+
+    /** Sum of slice_ms / period_ms in permille, as Scheduler_UtilizationPermille() */
+    static constexpr uint32_t utilization_permille =
+        (0u + ... + ((uint32_t)Tasks::slice_ms * 1000u / Tasks::period_ms));
+
+    static_assert(task_count > 0, "empty task set");
+    static_assert(utilization_permille <= 1000u, "task slices exceed 100 % utilization");
+
+    /**
+     * @brief Advance every countdown by one tick. Call from the tick ISR.
+     */
+    static inline void tick() { tick_all(std::index_sequence_for<Tasks...>{}); }
+
+    /**
+     * @brief One main-loop pass: sleep in LPM0 if nothing is pending, then run deferred
+     *        work and the pending tasks in list order.
+     */
+    static void dispatch()
+    {
+        __disable_interrupt();
+        if (!any_pending(std::index_sequence_for<Tasks...>{}) && !Defer_Pending())
+        {
+            /* sleep until next tick (ISR will wake via __bic_SR_register_on_exit) */
+            __bis_SR_register(LPM0_bits | GIE);
+        }
+        __enable_interrupt();
+
+        Defer_Run();
+        run_all(std::index_sequence_for<Tasks...>{});
+    }
+
+    /**
+     * @brief Restart every task at its first release (counters and overruns cleared).
+     */
+    static void reset()
+    {
+        reset_all(std::index_sequence_for<Tasks...>{});
+    }
+
+    /** Runs of task idx that exceeded its slice */
+    static uint16_t overruns(size_t idx) { return idx < task_count ? overrun[idx] : 0; }
+
+    /** Releases of task idx not yet dispatched */
+    static uint16_t pending_runs(size_t idx) { return idx < task_count ? pending[idx] : 0; }
+
+private:
+    template <size_t I>
+    using task_at = typename type_at<I, Tasks...>::type;
+
+    /* Initial values are constants: no start-up code beyond the .data copy */
+    static inline uint16_t countdown[task_count] = { (Tasks::period_ms + Tasks::offset_ms)... };
+    static inline volatile uint16_t pending[task_count] = {};
+    static inline uint16_t overrun[task_count] = {};
+
+    template <size_t I>
+    static inline void tick_one()
+    {
+        if (--countdown[I] == 0)
+        {
+            countdown[I] = task_at<I>::period_ms;
+            if (pending[I] < 0xFFFF) pending[I]++;
+        }
+    }
+
+    template <size_t... I>
+    static inline void tick_all(std::index_sequence<I...>) { (tick_one<I>(), ...); }
+
+    template <size_t... I>
+    static inline bool any_pending(std::index_sequence<I...>) { return (... || pending[I]); }
+
+    template <size_t I>
+    static inline void run_one()
+    {
+        uint16_t run_cnt;
+
+        __disable_interrupt();
+        run_cnt = pending[I];
+        pending[I] = 0;     // consume all pending occurrences (coalesced execution)
+        __enable_interrupt();
+
+        while (run_cnt--)
+        {
+            uint32_t start;
+
+            Defer_Run();    // deferred work never waits behind more than one task
+            start = SysTime_Now();
+            task_at<I>::run(start);
+            if (task_at<I>::slice_ms && TIME_ELAPSED(start) > task_at<I>::slice_ms)
+            {
+                overrun[I]++;
+            }
+        }
+    }
+
+    template <size_t... I>
+    static inline void run_all(std::index_sequence<I...>) { (run_one<I>(), ...); }
+
+    template <size_t... I>
+    static void reset_all(std::index_sequence<I...>)
+    {
+        ((countdown[I] = task_at<I>::period_ms + task_at<I>::offset_ms,
+          pending[I] = 0, overrun[I] = 0), ...);
+    }
+};
+
+} // namespace sched
+
+#endif /* STATIC_SCHEDULER_HPP */
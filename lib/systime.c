@@ -0,0 +1,70 @@
+/**
+ * @file systime.c
+ * @brief Millisecond system time base on Timer_A0 CCR0.
+ */
+
+#include <msp430.h>
+#include "clock.h"
+#include "systime.h"
+
+volatile uint32_t systime_ms = 0;
+uint16_t systime_tick_ms = TICK_MS;
+static uint16_t counts_per_ms = 0;
+
+uint16_t SysTime_CountsPerMs(void)
+{
+    return (uint16_t)(Clk_GetHz() / 8u / 1000u);
+}
+
+uint16_t SysTime_MaxTickMs(void)
+{
+    uint16_t max = (uint16_t)(0x10000UL / SysTime_CountsPerMs());
+
+    return (uint16_t)(max - max % TICK_MS);
+}
+
+uint16_t SysTime_FitTickMs(uint16_t ms)
+{
+    uint16_t max = SysTime_MaxTickMs(), d;
+
+    if (ms == 0) return TICK_MS;
+    for (d = ms < max ? ms : max; d > TICK_MS; d--)
+    {
+        if (ms % d == 0 && d % TICK_MS == 0) return d;
+    }
+    return TICK_MS;
+}
+
+void SysTime_Init(void)
+{
+    /* SMCLK/8, 1 ms tick: 1 MHz -> 124, 8 MHz -> 999, 16 MHz -> 1999 */
+    counts_per_ms = SysTime_CountsPerMs();
+    TA0CCTL0 = CCIE;                              // CCR0 interrupt enable
+    TA0CCR0  = (uint16_t)((uint32_t)counts_per_ms * systime_tick_ms - 1u);
+    TA0CTL   = TASSEL__SMCLK | ID__8 | MC__UP | TACLR;
+}
+
+int SysTime_SetTickMs(uint16_t ms)
+{
+    if (ms == 0 || ms % TICK_MS != 0 || ms > SysTime_MaxTickMs()) return -1;
+
+    systime_tick_ms = ms;
+    counts_per_ms = SysTime_CountsPerMs();
+    TA0CCR0 = (uint16_t)((uint32_t)counts_per_ms * ms - 1u);
+    TA0CTL |= TACLR;                              // restart the tick from here
+    return 0;
+}
+
+uint32_t SysTime_Counts(void)
+{
+    uint16_t sr = __get_interrupt_state();
+    uint32_t ms;
+    uint16_t count;
+
+    __disable_interrupt();
+    ms = systime_ms;
+    count = TA0R;
+    if ((TA0CCTL0 & CCIFG) && count < (TA0CCR0 >> 1)) ms += systime_tick_ms;
+    __set_interrupt_state(sr);
+    return ms * counts_per_ms + count;
+}
@@ -0,0 +1,104 @@
+/**
+ * @file systime.h
+ * @brief Millisecond system time base on Timer_A0 CCR0.
+ *
+ * - SysTime_Init() programs TA0 for an up-mode tick from SMCLK/8, TICK_MS by default;
+ *   SysTime_SetTickMs() stretches it to a multiple of TICK_MS (e.g. the GCD of all
+ *   task periods, Scheduler_Start()), so fewer interrupts wake the CPU
+ * - The application owns the TIMER0_A0 ISR and calls SysTime_Tick() from it
+ * - SysTime_Now() reads the 32-bit counter atomically, SysTime_Counts() adds TA0R for
+ *   sub-tick stamps
+ */
+
+#ifndef SYSTIME_H
+#define SYSTIME_H
+
+#include <msp430.h>
+#include <stdint.h>
+
+#define TICK_MS 1   // default system tick in ms, and the unit of SysTime_SetTickMs()
+
+extern volatile uint32_t systime_ms;
+extern uint16_t systime_tick_ms;
+
+/**
+ * @brief Program TA0 CCR0 for the current tick (TICK_MS unless set) at the current
+ *        SMCLK (see Clk_Init()).
+ */
+void SysTime_Init(void);
+
+/**
+ * @brief Change the tick length; takes effect at once if TA0 is running (the
+ *        partial tick in progress is dropped, so call it before enabling interrupts).
+ *
+ * @param ms Tick in ms, a multiple of TICK_MS, at most SysTime_MaxTickMs().
+ * @return 0 on success, -1 if ms is 0, not a multiple of TICK_MS or too long for TA0.
+ */
+int SysTime_SetTickMs(uint16_t ms);
+
+/**
+ * @brief Longest tick a 16-bit CCR0 can count at the current SMCLK/8.
+ */
+uint16_t SysTime_MaxTickMs(void);
+
+/**
+ * @brief Longest valid tick that divides ms: the tick for a task set whose release
+ *        times are all multiples of ms (TICK_MS for ms = 0).
+ */
+uint16_t SysTime_FitTickMs(uint16_t ms);
+
+/**
+ * @brief Current tick length in ms.
+ */
+static inline uint16_t SysTime_TickMs(void)
+{
+    return systime_tick_ms;
+}
+
+/**
+ * @brief Advance system time by one tick. Call from the TIMER0_A0 ISR.
+ */
+static inline void SysTime_Tick(void)
+{
+    systime_ms += systime_tick_ms;
+}
+
+/**
+ * @brief Current system time in ms (atomic 32-bit read, safe with GIE set or clear).
+ */
+static inline uint32_t SysTime_Now(void)
+{
+    uint16_t sr = __get_interrupt_state();
+    uint32_t now;
+
+    __disable_interrupt();
+    now = systime_ms;
+    __set_interrupt_state(sr);
+    return now;
+}
+
+/**
+ * @brief Fine time stamp: TA0 counts (SMCLK/8) since SysTime_Init(), modulo 2^32.
+ *
+ * Combines systime_ms with TA0R; a counter that wrapped before the tick ISR ran is
+ * detected from the pending CCR0 flag. Call SysTime_Tick() first in the tick ISR.
+ * Resolution does not depend on the tick length.
+ */
+uint32_t SysTime_Counts(void);
+
+/**
+ * @brief TA0 counts per ms (SMCLK / 8000), to convert SysTime_Counts() differences.
+ */
+uint16_t SysTime_CountsPerMs(void);
+
+/**
+ * @brief Milliseconds elapsed since start (wrap-safe).
+ */
+#define TIME_ELAPSED(start) ((uint32_t)(SysTime_Now() - (uint32_t)(start)))
+
+/**
+ * @brief Non-zero once limit ms have elapsed since start.
+ */
+#define TIME_EXPIRED(start, limit) (TIME_ELAPSED(start) >= (uint32_t)(limit))
+
+#endif /* SYSTIME_H */
@@ -0,0 +1,194 @@
+/**
+ * @file tpack.c
+ * @brief Streaming telemetry compression: per-channel delta, zigzag, adaptive Rice codes.
+ *
+ * Key patterns:
+ * - Rice code of u with parameter k: q = u >> k ones, a zero, then the k low bits.
+ *   k is the smallest value with 2^k >= the channel's running mean, as in LOCO-I, and
+ *   is recomputed from the mean after every sample, identically in the decoder
+ * - Bits go out LSB first through a 32-bit accumulator; every write is at most 16
+ *   bits, so at most 23 bits are ever pending and each write stores <= 2 bytes
+ * - Every loop has a constant bound (WCET_LOOP_BOUND), so TPack_Put() has a static
+ *   worst case proportional to the channel count and fits a fixed task slice
+ * - The decoder checks every length against the packet, so a corrupt or truncated
+ *   packet is rejected instead of being read past its end
+ */
+
+#include <stddef.h>
+#include "tpack.h"
+#include "wcet.h"
+
+#define MEAN_SHIFT      3u      // mean = 8 x average residual, decays by 1/8 per sample
+#define MEAN_RESET      (1u << MEAN_SHIFT)
+
+/* ---------- Encoder ---------- */
+
+static void put_bits(tpack_t *p, uint16_t v, uint8_t n)
+{
+    p->acc |= (uint32_t)v << p->nbits;
+    p->nbits += n;
+    while (p->nbits >= 8u)
+    {
+        WCET_LOOP_BOUND(2);
+        p->out[p->pos++] = (uint8_t)p->acc;
+        p->acc >>= 8;
+        p->nbits -= 8u;
+    }
+}
+
+static uint8_t rice_k(uint32_t mean)
+{
+    uint8_t k = 0;
+
+    while (k < 15u && ((uint32_t)MEAN_RESET << k) < mean)
+    {
+        WCET_LOOP_BOUND(15);
+        k++;
+    }
+    return k;
+}
+
+int TPack_Init(tpack_t *p, uint8_t channels)
+{
+    if (channels == 0 || channels > TPACK_CHANNELS) return -1;
+    p->channels = channels;
+    p->out = NULL;
+    return 0;
+}
+
+int TPack_Begin(tpack_t *p, uint8_t *buf, uint16_t cap)
+{
+    if (!buf || cap < 1u + TPACK_ROW_MAX(p->channels)) return -1;
+    p->out = buf;
+    p->cap = cap;
+    p->pos = 1;                     // row count, stored by TPack_End()
+    p->acc = 0;
+    p->nbits = 0;
+    p->rows = 0;
+    return 0;
+}
+
+int TPack_Put(tpack_t *p, const uint16_t *row)
+{
+    uint8_t c, k;
+    uint16_t u, q;
+
+    if (p->rows == TPACK_MAX_ROWS || p->pos + TPACK_ROW_MAX(p->channels) > p->cap) return -1;
+
+    for (c = 0; c < p->channels; c++)
+    {
+        WCET_LOOP_BOUND(TPACK_CHANNELS);
+        if (p->rows == 0)
+        {
+            put_bits(p, row[c], 16);
+            p->mean[c] = MEAN_RESET;
+        }
+        else
+        {
+            int16_t d = (int16_t)(row[c] - p->prev[c]);
+
+            u = (uint16_t)((uint16_t)d << 1) ^ (uint16_t)(d >> 15);
+            k = rice_k(p->mean[c]);
+            q = u >> k;
+            if (q < TPACK_RICE_LIMIT)
+            {
+                put_bits(p, (uint16_t)((1u << q) - 1u), (uint8_t)(q + 1u));
+                if (k) put_bits(p, u & (uint16_t)((1u << k) - 1u), k);
+            }
+            else
+            {
+                put_bits(p, (1u << TPACK_RICE_LIMIT) - 1u, TPACK_RICE_LIMIT);
+                put_bits(p, u, 16);
+            }
+            p->mean[c] += u - (p->mean[c] >> MEAN_SHIFT);
+        }
+        p->prev[c] = row[c];
+    }
+    p->rows++;
+    return 0;
+}
+
+uint16_t TPack_End(tpack_t *p)
+{
+    if (!p->out || p->rows == 0) return 0;
+    if (p->nbits) put_bits(p, 0, (uint8_t)(8u - p->nbits));
+    p->out[0] = p->rows;
+    p->out = NULL;
+    return p->pos;
+}
+
+/* ---------- Decoder ---------- */
+
+typedef struct {
+    const uint8_t *in;
+    uint16_t       len;
+    uint16_t       pos;
+    uint32_t       acc;
+    uint8_t        nbits;
+} bit_reader_t;
+
+static int get_bits(bit_reader_t *r, uint8_t n, uint16_t *v)
+{
+    while (r->nbits < n)
+    {
+        WCET_LOOP_BOUND(2);
+        if (r->pos == r->len) return -1;
+        r->acc |= (uint32_t)r->in[r->pos++] << r->nbits;
+        r->nbits += 8u;
+    }
+    *v = (uint16_t)(r->acc & ((1ul << n) - 1u));
+    r->acc >>= n;
+    r->nbits -= n;
+    return 0;
+}
+
+int TPack_Decode(const uint8_t *pkt, uint16_t len, uint8_t channels,
+                 uint16_t *rows, uint16_t max_rows)
+{
+    bit_reader_t r = { pkt, len, 1, 0, 0 };
+    uint32_t mean[TPACK_CHANNELS];
+    uint16_t n, i, u, bit, lo;
+    uint8_t c, k, q;
+
+    if (len < 1u || channels == 0 || channels > TPACK_CHANNELS) return -1;
+    n = pkt[0];
+    if (n == 0 || n > max_rows) return -1;
+
+    for (i = 0; i < n; i++)
+    {
+        for (c = 0; c < channels; c++)
+        {
+            uint16_t *out = &rows[i * channels + c];
+
+            if (i == 0)
+            {
+                if (get_bits(&r, 16, out) != 0) return -1;
+                mean[c] = MEAN_RESET;
+                continue;
+            }
+            k = rice_k(mean[c]);
+            for (q = 0; q < TPACK_RICE_LIMIT; q++)
+            {
+                if (get_bits(&r, 1, &bit) != 0) return -1;
+                if (!bit) break;
+            }
+            if (q == TPACK_RICE_LIMIT)
+            {
+                if (get_bits(&r, 16, &u) != 0) return -1;
+            }
+            else
+            {
+                lo = 0;
+                if (k && get_bits(&r, k, &lo) != 0) return -1;
+                if (((uint32_t)q << k) > 0xFFFFu) return -1;
+                u = (uint16_t)(((uint16_t)q << k) | lo);
+            }
+            mean[c] += u - (mean[c] >> MEAN_SHIFT);
+            *out = (uint16_t)(rows[(i - 1u) * channels + c] +
+                              (uint16_t)((u >> 1) ^ (uint16_t)-(int16_t)(u & 1u)));
+        }
+    }
+    /* Only the zero padding of the last byte may be left */
+    if (r.pos != len || (r.acc & ((1ul << r.nbits) - 1u))) return -1;
+    return n;
+}
@@ -0,0 +1,80 @@
+/**
+ * @file tpack.h
+ * @brief Streaming telemetry compression: per-channel delta, zigzag, adaptive Rice codes.
+ *
+ * - A row is one sample of each of 1..TPACK_CHANNELS 16-bit channels. TPack_Put()
+ *   encodes the difference to the channel's previous sample, zigzag-mapped to unsigned
+ *   (0, -1, 1, -2 ... -> 0, 1, 2, 3 ...), as a Rice code whose parameter follows the
+ *   channel's recent residuals: slowly varying signals cost 2..4 bits per sample
+ * - Constant work per channel: no look-ahead, no tables; a residual whose quotient
+ *   would exceed TPACK_RICE_LIMIT is escaped and sent raw, so a row never takes more
+ *   than TPACK_ROW_MAX() bytes
+ * - Output is packets of up to 255 rows in a caller buffer (e.g. a blklog.h record or
+ *   a UART frame). Every packet starts with its row count and raw first row, so it
+ *   decodes on its own; TPack_Decode() is the matching decoder (host/tpackchk.c)
+ */
+
+#ifndef TPACK_H
+#define TPACK_H
+
+#include <stdint.h>
+
+#define TPACK_CHANNELS      8u
+#define TPACK_RICE_LIMIT    12u     // unary quotient bits before the raw escape
+#define TPACK_MAX_ROWS      255u
+
+/* Worst-case encoded size of one row; the +1 covers the pending bits of the packet */
+#define TPACK_ROW_MAX(ch)   ((uint16_t)(((ch) * (TPACK_RICE_LIMIT + 16u) + 7u) / 8u + 1u))
+
+/**
+ * @struct tpack_t
+ * @brief Encoder state; caller-owned, one per stream.
+ */
+typedef struct {
+    uint8_t  *out;                          /**< Packet buffer from TPack_Begin() */
+    uint16_t  cap;
+    uint16_t  pos;                          /**< Bytes completed in out */
+    uint32_t  acc;                          /**< Bits not yet stored, LSB first */
+    uint8_t   nbits;
+    uint8_t   channels;
+    uint8_t   rows;                         /**< Rows in the current packet */
+    uint16_t  prev[TPACK_CHANNELS];
+    uint32_t  mean[TPACK_CHANNELS];         /**< Scaled running mean of the residuals */
+} tpack_t;
+
+/**
+ * @brief Set the channel count (1..TPACK_CHANNELS).
+ *
+ * @return 0 on success, -1 on a bad count.
+ */
+int TPack_Init(tpack_t *p, uint8_t channels);
+
+/**
+ * @brief Start a packet in buf (at least 1 + TPACK_ROW_MAX(channels) bytes).
+ */
+int TPack_Begin(tpack_t *p, uint8_t *buf, uint16_t cap);
+
+/**
+ * @brief Encode one row; bounded time, no loop over earlier samples.
+ *
+ * @return 0 if encoded, -1 if the packet is full (end it and put the row in the next).
+ */
+int TPack_Put(tpack_t *p, const uint16_t *row);
+
+/**
+ * @brief Finish the packet (pad to a byte, store the row count).
+ *
+ * @return Packet length in bytes, 0 if it holds no rows.
+ */
+uint16_t TPack_End(tpack_t *p);
+
+/**
+ * @brief Decode one packet.
+ *
+ * @param rows Output, channels values per row, room for max_rows rows.
+ * @return Rows decoded, -1 if the packet is malformed or has more than max_rows rows.
+ */
+int TPack_Decode(const uint8_t *pkt, uint16_t len, uint8_t channels,
+                 uint16_t *rows, uint16_t max_rows);
+
+#endif /* TPACK_H */
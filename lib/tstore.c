@@ -0,0 +1,252 @@
+/**
+ * @file tstore.c
+ * @brief Time-series ring store in FRAM: fixed-size records, sparse index, range cursors.
+ *
+ * Key patterns:
+ * - Records are numbered by an absolute 32-bit count; record a sits in slot
+ *   a % TSTORE_RECORDS and the ring holds [count - TSTORE_CAPACITY, count). The
+ *   TSTORE_BATCH slots behind the oldest record are what a commit writes, so committing
+ *   never touches a record that is still valid, and a cursor run survives several
+ *   commits
+ * - Two FRAM headers (count and ~count) are written alternately after the records:
+ *   a torn header fails its check and the mount falls back to the other one
+ * - FRAM writes happen only in commit(), between one TSTORE_UNLOCK() and
+ *   TSTORE_LOCK(): with the MPU enabled that is one MPUSAM change per batch instead
+ *   of one per record. Host builds override both (host/tseries.c)
+ * - The index is SRAM only (4 bytes per stride), rebuilt from FRAM by TStore_Init():
+ *   searching it costs no FRAM wait states and it can never disagree with the records
+ */
+
+#include <msp430.h>
+#include <stddef.h>
+#include <string.h>
+#include "tstore.h"
+
+#define INDEX_SIZE      (TSTORE_RECORDS / TSTORE_STRIDE)
+
+#if defined(__GNUC__) && defined(__MSP430__)
+#define TSTORE_FRAM_ATTR __attribute__((section(".persistent")))
+#else
+#define TSTORE_FRAM_ATTR
+#endif
+
+typedef struct {
+    uint16_t magic;
+    uint16_t rec_size;
+    uint16_t records;
+    uint16_t reserved;
+    uint32_t count;
+    uint32_t count_inv;
+} tstore_hdr_t;
+
+static tstore_rec_t ring[TSTORE_RECORDS] TSTORE_FRAM_ATTR;
+static tstore_hdr_t hdr[2] TSTORE_FRAM_ATTR;
+
+static tstore_rec_t batch[TSTORE_BATCH];
+static uint8_t batch_len;
+static uint8_t hdr_cur;                 // header holding the committed count
+static uint32_t count;                  // records committed since format
+static uint32_t last_t;                 // newest timestamp, batch included
+static uint32_t index_t[INDEX_SIZE];    // time of record k * TSTORE_STRIDE
+static tstore_stats_t stats;
+
+/* ---------- FRAM write access ---------- */
+
+#ifndef TSTORE_UNLOCK
+#define TSTORE_UNLOCK()     fram_unlock()
+#define TSTORE_LOCK(sam)    fram_lock(sam)
+
+/* With the MPU enabled, open all main-memory segments for writing; else nothing to do */
+static uint16_t fram_unlock(void)
+{
+    uint16_t sam = 0;
+
+    if (MPUCTL0 & MPUENA)
+    {
+        MPUCTL0_H = MPUPW_H;
+        sam = MPUSAM;
+        MPUSAM = sam | MPUSEG1WE | MPUSEG2WE | MPUSEG3WE;
+    }
+    return sam;
+}
+
+static void fram_lock(uint16_t sam)
+{
+    if (MPUCTL0 & MPUENA)
+    {
+        MPUSAM = sam;
+        MPUCTL0_H = 0;                  // lock the MPU registers again
+    }
+}
+#endif
+
+/* ---------- Ring ---------- */
+
+static uint32_t oldest(void)
+{
+    return count > TSTORE_CAPACITY ? count - TSTORE_CAPACITY : 0;
+}
+
+static const tstore_rec_t *rec_at(uint32_t a)
+{
+    return &ring[a % TSTORE_RECORDS];
+}
+
+static uint8_t hdr_valid(const tstore_hdr_t *h)
+{
+    return h->magic == TSTORE_MAGIC && h->rec_size == sizeof(tstore_rec_t) &&
+           h->records == TSTORE_RECORDS && h->count_inv == ~h->count;
+}
+
+static void hdr_write(tstore_hdr_t *h, uint32_t n)
+{
+    h->magic = TSTORE_MAGIC;
+    h->rec_size = sizeof(tstore_rec_t);
+    h->records = TSTORE_RECORDS;
+    h->reserved = 0;
+    h->count = n;
+    h->count_inv = ~n;
+}
+
+static void commit(void)
+{
+    uint16_t slot = (uint16_t)(count % TSTORE_RECORDS);
+    uint16_t first = TSTORE_RECORDS - slot;
+    uint16_t sam;
+    uint8_t i;
+
+    if (first > batch_len) first = batch_len;
+    sam = TSTORE_UNLOCK();
+    memcpy(&ring[slot], batch, first * sizeof(tstore_rec_t));
+    memcpy(&ring[0], &batch[first], (batch_len - first) * sizeof(tstore_rec_t));
+    hdr_write(&hdr[hdr_cur ^ 1u], count + batch_len);
+    TSTORE_LOCK(sam);
+
+    for (i = 0; i < batch_len; i++)
+        if ((count + i) % TSTORE_STRIDE == 0)
+            index_t[((count + i) / TSTORE_STRIDE) % INDEX_SIZE] = batch[i].t;
+    hdr_cur ^= 1u;
+    count += batch_len;
+    batch_len = 0;
+    stats.commits++;
+}
+
+/*
+ * First committed record with t >= from: binary search over the index entries inside
+ * the ring, then over the records between the two entries that bracket it.
+ */
+static uint32_t lower_bound(uint32_t from)
+{
+    uint32_t lo = oldest(), hi = count, m;
+    uint32_t kl = (lo + TSTORE_STRIDE - 1u) / TSTORE_STRIDE;
+    uint32_t kh = (hi + TSTORE_STRIDE - 1u) / TSTORE_STRIDE;
+
+    while (kl < kh)
+    {
+        m = kl + (kh - kl) / 2u;
+        if (index_t[m % INDEX_SIZE] < from) kl = m + 1u;
+        else kh = m;
+    }
+    if (kl * TSTORE_STRIDE < hi) hi = kl * TSTORE_STRIDE;
+    if (kl > 0 && (kl - 1u) * TSTORE_STRIDE > lo) lo = (kl - 1u) * TSTORE_STRIDE;
+
+    while (lo < hi)
+    {
+        m = lo + (hi - lo) / 2u;
+        if (rec_at(m)->t < from) lo = m + 1u;
+        else hi = m;
+    }
+    return lo;
+}
+
+/* ---------- API ---------- */
+
+int TStore_Init(void)
+{
+    uint8_t v0 = hdr_valid(&hdr[0]), v1 = hdr_valid(&hdr[1]);
+    int formatted = 0;
+    uint32_t k;
+    uint16_t sam;
+
+    batch_len = 0;
+    memset(&stats, 0, sizeof(stats));
+    if (v0 || v1)
+    {
+        hdr_cur = (v1 && (!v0 || hdr[1].count > hdr[0].count)) ? 1u : 0u;
+        count = hdr[hdr_cur].count;
+    }
+    else
+    {
+        sam = TSTORE_UNLOCK();
+        hdr_write(&hdr[0], 0);
+        hdr_write(&hdr[1], 0);
+        TSTORE_LOCK(sam);
+        hdr_cur = 0;
+        count = 0;
+        formatted = 1;
+    }
+
+    for (k = (oldest() + TSTORE_STRIDE - 1u) / TSTORE_STRIDE; k * TSTORE_STRIDE < count; k++)
+        index_t[k % INDEX_SIZE] = rec_at(k * TSTORE_STRIDE)->t;
+    last_t = count ? rec_at(count - 1u)->t : 0;
+    return formatted;
+}
+
+int TStore_Append(uint32_t t, const uint16_t *v)
+{
+    if (t < last_t)
+    {
+        stats.rejected++;
+        return -1;
+    }
+    batch[batch_len].t = t;
+    memcpy(batch[batch_len].v, v, sizeof(batch[0].v));
+    last_t = t;
+    stats.appended++;
+    if (++batch_len == TSTORE_BATCH) commit();
+    return 0;
+}
+
+void TStore_Flush(void)
+{
+    if (batch_len) commit();
+}
+
+uint32_t TStore_Count(void)
+{
+    return count - oldest();
+}
+
+uint32_t TStore_Seek(tstore_cursor_t *c, uint32_t from, uint32_t to)
+{
+    c->pos = lower_bound(from);
+    c->end = to > from ? lower_bound(to) : c->pos;
+    c->lost = 0;
+    return c->end - c->pos;
+}
+
+uint16_t TStore_Next(tstore_cursor_t *c, const tstore_rec_t **rec, uint16_t max)
+{
+    uint32_t first = oldest(), n;
+    uint16_t slot;
+
+    if (c->pos < first)
+    {
+        c->lost += (c->end < first ? c->end : first) - c->pos;
+        c->pos = first;
+    }
+    if (c->pos >= c->end) return 0;
+
+    slot = (uint16_t)(c->pos % TSTORE_RECORDS);
+    n = c->end - c->pos;
+    if (n > TSTORE_RECORDS - slot) n = TSTORE_RECORDS - slot;
+    if (n > max) n = max;
+    *rec = &ring[slot];
+    c->pos += n;
+    return (uint16_t)n;
+}
+
+const tstore_stats_t *TStore_GetStats(void)
+{
+    return &stats;
+}
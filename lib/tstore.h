@@ -0,0 +1,108 @@
+/**
+ * @file tstore.h
+ * @brief Time-series ring store in FRAM: fixed-size records, sparse index, range cursors.
+ *
+ * - Records (timestamp + TSTORE_VALUES samples) live in a FRAM ring (.persistent) and
+ *   survive reset; timestamps must not decrease, which keeps the ring sorted by time
+ * - TStore_Append() collects records in an SRAM batch; a full batch (or TStore_Flush())
+ *   is committed with one MPU unlock: records first, then the header count, so a reset
+ *   mid-commit leaves the previous state
+ * - An SRAM index holds the time of every TSTORE_STRIDE-th record; TStore_Seek() binary
+ *   searches it, then the records of one stride: O(log n) FRAM reads for any range
+ * - TStore_Next() hands out runs of records in place, ready to be sent with
+ *   Uart_AioTx (aio.h) without copying them to SRAM
+ */
+
+#ifndef TSTORE_H
+#define TSTORE_H
+
+#include <stdint.h>
+
+#define TSTORE_RECORDS      1024u   // ring slots (12 KB of FRAM)
+#define TSTORE_VALUES       4u      // samples per record
+#define TSTORE_STRIDE       32u     // records per index entry
+#define TSTORE_BATCH        8u      // records per FRAM commit
+#define TSTORE_CAPACITY     (TSTORE_RECORDS - TSTORE_BATCH)  // a commit never touches these
+#define TSTORE_MAGIC        0x5453u
+
+/**
+ * @struct tstore_rec_t
+ * @brief One record as stored (and as sent by a cursor).
+ */
+typedef struct {
+    uint32_t t;                         /**< Timestamp, e.g. SysTime ms */
+    uint16_t v[TSTORE_VALUES];
+} tstore_rec_t;
+
+/**
+ * @struct tstore_cursor_t
+ * @brief Position in a time range, from TStore_Seek().
+ */
+typedef struct {
+    uint32_t pos;                       /**< Next record (absolute number) */
+    uint32_t end;                       /**< First record after the range */
+    uint32_t lost;                      /**< Records overwritten before they were read */
+} tstore_cursor_t;
+
+/**
+ * @struct tstore_stats_t
+ * @brief Counters since TStore_Init().
+ */
+typedef struct {
+    uint32_t appended;                  /**< Records accepted */
+    uint16_t commits;                   /**< FRAM commits (MPU unlocks) */
+    uint16_t rejected;                  /**< Records older than the newest one */
+} tstore_stats_t;
+
+/**
+ * @brief Mount the ring from FRAM, or format it if no valid header is found.
+ *
+ * @return 0 if mounted, 1 if formatted (empty).
+ */
+int TStore_Init(void);
+
+/**
+ * @brief Add a record; commits to FRAM when the batch is full. Task context only.
+ *
+ * @param t Timestamp, >= the previous one.
+ * @param v TSTORE_VALUES samples.
+ * @return 0 on success, -1 if t is older than the newest record.
+ */
+int TStore_Append(uint32_t t, const uint16_t *v);
+
+/**
+ * @brief Commit a partly filled batch now (before a query or a planned shutdown).
+ */
+void TStore_Flush(void);
+
+/**
+ * @brief Committed records in the ring (at most TSTORE_CAPACITY).
+ */
+uint32_t TStore_Count(void);
+
+/**
+ * @brief Position a cursor on the committed records with from <= t < to.
+ *
+ * @return Records in the range.
+ */
+uint32_t TStore_Seek(tstore_cursor_t *c, uint32_t from, uint32_t to);
+
+/**
+ * @brief Next run of records of the range, contiguous in FRAM.
+ *
+ * The run stays intact until about (its first record - oldest record) more records
+ * are appended; records overwritten before they were reached are skipped and counted
+ * in c->lost.
+ *
+ * @param rec Set to the first record of the run.
+ * @param max Records wanted at most.
+ * @return Records in the run, 0 at the end of the range.
+ */
+uint16_t TStore_Next(tstore_cursor_t *c, const tstore_rec_t **rec, uint16_t max);
+
+/**
+ * @brief Counters since TStore_Init().
+ */
+const tstore_stats_t *TStore_GetStats(void);
+
+#endif /* TSTORE_H */
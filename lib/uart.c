@@ -0,0 +1,298 @@
+/**
+ * @file uart.c
+ * @brief Blocking eUSCI_A0 UART with printf() redirection, plus aio.h drivers.
+ *
+ * Key patterns:
+ * - Vectored writes: one DMA block transfer per segment, from the segment's own
+ *   memory to TXBUF; the DMA interrupt of a segment starts the next one, the last one
+ *   releases the message. The queue is an intrusive list, as in bus.c
+ * - Host builds replace UART_DMA_INIT/UART_DMA_START with a model and report segment
+ *   ends through txv_segment_done() (host/txvloop.c)
+ */
+
+#include <msp430.h>
+#include <stddef.h>
+#include "clock.h"
+#include "uart.h"
+#include "wcet.h"
+
+static uart_txv_t *volatile txv_head;   // message being sent, NULL if idle
+static uint16_t txv_lost;               // done callbacks not posted (defer ring full)
+
+static void txv_segment_done(void);
+
+/* ---------- Hardware layer: DMA channel 2 ---------- */
+
+#ifndef UART_DMA_START
+#define UART_DMA_INIT()             dma_init()
+#define UART_DMA_START(base, len)   dma_start(base, len)
+
+#define DMA_TRIG_UCA0TX 15u             // UCA0TXIFG on channels 0-2
+
+static void dma_init(void)
+{
+    DMACTL1 = (DMACTL1 & 0xFF00u) | DMA_TRIG_UCA0TX;    // ch2; ch3 belongs to bus.c
+    DMACTL4 = DMARMWDIS;
+}
+
+/*
+ * TXIFG is edge-triggered for the DMA. Behind a previous segment TXBUF is still full
+ * and its emptying is the edge; on an idle UART TXIFG is already high, so pulse it.
+ */
+static void dma_start(const void *base, uint16_t len)
+{
+    volatile uint16_t *ch = &DMA2CTL;   // CTL, SA (20 bit), DA (20 bit), SZ
+
+    ch[0] = 0;
+    *(volatile uint32_t *)&ch[1] = (uint32_t)(uintptr_t)base;   // low word first
+    *(volatile uint32_t *)&ch[3] = (uint32_t)(uintptr_t)&UCA0TXBUF;
+    ch[5] = len;
+    ch[0] = DMADT_0 | DMASRCBYTE | DMADSTBYTE | DMASRCINCR_3 | DMADSTINCR_0 | DMAIE | DMAEN;
+    if (UCA0IFG & UCTXIFG)
+    {
+        UCA0IFG &= ~UCTXIFG;
+        UCA0IFG |= UCTXIFG;
+    }
+}
+
+uint8_t Uart_DmaIsr(uint16_t dmaiv)
+{
+    if (dmaiv != DMAIV_DMA2IFG) return 0;
+    txv_segment_done();
+    return 1;
+}
+#endif /* UART_DMA_START */
+
+int uart_putchar(int c)
+{
+    while (!(UCA0IFG & UCTXIFG))
+    {
+        /* Wait until buffer is ready */
+    }
+
+    UCA0TXBUF = c;
+    return c;
+}
+
+int _write(int file, char *ptr, int len)
+{
+    int i;
+
+    (void)file;
+    if (__get_interrupt_state() & GIE)
+    {
+        while (txv_head)
+        {
+            /* Keep printf() output behind queued vectored messages */
+        }
+    }
+    for (i = 0; i < len; i++)
+    {
+        uart_putchar((int)ptr[i]);
+    }
+
+    return len;
+}
+
+/* ---------- Asynchronous requests (aio.h) ---------- */
+
+static aio_req_t *tx_req;           // running AIO_WRITE, NULL if none
+static aio_req_t *rx_req;           // running AIO_READ, NULL if none
+
+/* TXIFG is set while TXBUF is empty, so enabling UCTXIE sends the first byte */
+static int tx_start(aio_req_t *req)
+{
+    if (req->op != AIO_WRITE || !req->buf) return -1;
+    tx_req = req;
+    UCA0IE |= UCTXIE;
+    return 0;
+}
+
+static int tx_cancel(aio_req_t *req)
+{
+    (void)req;
+    UCA0IE &= ~UCTXIE;
+    tx_req = NULL;
+    return 0;
+}
+
+static int rx_start(aio_req_t *req)
+{
+    if (req->op != AIO_READ || !req->buf) return -1;
+    rx_req = req;
+    UCA0IE |= UCRXIE;
+    return 0;
+}
+
+static int rx_cancel(aio_req_t *req)
+{
+    (void)req;
+    UCA0IE &= ~UCRXIE;
+    rx_req = NULL;
+    return 0;
+}
+
+const aio_ops_t Uart_AioTx = { tx_start, tx_cancel };
+const aio_ops_t Uart_AioRx = { rx_start, rx_cancel };
+
+void Uart_Isr(void)
+{
+    aio_req_t *req;
+
+    switch (UCA0IV)
+    {
+        case USCI_UART_UCRXIFG:
+            req = rx_req;
+            if (!req)
+            {
+                (void)UCA0RXBUF;
+                break;
+            }
+            req->buf[req->count++] = (uint8_t)UCA0RXBUF;
+            if (req->count == req->len)
+            {
+                UCA0IE &= ~UCRXIE;
+                rx_req = NULL;
+                Aio_Complete(req, AIO_OK);
+            }
+            break;
+        case USCI_UART_UCTXIFG:
+            req = tx_req;
+            if (!req)
+            {
+                UCA0IE &= ~UCTXIE;
+                break;
+            }
+            UCA0TXBUF = req->buf[req->count++];
+            if (req->count == req->len)
+            {
+                /* Done once the last byte is in TXBUF; the next write starts behind it */
+                UCA0IE &= ~UCTXIE;
+                tx_req = NULL;
+                Aio_Complete(req, AIO_OK);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+void Uart_Init(void)
+{
+    /* Configure GPIO */
+    P2SEL1 |= BIT0 + BIT1;              /* Activate Pin for UART use */
+    P2SEL0 &= ~(BIT0 + BIT1);           /* Activate Pin for UART use */
+
+    /* Configure USCI_A0 for UART mode */
+    UCA0CTLW0 = UCSWRST;                /* Put eUSCI in reset */
+    UCA0CTLW0 |= UCSSEL__SMCLK;         /* CLK = SMCLK */
+
+    /* 115200 bps, oversampling mode. Values from the FR5xx user's guide
+     * baud rate table (UCBRx, UCBRFx, UCBRSx):
+     *   1 MHz:  N = 8.68   -> 8, -, 0xD6 (N < 16: no oversampling)
+     *   8 MHz:  N = 69.44  -> 4, 5, 0x55
+     *   16 MHz: N = 138.89 -> 8, 10, 0xF7
+     */
+    switch (Clk_GetHz())
+    {
+        case 8000000UL:
+            UCA0BRW = 4;
+            UCA0MCTLW = UCOS16 | UCBRF_5 | 0x5500;
+            break;
+        case 16000000UL:
+            UCA0BRW = 8;
+            UCA0MCTLW = UCOS16 | UCBRF_10 | 0xF700;
+            break;
+        default:
+            UCA0BRW = 8;
+            UCA0MCTLW = 0xD600;
+            break;
+    }
+
+    UCA0CTLW0 &= ~UCSWRST;              /* Initialize eUSCI */
+    txv_lost = 0;
+    UART_DMA_INIT();
+}
+
+/* ---------- Vectored writes ---------- */
+
+static uart_txv_t *txv_tail;
+static uint8_t txv_seg;                 // segment of txv_head being sent
+
+/* Start the next non-empty segment; release messages that have none left (GIE clear) */
+static void txv_start(void)
+{
+    uart_txv_t *m;
+
+    while ((m = txv_head) != NULL)
+    {
+        WCET_LOOP_BOUND(2);             // every queued message has a non-empty segment
+        for (; txv_seg < m->iovcnt; txv_seg++)
+        {
+            WCET_LOOP_BOUND(255);
+            if (m->iov[txv_seg].len)
+            {
+                UART_DMA_START(m->iov[txv_seg].base, m->iov[txv_seg].len);
+                return;
+            }
+        }
+        txv_head = m->next;
+        if (!txv_head) txv_tail = NULL;
+        txv_seg = 0;
+        m->status = UART_OK;            // also seen by pollers if the post fails
+        if (m->done && Defer_Post(DEFER_PRIO_NORMAL, m->done, (uintptr_t)m) != 0)
+            txv_lost++;
+    }
+}
+
+/* Called by the hardware layer (ISR context) when a segment is in TXBUF */
+static void txv_segment_done(void)
+{
+    if (!txv_head) return;
+    txv_seg++;
+    txv_start();
+}
+
+int Uart_WriteV(uart_txv_t *m)
+{
+    uint16_t sr;
+    uint8_t i;
+
+    if (!m || !m->iov) return -1;
+    for (i = 0; i < m->iovcnt && !m->iov[i].len; i++) { }
+    if (i == m->iovcnt) return -1;
+
+    sr = __get_interrupt_state();
+    __disable_interrupt();
+    if (m->status == UART_PENDING)
+    {
+        __set_interrupt_state(sr);
+        return -1;
+    }
+    m->status = UART_PENDING;
+    m->next = NULL;
+    if (txv_head)
+    {
+        txv_tail->next = m;
+        txv_tail = m;
+    }
+    else
+    {
+        txv_head = m;
+        txv_tail = m;
+        txv_seg = 0;
+        txv_start();
+    }
+    __set_interrupt_state(sr);
+    return 0;
+}
+
+uint8_t Uart_TxvBusy(void)
+{
+    return txv_head != NULL;
+}
+
+uint16_t Uart_TxvLostEvents(void)
+{
+    return txv_lost;
+}
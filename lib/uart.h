@@ -0,0 +1,113 @@
+/**
+ * @file uart.h
+ * @brief Blocking eUSCI_A0 UART (P2.0 TX / P2.1 RX) with printf() redirection.
+ *
+ * Asynchronous transfers go through aio.h: attach Uart_AioTx and Uart_AioRx to two
+ * device numbers and call Uart_Isr() from the USCI_A0 ISR. Blocking output (printf())
+ * interleaves with a running AIO_WRITE, so an application uses one or the other.
+ *
+ * Uart_WriteV() sends a message given as a list of segments (header in SRAM, payload
+ * in FRAM, CRC ...) by DMA channel 2, straight from where each segment lives; call
+ * Uart_DmaIsr(DMAIV) from the DMA ISR. It is a third TX path: don't mix it with
+ * AIO_WRITE. _write() waits for queued messages, so printf() output stays behind them.
+ */
+
+#ifndef UART_H
+#define UART_H
+
+#include <stdint.h>
+#include "defer.h"
+#include "aio.h"
+
+#define UART_OK         0
+#define UART_PENDING    1
+
+/**
+ * @struct uart_iov_t
+ * @brief One segment of a message; the bytes stay where they are until sent.
+ */
+typedef struct {
+    const void *base;
+    uint16_t    len;                /**< Bytes, 0 = skipped */
+} uart_iov_t;
+
+/**
+ * @struct uart_txv_t
+ * @brief A queued message; caller-owned, like its segment list and their buffers.
+ */
+typedef struct uart_txv {
+    struct uart_txv  *next;         /**< Engine queue link */
+    const uart_iov_t *iov;
+    uint8_t           iovcnt;
+    volatile int8_t   status;       /**< UART_PENDING while queued or sending, then UART_OK */
+    defer_fn_t        done;         /**< Posted with arg = message when the buffers are free */
+} uart_txv_t;
+
+/** aio.h driver: AIO_WRITE, one byte per TX interrupt; cancel stops after the current byte */
+extern const aio_ops_t Uart_AioTx;
+
+/** aio.h driver: AIO_READ, completes once len bytes have arrived; cancel keeps the count */
+extern const aio_ops_t Uart_AioRx;
+
+/**
+ * @brief Initialize eUSCI_A0 for 115200 8N1 from SMCLK.
+ *
+ * Baud divisors are picked for the speed set by Clk_Init(), so call that first.
+ */
+void Uart_Init(void);
+
+/**
+ * @brief Transmit a single byte over UART (blocking).
+ *
+ * @param c Character to transmit.
+ * @return Transmitted character.
+ */
+int uart_putchar(int c);
+
+/**
+ * @brief Simple POSIX-like write to route printf() to UART.
+ *
+ * @param file File descriptor (ignored).
+ * @param ptr Pointer to buffer.
+ * @param len Length of buffer.
+ * @return Number of bytes written.
+ */
+int _write(int file, char *ptr, int len);
+
+/**
+ * @brief RX/TX events of the aio.h drivers: call from the USCI_A0 ISR.
+ */
+void Uart_Isr(void);
+
+/**
+ * @brief Queue a message for DMA transmission; never blocks, callable from ISRs.
+ *
+ * Messages go out in submission order, each segment in turn, without being copied.
+ * Segments and their bytes must stay unchanged until status leaves UART_PENDING:
+ * that happens once the last byte is in TXBUF, and done (if any) runs then as
+ * deferred work, so it may reuse the buffers or queue the next message. If the defer
+ * ring is full, done is not posted: the loss is counted (Uart_TxvLostEvents()) and
+ * the buffers are free as soon as status is UART_OK.
+ *
+ * @return 0 if queued, -1 if it is still pending or has no bytes.
+ */
+int Uart_WriteV(uart_txv_t *m);
+
+/**
+ * @brief Segment completion: call from the DMA ISR with the DMAIV value.
+ *
+ * @return 1 if the event was channel 2's, 0 otherwise (pass it on, e.g. to Bus_DmaIsr()).
+ */
+uint8_t Uart_DmaIsr(uint16_t dmaiv);
+
+/**
+ * @brief Non-zero while vectored messages are queued or being sent.
+ */
+uint8_t Uart_TxvBusy(void);
+
+/**
+ * @brief Release callbacks not posted since Uart_Init() (defer ring full).
+ */
+uint16_t Uart_TxvLostEvents(void);
+
+#endif /* UART_H */
@@ -0,0 +1,68 @@
+/**
+ * @file wcet.h
+ * @brief Annotations read by tools/wcet.py (static WCET check at build time).
+ *
+ * The macros only emit records into non-loaded ELF sections, no code:
+ * - WCET_LOOP_BOUND(n) inside a loop body: at most n back-edge iterations
+ * - WCET_SLICE(fn, ms) at file scope: fn must fit in ms at the declared clock
+ * - WCET_CLOCK_HZ(hz) at file scope: MCLK used to convert cycles to ms
+ * - WCET_ISR_RATE(isr, hz, cycles) at file scope: isr fires at hz instead of once
+ *   per tick; cycles > 0 replaces its static bound (ISRs that call through a table)
+ * - WCET_ISR_BUDGET(cycles) at file scope: every ISR must be bounded by cycles
+ *
+ * Arguments must be integer literals (or macros expanding to one).
+ * Simple counted loops (mov #N, Rx ... dec Rx; jnz), such as those emitted for
+ * __delay_cycles(), are bounded automatically.
+ */
+
+#ifndef WCET_H
+#define WCET_H
+
+#define WCET_STR_(x) #x
+#define WCET_STR(x)  WCET_STR_(x)
+
+#if defined(__GNUC__) && defined(__MSP430__)
+
+#define WCET_LOOP_BOUND(n)                              \
+    __asm__ volatile ("1:\n"                            \
+                      "\t.pushsection .wcet_bounds,\"\"\n" \
+                      "\t.long 1b\n"                    \
+                      "\t.long " WCET_STR(n) "\n"       \
+                      "\t.popsection\n")
+
+#define WCET_SLICE(fn, ms)                              \
+    __asm__ ("\t.pushsection .wcet_slices,\"\"\n"       \
+             "\t.long " WCET_STR(ms) "\n"               \
+             "\t.asciz \"" #fn "\"\n"                   \
+             "\t.balign 4\n"                            \
+             "\t.popsection\n")
+
+#define WCET_CLOCK_HZ(hz)                               \
+    __asm__ ("\t.pushsection .wcet_clock,\"\"\n"        \
+             "\t.long " WCET_STR(hz) "\n"               \
+             "\t.popsection\n")
+
+#define WCET_ISR_RATE(isr, hz, cycles)                  \
+    __asm__ ("\t.pushsection .wcet_isr_rates,\"\"\n"    \
+             "\t.long " WCET_STR(hz) "\n"               \
+             "\t.long " WCET_STR(cycles) "\n"           \
+             "\t.asciz \"" #isr "\"\n"                  \
+             "\t.balign 4\n"                            \
+             "\t.popsection\n")
+
+#define WCET_ISR_BUDGET(cycles)                         \
+    __asm__ ("\t.pushsection .wcet_isr_budget,\"\"\n"   \
+             "\t.long " WCET_STR(cycles) "\n"           \
+             "\t.popsection\n")
+
+#else   /* host builds: annotations compile away */
+
+#define WCET_LOOP_BOUND(n)  do { } while (0)
+#define WCET_SLICE(fn, ms)  extern int wcet_unused_
+#define WCET_CLOCK_HZ(hz)   extern int wcet_unused_
+#define WCET_ISR_RATE(isr, hz, cycles) extern int wcet_unused_
+#define WCET_ISR_BUDGET(cycles) extern int wcet_unused_
+
+#endif
+
+#endif /* WCET_H */
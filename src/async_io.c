@@ -0,0 +1,233 @@
+/*
+ * One asynchronous request interface for UART, I2C and ADC (lib/aio.c) @ 8 MHz
+ * - Device 0: UART TX, device 1: UART RX (lib/uart.c), device 2: I2C temperature
+ *   sensor at 0x48 on B0 (lib/bus.c), device 3: ADC12 input A2 on P1.2 (lib/adc.c)
+ * - A 100 ms task submits a sensor read and an 8-sample ADC burst and returns; a burst
+ *   still running from the last period is canceled instead of piling up
+ * - A 1 s task formats a report into one of two line buffers and submits it, so the
+ *   next report can be built while the previous one is still being sent
+ * - A one-byte UART read is always pending; its callback records the key and resubmits
+ *
+ * Key patterns:
+ * - Request blocks are static; status != AIO_PENDING means the block is free again
+ * - Callbacks run from Scheduler_Dispatch(), so they may submit new requests directly
+ * - No printf(): blocking output would interleave with the asynchronous writes
+ */
+
+#include <msp430.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "clock.h"
+#include "systime.h"
+#include "scheduler.h"
+#include "defer.h"
+#include "aio.h"
+#include "uart.h"
+#include "bus.h"
+#include "adc.h"
+
+#define DEV_TX          0u
+#define DEV_RX          1u
+#define DEV_TEMP        2u
+#define DEV_ADC         3u
+
+#define ADC_SAMPLES     8u
+#define LINE_LEN        80u
+
+static void task_100ms(uint32_t now);
+static void task_1s(uint32_t now);
+static void temp_done(aio_req_t *req);
+static void adc_done(aio_req_t *req);
+static void key_done(aio_req_t *req);
+
+static const bus_dev_t temp_dev = { BUS_B0, 0x48, NULL, 0 };
+static const uint8_t temp_reg = 0x00;
+static uint8_t temp_raw[2];
+static uint16_t samples[ADC_SAMPLES];
+static uint8_t key;
+static char line[2][LINE_LEN];
+
+/* Register pointer write, then two bytes after a repeated START */
+static aio_req_t temp_req = { .dev = DEV_TEMP, .op = AIO_READ, .target = &temp_dev,
+                              .cmd = &temp_reg, .cmd_len = 1, .buf = temp_raw,
+                              .len = sizeof(temp_raw), .done = temp_done };
+static aio_req_t adc_req = { .dev = DEV_ADC, .op = AIO_READ, .target = (const void *)2,
+                             .buf = (uint8_t *)samples, .len = sizeof(samples),
+                             .done = adc_done };
+static aio_req_t key_req = { .dev = DEV_RX, .op = AIO_READ, .buf = &key, .len = 1,
+                             .done = key_done };
+static aio_req_t line_req[2] = {
+    { .dev = DEV_TX, .op = AIO_WRITE, .buf = (uint8_t *)line[0] },
+    { .dev = DEV_TX, .op = AIO_WRITE, .buf = (uint8_t *)line[1] },
+};
+
+static int16_t temp_c16;        // 1/16 degree C
+static uint16_t adc_mean;
+static uint16_t adc_canceled = 0;
+static uint16_t lines_skipped = 0;
+static uint8_t last_key = '-';
+
+void Gpio_Init(void)
+{
+    PM5CTL0 &= ~LOCKLPM5;
+    P1DIR |= BIT0;
+    P1OUT &= ~BIT0;
+    P1SEL1 |= BIT2;             // A2
+    P1SEL0 |= BIT2;
+}
+
+/* ---------- ISRs ---------- */
+
+#if defined(__TI_COMPILER_VERSION__) || defined(__IAR_SYSTEMS_ICC__)
+#pragma vector = TIMER0_A0_VECTOR
+__interrupt void Timer0_A0_ISR (void)
+#elif defined(__GNUC__)
+void __attribute__ ((interrupt(TIMER0_A0_VECTOR))) Timer0_A0_ISR (void)
+#else
+#error Compiler not supported!
+#endif
+{
+    SysTime_Tick();
+    Scheduler_TickDeferred();
+    __bic_SR_register_on_exit(LPM0_bits);
+}
+
+/* Every driver ISR may complete a request: wake the main loop to drain it */
+#if defined(__TI_COMPILER_VERSION__) || defined(__IAR_SYSTEMS_ICC__)
+#pragma vector = USCI_A0_VECTOR
+__interrupt void Usci_A0_ISR (void)
+#elif defined(__GNUC__)
+void __attribute__ ((interrupt(USCI_A0_VECTOR))) Usci_A0_ISR (void)
+#else
+#error Compiler not supported!
+#endif
+{
+    Uart_Isr();
+    __bic_SR_register_on_exit(LPM0_bits);
+}
+
+#if defined(__TI_COMPILER_VERSION__) || defined(__IAR_SYSTEMS_ICC__)
+#pragma vector = ADC12_B_VECTOR
+__interrupt void Adc12_ISR (void)
+#elif defined(__GNUC__)
+void __attribute__ ((interrupt(ADC12_B_VECTOR))) Adc12_ISR (void)
+#else
+#error Compiler not supported!
+#endif
+{
+    Adc_Isr();
+    __bic_SR_register_on_exit(LPM0_bits);
+}
+
+#if defined(__TI_COMPILER_VERSION__) || defined(__IAR_SYSTEMS_ICC__)
+#pragma vector = DMA_VECTOR
+__interrupt void Dma_ISR (void)
+#elif defined(__GNUC__)
+void __attribute__ ((interrupt(DMA_VECTOR))) Dma_ISR (void)
+#else
+#error Compiler not supported!
+#endif
+{
+    Bus_DmaIsr(DMAIV);
+    __bic_SR_register_on_exit(LPM0_bits);
+}
+
+#if defined(__TI_COMPILER_VERSION__) || defined(__IAR_SYSTEMS_ICC__)
+#pragma vector = USCI_B0_VECTOR
+__interrupt void Usci_B0_ISR (void)
+#elif defined(__GNUC__)
+void __attribute__ ((interrupt(USCI_B0_VECTOR))) Usci_B0_ISR (void)
+#else
+#error Compiler not supported!
+#endif
+{
+    Bus_UsciIsr(BUS_B0);
+    __bic_SR_register_on_exit(LPM0_bits);
+}
+
+/* ---------- Main superloop ---------- */
+int main(void)
+{
+    WDTCTL = WDTPW | WDTHOLD;
+
+    Clk_Init(CLK_8MHZ);
+    Gpio_Init();
+    Uart_Init();
+    Defer_Init();
+    Bus_Init(BUS_B0, BUS_I2C, 400000u);
+    Adc_Init();
+
+    Aio_Attach(DEV_TX, &Uart_AioTx);
+    Aio_Attach(DEV_RX, &Uart_AioRx);
+    Aio_Attach(DEV_TEMP, &Bus_AioOps);
+    Aio_Attach(DEV_ADC, &Adc_AioOps);
+
+    Scheduler_AddTask(task_100ms, 100, 0, 1);
+    Scheduler_AddTask(task_1s, 1000, 5, 1);
+
+    SysTime_Init();
+    __enable_interrupt();
+    Aio_Submit(&key_req);
+
+    while (1)
+    {
+        Scheduler_Dispatch();
+    }
+}
+
+/* ---------- Completions ---------- */
+
+static void temp_done(aio_req_t *req)
+{
+    if (req->status != AIO_OK) return;
+    temp_c16 = (int16_t)(((uint16_t)temp_raw[0] << 8) | temp_raw[1]) >> 4;
+}
+
+static void adc_done(aio_req_t *req)
+{
+    uint32_t sum = 0;
+    uint8_t i;
+
+    if (req->status != AIO_OK) return;
+    for (i = 0; i < ADC_SAMPLES; i++)
+        sum += samples[i];
+    adc_mean = (uint16_t)(sum / ADC_SAMPLES);
+}
+
+static void key_done(aio_req_t *req)
+{
+    if (req->status == AIO_OK) last_key = key;
+    Aio_Submit(req);
+}
+
+/* ---------- Tasks ---------- */
+
+static void task_100ms(uint32_t now)
+{
+    (void)now;
+    P1OUT ^= BIT0;
+    if (adc_req.status == AIO_PENDING && Aio_Cancel(&adc_req) == 0)
+        adc_canceled++;
+    Aio_Submit(&adc_req);       // fails only while a canceled burst waits to be drained
+    Aio_Submit(&temp_req);
+}
+
+/**
+ * @brief Build the report in a free line buffer and submit it; skip it if both are busy.
+ */
+static void task_1s(uint32_t now)
+{
+    const aio_stats_t *tx = Aio_GetStats(DEV_TX);
+    aio_req_t *req = line_req[0].status != AIO_PENDING ? &line_req[0] :
+                     line_req[1].status != AIO_PENDING ? &line_req[1] : NULL;
+    int n;
+
+    if (!req) { lines_skipped++; return; }
+    n = snprintf((char *)req->buf, LINE_LEN,
+                 "[%lu] temp %d.%02u C  A2 %u  key %c  canceled %u  lines %lu/%u\n\r",
+                 (unsigned long)now, temp_c16 / 16, (unsigned)((temp_c16 & 15) * 100 / 16),
+                 adc_mean, last_key, adc_canceled, (unsigned long)tx->completed,
+                 lines_skipped);
+    req->len = (uint16_t)(n < (int)LINE_LEN ? n : (int)LINE_LEN - 1);
+    Aio_Submit(req);
+}
@@ -0,0 +1,136 @@
+/*
+ * Tickless task releases on Timer_B0 compare channels (lib/ccsched.c) for MSP430FR5994
+ * - MCLK = SMCLK = 8 MHz (DCO); TB0 runs continuously at SMCLK/8, 1 us per count
+ * - Five tasks on CCR1-CCR5: 2.5 ms sampling, 10/50/100 ms work, 1 s status
+ * - No periodic tick: the CPU wakes once per release, plus a hop every 61 ms or less
+ *   in the 100 ms and 1 s periods: about 560 interrupts a second instead of the 2000
+ *   of a 0.5 ms tick (the GCD of the periods)
+ *
+ * Key patterns:
+ * - Releases are exact in timer counts: each compare is the previous one plus the
+ *   period, so the 2.5 ms task does not need a 0.5 ms tick
+ * - The ISR handles the one channel TB0IV names: no counters to scan
+ * - Main loop sleeps in LPM0 and runs released tasks in channel order; CCR1 is the
+ *   highest priority, both in TB0IV and in dispatch
+ * - TB0 is not shared with the high-rate tier (src/two_tier.c), which runs it in up mode
+ */
+
+#include <msp430.h>
+#include <stdint.h>
+#include "clock.h"
+#include "ccsched.h"
+#include "wcet.h"
+#include "hot.h"
+
+/* ---------- Task set (us) ---------- */
+#define SAMPLE_PERIOD_US      2500u
+#define FAST_PERIOD_US        10000u
+#define MEDIUM_PERIOD_US      50000u
+#define SLOW_PERIOD_US        100000u
+#define STATUS_PERIOD_US      1000000u
+
+/* Every ISR must stay below this many cycles (tools/wcet.py) */
+#define ISR_BUDGET_CYCLES     300
+
+static void task_sample(void);
+static void task_fast(void);
+static void task_medium(void);
+static void task_slow(void);
+static void task_status(void);
+
+static volatile uint16_t samples = 0;
+static volatile uint16_t worst_late_us = 0;
+
+WCET_CLOCK_HZ(8000000);
+WCET_ISR_BUDGET(ISR_BUDGET_CYCLES);
+
+/* ---------- GPIO init ---------- */
+void Gpio_Init(void)
+{
+    PM5CTL0 &= ~LOCKLPM5;
+    P1DIR |= BIT0 | BIT1 | BIT3 | BIT4 | BIT5;
+    P1OUT &= ~(BIT0 | BIT1 | BIT3 | BIT4 | BIT5);
+}
+
+/* ---------- ISR: one compare, one release ---------- */
+#if defined(__TI_COMPILER_VERSION__) || defined(__IAR_SYSTEMS_ICC__)
+#pragma vector = TIMER0_B1_VECTOR
+__interrupt void Timer0_B1_ISR (void)
+#elif defined(__GNUC__)
+HOT_FN void __attribute__ ((interrupt(TIMER0_B1_VECTOR))) Timer0_B1_ISR (void)
+#else
+#error Compiler not supported!
+#endif
+{
+    /* Reading TB0IV clears the flag of the channel it reports */
+    if (CcSched_Isr(TB0IV))
+        __bic_SR_register_on_exit(LPM0_bits);
+}
+
+/* ---------- Main ---------- */
+int main(void)
+{
+    WDTCTL = WDTPW | WDTHOLD;     // stop watchdog
+
+    Clk_Init(CLK_8MHZ);
+    Gpio_Init();
+
+    /* Task index = channel - 1 = priority. Offsets spread the first releases. */
+    CcSched_Init();
+    if (CcSched_AddTask(task_sample, SAMPLE_PERIOD_US, 0) < 0 ||
+        CcSched_AddTask(task_fast, FAST_PERIOD_US, 1000u) < 0 ||
+        CcSched_AddTask(task_medium, MEDIUM_PERIOD_US, 3000u) < 0 ||
+        CcSched_AddTask(task_slow, SLOW_PERIOD_US, 6000u) < 0 ||
+        CcSched_AddTask(task_status, STATUS_PERIOD_US, 500u) < 0)
+    {
+        P1OUT |= BIT0 | BIT1;   // a period is not a whole number of counts: halt
+        while (1) __no_operation();
+    }
+    CcSched_Start();
+
+    __enable_interrupt();
+
+    while (1)
+    {
+        CcSched_Dispatch();
+    }
+}
+
+/* ---------- Example user tasks ----------
+ * Same busy loops as src/scheduler.c; the sampling task is short enough to run 400
+ * times a second.
+ */
+static void task_sample(void)
+{
+    samples++;
+}
+
+static void task_fast(void)
+{
+    P1OUT ^= BIT3;
+    __delay_cycles(8000);
+    P1OUT ^= BIT3;
+}
+
+static void task_medium(void)
+{
+    P1OUT ^= BIT4;
+    __delay_cycles(16000);
+    P1OUT ^= BIT4;
+}
+
+static void task_slow(void)
+{
+    P1OUT ^= BIT5;
+    __delay_cycles(40000);
+    P1OUT ^= BIT5;
+}
+
+/* Heartbeat; worst dispatch delay of the sampling task, in us (1 count), for the debugger */
+static void task_status(void)
+{
+    P1OUT ^= BIT0;
+    worst_late_us = CcSched_GetTask(0)->max_late;
+    if (CcSched_GetTask(0)->late_arms)
+        P1OUT |= BIT1;          // a compare was armed after it had passed
+}
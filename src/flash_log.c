@@ -0,0 +1,126 @@
+/*
+ * Bulk logging to SPI NOR flash without waiting on the media (lib/blklog.c) @ 8 MHz
+ * - B1 is an SPI master at 8 MHz with a 25-series flash, chip select on P4.2; the log
+ *   uses its first 1 MB (2048 sectors) as a ring
+ * - A 10 ms task appends a 12-byte sample record; BlkLog_Append() only copies it into
+ *   the SRAM sector buffer, a full buffer is written by DMA in the background
+ * - BlkLog_Service() runs as a 1 ms task and steps the flash: erase ahead, two page
+ *   programs per sector, status polls
+ * - A 1 s task appends a summary record and prints the logger counters
+ *
+ * Key patterns:
+ * - The logger is mounted before the scheduler starts: the header scan blocks on the bus
+ * - Only the DMA ISR is needed for SPI; it hands its event to the engine
+ * - A dropped record is counted, never waited for
+ */
+
+#include <msp430.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "clock.h"
+#include "systime.h"
+#include "scheduler.h"
+#include "defer.h"
+#include "bus.h"
+#include "blklog.h"
+#include "uart.h"
+
+#define LOG_SECTORS     2048u
+#define REC_SAMPLE      0u
+#define REC_SUMMARY     1u
+
+static void task_10ms(uint32_t now);
+static void task_1s(uint32_t now);
+
+static const bus_dev_t flash_dev = { BUS_B1, 0, &P4OUT, BIT2 };
+
+static uint32_t samples = 0;
+
+void Gpio_Init(void)
+{
+    PM5CTL0 &= ~LOCKLPM5;
+    P1DIR |= BIT0;
+    P1OUT &= ~BIT0;
+    P4DIR |= BIT2;              // flash chip select, idle high
+    P4OUT |= BIT2;
+}
+
+/* ---------- ISRs ---------- */
+
+#if defined(__TI_COMPILER_VERSION__) || defined(__IAR_SYSTEMS_ICC__)
+#pragma vector = TIMER0_A0_VECTOR
+__interrupt void Timer0_A0_ISR (void)
+#elif defined(__GNUC__)
+void __attribute__ ((interrupt(TIMER0_A0_VECTOR))) Timer0_A0_ISR (void)
+#else
+#error Compiler not supported!
+#endif
+{
+    SysTime_Tick();
+    Scheduler_TickDeferred();
+    __bic_SR_register_on_exit(LPM0_bits);
+}
+
+#if defined(__TI_COMPILER_VERSION__) || defined(__IAR_SYSTEMS_ICC__)
+#pragma vector = DMA_VECTOR
+__interrupt void Dma_ISR (void)
+#elif defined(__GNUC__)
+void __attribute__ ((interrupt(DMA_VECTOR))) Dma_ISR (void)
+#else
+#error Compiler not supported!
+#endif
+{
+    Bus_DmaIsr(DMAIV);
+    __bic_SR_register_on_exit(LPM0_bits);
+}
+
+/* ---------- Main superloop ---------- */
+int main(void)
+{
+    WDTCTL = WDTPW | WDTHOLD;
+
+    Clk_Init(CLK_8MHZ);
+    Gpio_Init();
+    Uart_Init();
+    Defer_Init();
+    Bus_Init(BUS_B1, BUS_SPI, 8000000u);
+
+    SysTime_Init();
+    __enable_interrupt();
+    if (BlkLog_Init(&flash_dev, 0, LOG_SECTORS) != 0)
+        printf("log mount failed\n\r");
+    else
+        printf("log resumes at sector %lu\n\r", (unsigned long)BlkLog_NextSeq());
+
+    Scheduler_AddTask(BlkLog_Service, 1, 0, 0);
+    Scheduler_AddTask(task_10ms, 10, 0, 1);
+    Scheduler_AddTask(task_1s, 1000, 5, 0);
+
+    while (1)
+    {
+        Scheduler_Dispatch();
+    }
+}
+
+/* ---------- Tasks ---------- */
+
+static void task_10ms(uint32_t now)
+{
+    uint32_t rec[3];
+
+    rec[0] = now;
+    rec[1] = samples++;
+    rec[2] = BlkLog_NextSeq();
+    BlkLog_Append(REC_SAMPLE, rec, sizeof(rec));
+}
+
+static void task_1s(uint32_t now)
+{
+    const blklog_stats_t *st = BlkLog_GetStats();
+
+    P1OUT ^= BIT0;
+    BlkLog_Append(REC_SUMMARY, st, sizeof(*st));
+    printf("[%lu] log %lu records %lu bytes  sectors %lu  dropped %lu  errors %u\n\r",
+           (unsigned long)now, (unsigned long)st->records, (unsigned long)st->bytes,
+           (unsigned long)st->sectors, (unsigned long)st->dropped, st->errors);
+}
@@ -0,0 +1,189 @@
+/*
+ * Sensor history in FRAM with time-range readout (lib/tstore.c) @ 8 MHz
+ * - Every second a 4-sample ADC12 burst of A2 (P1.2) is taken (lib/adc.c through aio.h)
+ *   and appended with its SysTime stamp; the store commits 8 records per FRAM write
+ *   window and keeps the last ~17 minutes across resets
+ * - Key 'd' on the UART dumps the last 10 minutes: TStore_Seek() finds the start in a
+ *   few index and record reads, and each run from TStore_Next() is sent straight from
+ *   FRAM by Uart_AioTx, as raw 12-byte records, without an SRAM copy
+ * - Key 'f' flushes the batch, so the next dump includes the newest records
+ *
+ * Key patterns:
+ * - One dump in flight: the cursor is static and the TX completion sends the next run
+ * - Records written while a dump runs land after its range; a run overtaken by the
+ *   writer would be skipped and counted in cursor.lost (10 minutes never is)
+ * - SysTime restarts at 0 after a reset, so the timestamps continue from the newest
+ *   stored record instead of going backwards
+ */
+
+#include <msp430.h>
+#include <stdint.h>
+#include "clock.h"
+#include "systime.h"
+#include "scheduler.h"
+#include "defer.h"
+#include "aio.h"
+#include "uart.h"
+#include "adc.h"
+#include "tstore.h"
+
+#define DEV_TX          0u
+#define DEV_RX          1u
+#define DEV_ADC         2u
+
+#define ADC_CHANNEL     2u
+#define DUMP_MS         600000u     // 10 minutes
+#define RUN_RECORDS     16u         // records per UART request
+
+static void task_1s(uint32_t now);
+static void adc_done(aio_req_t *req);
+static void key_done(aio_req_t *req);
+static void dump_next(aio_req_t *req);
+
+static uint16_t samples[TSTORE_VALUES];
+static uint8_t key;
+static uint32_t t_base;             // newest stored time at start-up
+static tstore_cursor_t dump;
+
+static aio_req_t adc_req = { .dev = DEV_ADC, .op = AIO_READ,
+                             .target = (const void *)ADC_CHANNEL,
+                             .buf = (uint8_t *)samples, .len = sizeof(samples),
+                             .done = adc_done };
+static aio_req_t key_req = { .dev = DEV_RX, .op = AIO_READ, .buf = &key, .len = 1,
+                             .done = key_done };
+static aio_req_t dump_req = { .dev = DEV_TX, .op = AIO_WRITE, .done = dump_next };
+
+void Gpio_Init(void)
+{
+    PM5CTL0 &= ~LOCKLPM5;
+    P1DIR |= BIT0;
+    P1OUT &= ~BIT0;
+    P1SEL1 |= BIT2;             // A2
+    P1SEL0 |= BIT2;
+}
+
+/* ---------- ISRs ---------- */
+
+#if defined(__TI_COMPILER_VERSION__) || defined(__IAR_SYSTEMS_ICC__)
+#pragma vector = TIMER0_A0_VECTOR
+__interrupt void Timer0_A0_ISR (void)
+#elif defined(__GNUC__)
+void __attribute__ ((interrupt(TIMER0_A0_VECTOR))) Timer0_A0_ISR (void)
+#else
+#error Compiler not supported!
+#endif
+{
+    SysTime_Tick();
+    Scheduler_TickDeferred();
+    __bic_SR_register_on_exit(LPM0_bits);
+}
+
+#if defined(__TI_COMPILER_VERSION__) || defined(__IAR_SYSTEMS_ICC__)
+#pragma vector = USCI_A0_VECTOR
+__interrupt void Usci_A0_ISR (void)
+#elif defined(__GNUC__)
+void __attribute__ ((interrupt(USCI_A0_VECTOR))) Usci_A0_ISR (void)
+#else
+#error Compiler not supported!
+#endif
+{
+    Uart_Isr();
+    __bic_SR_register_on_exit(LPM0_bits);
+}
+
+#if defined(__TI_COMPILER_VERSION__) || defined(__IAR_SYSTEMS_ICC__)
+#pragma vector = ADC12_B_VECTOR
+__interrupt void Adc12_ISR (void)
+#elif defined(__GNUC__)
+void __attribute__ ((interrupt(ADC12_B_VECTOR))) Adc12_ISR (void)
+#else
+#error Compiler not supported!
+#endif
+{
+    Adc_Isr();
+    __bic_SR_register_on_exit(LPM0_bits);
+}
+
+/* ---------- Main superloop ---------- */
+int main(void)
+{
+    const tstore_rec_t *rec;
+    tstore_cursor_t c;
+    uint16_t n;
+
+    WDTCTL = WDTPW | WDTHOLD;
+
+    Clk_Init(CLK_8MHZ);
+    Gpio_Init();
+    Uart_Init();
+    Defer_Init();
+    Adc_Init();
+
+    TStore_Init();
+    TStore_Seek(&c, 0, 0xFFFFFFFFu);
+    while ((n = TStore_Next(&c, &rec, 0xFFFFu)) != 0)
+        t_base = rec[n - 1u].t + 1000u;
+
+    Aio_Attach(DEV_TX, &Uart_AioTx);
+    Aio_Attach(DEV_RX, &Uart_AioRx);
+    Aio_Attach(DEV_ADC, &Adc_AioOps);
+
+    Scheduler_AddTask(task_1s, 1000, 0, 1);
+
+    SysTime_Init();
+    __enable_interrupt();
+    Aio_Submit(&key_req);
+
+    while (1)
+    {
+        Scheduler_Dispatch();
+    }
+}
+
+/* ---------- Completions ---------- */
+
+static void adc_done(aio_req_t *req)
+{
+    if (req->status != AIO_OK) return;
+    TStore_Append(t_base + SysTime_Now(), samples);
+}
+
+/* Send the next run of the dump range from FRAM; a zero-length run ends the dump */
+static void dump_next(aio_req_t *req)
+{
+    const tstore_rec_t *rec;
+    uint16_t n = TStore_Next(&dump, &rec, RUN_RECORDS);
+
+    if (n == 0) return;
+    req->buf = (uint8_t *)rec;
+    req->len = n * sizeof(tstore_rec_t);
+    Aio_Submit(req);
+}
+
+static void key_done(aio_req_t *req)
+{
+    uint32_t now = t_base + SysTime_Now();
+
+    if (req->status == AIO_OK)
+    {
+        if (key == 'f')
+        {
+            TStore_Flush();
+        }
+        else if (key == 'd' && dump_req.status != AIO_PENDING)
+        {
+            TStore_Seek(&dump, now > DUMP_MS ? now - DUMP_MS : 0, 0xFFFFFFFFu);
+            dump_next(&dump_req);
+        }
+    }
+    Aio_Submit(req);
+}
+
+/* ---------- Tasks ---------- */
+
+static void task_1s(uint32_t now)
+{
+    (void)now;
+    P1OUT ^= BIT0;
+    Aio_Submit(&adc_req);
+}
@@ -0,0 +1,342 @@
+/**
+ * @file messages.c
+ * @brief Message passing between ISRs and tasks with fixed-block pools @ 1 MHz SMCLK.
+ *
+ * - UART RX ISR collects a line into a pool block and hands it to a sporadic server
+ *   (lib/server.c): a burst of lines costs the 10 ms task at most RX_SERVER_US per
+ *   RX_SERVER_MS, the rest waits for the next replenishment; the block is freed once
+ *   the line is handled
+ * - A 10 ms task samples into small blocks, a 100 ms task batches them into a report
+ * - Small messages live in SRAM, the large report class in FRAM (lib/pool.c)
+ * - A 1 s task wakes a background job (lib/background.c) that prints per-pool use,
+ *   high-water mark and exhaustion counts, and the energy charged to each task and to
+ *   idle so far (lib/energy.c), one line per chunk in the slack between releases
+ * - Tasks_Init() registers everything and checks the worst start delay of the set;
+ *   build/host/admit runs it on the host
+ */
+
+#include <msp430.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "clock.h"
+#include "systime.h"
+#include "scheduler.h"
+#include "defer.h"
+#include "server.h"
+#include "background.h"
+#include "pool.h"
+#include "energy.h"
+#include "uart.h"
+
+#define LINE_MAX        32
+#define BATCH_MAX       10
+#define RX_SERVER_US    3000    // line handling budget (printf at 115200 baud: ~3 ms/line)
+#define RX_SERVER_MS    20
+#define SAMPLE_DELAY_MS 20      // worst start delay of Task_10ms; pending releases catch up
+#define REPORT_CHUNK_US 6000    // one report line, <= 64 chars at 115200 baud plus formatting
+
+typedef struct {
+    uint8_t  len;
+    char     text[LINE_MAX - 1];
+} line_msg_t;
+
+typedef struct sample_msg {
+    struct sample_msg *next;
+    uint32_t time_ms;
+    uint16_t value;
+} sample_msg_t;
+
+typedef struct {
+    uint32_t first_ms;
+    uint8_t  count;
+    uint16_t min, max;
+    uint32_t sum;
+} report_msg_t;
+
+/* -------- Pools (size classes) -------- */
+
+POOL_DEFINE(pool_small, sizeof(sample_msg_t), 16);
+POOL_DEFINE(pool_line, sizeof(line_msg_t), 4);
+POOL_DEFINE_FRAM(pool_report, sizeof(report_msg_t), 4);
+
+/* -------- Prototypes -------- */
+
+static void Task_10ms(uint32_t now);
+static void Task_100ms(uint32_t now);
+static void Task_1s(uint32_t now);
+static void Line_Handler(uintptr_t arg);
+static uint8_t bg_report(void);
+
+/* Samples waiting for the next report (main loop only) */
+static sample_msg_t *batch_head = NULL;
+static sample_msg_t **batch_tail = &batch_head;
+static volatile uint16_t line_drops = 0;
+static server_t rx_server;
+static int8_t report_job;
+static uint32_t report_ms;
+static uint8_t report_line;
+
+/* -------- GPIO -------- */
+
+/**
+ * @brief Initialize basic GPIO used by tasks.
+ */
+void Gpio_Init(void)
+{
+    PM5CTL0 &= ~LOCKLPM5;
+    P1DIR |= BIT0 | BIT1;
+    P1OUT &= ~(BIT0 | BIT1);
+}
+
+/* -------- ISRs -------- */
+
+#if defined(__TI_COMPILER_VERSION__) || defined(__IAR_SYSTEMS_ICC__)
+#pragma vector = TIMER0_A0_VECTOR
+__interrupt void Timer0_A0_ISR(void)
+#elif defined(__GNUC__)
+void __attribute__ ((interrupt(TIMER0_A0_VECTOR))) Timer0_A0_ISR(void)
+#else
+#error Compiler not supported!
+#endif
+{
+    SysTime_Tick();
+    Scheduler_TickDeferred();
+
+    __bic_SR_register_on_exit(LPM0_bits);
+}
+
+/**
+ * @brief UART RX: append to the current line block, post it on CR/LF or when full.
+ */
+#if defined(__TI_COMPILER_VERSION__) || defined(__IAR_SYSTEMS_ICC__)
+#pragma vector = USCI_A0_VECTOR
+__interrupt void USCI_A0_ISR(void)
+#elif defined(__GNUC__)
+void __attribute__ ((interrupt(USCI_A0_VECTOR))) USCI_A0_ISR(void)
+#else
+#error Compiler not supported!
+#endif
+{
+    static line_msg_t *line = NULL;
+    char c;
+
+    if (UCA0IV != USCI_UART_UCRXIFG)
+        return;
+    c = (char)UCA0RXBUF;
+
+    if (!line)
+    {
+        line = Pool_Get(&pool_line);
+        if (!line) { line_drops++; return; }   // pool empty: drop until one is freed
+        line->len = 0;
+    }
+
+    if (c != '\r' && c != '\n')
+        line->text[line->len++] = c;
+
+    if ((c == '\r' || c == '\n' || line->len == sizeof(line->text)) && line->len)
+    {
+        if (Server_Post(&rx_server, Line_Handler, (uintptr_t)line) != 0)
+            Pool_Put(&pool_line, line);
+        line = NULL;
+        __bic_SR_register_on_exit(LPM0_bits);
+    }
+}
+
+/* -------- Superloop -------- */
+
+/**
+ * @brief Register pools, tasks, the RX server and the report job.
+ *
+ * @return 0 if the server fits next to the tasks and no task can start later than
+ *         SAMPLE_DELAY_MS after its release, -1 otherwise.
+ */
+static int8_t Tasks_Init(void)
+{
+    /* Size classes for Pool_Alloc(); the RX ISR uses pool_line directly */
+    Pool_AddClass(&pool_small);
+    Pool_AddClass(&pool_report);
+
+    Scheduler_AddTask(Task_10ms,  10,   0, 1);
+    Scheduler_AddTask(Task_100ms, 100,  5, 5);
+    Scheduler_AddTask(Task_1s,    1000, 7, 1);     // printing is in bg_report()
+    Server_Init(&rx_server, RX_SERVER_US, RX_SERVER_MS);
+
+    Background_Init();
+    report_job = Background_Add(bg_report, REPORT_CHUNK_US);
+
+    if (report_job < 0 || Scheduler_AddServer(&rx_server) != 0 ||
+        Scheduler_MaxStartDelayMs() > SAMPLE_DELAY_MS)
+        return -1;
+    return 0;
+}
+
+/**
+ * @brief Main application entry: initialize hardware, register pools and tasks.
+ *
+ * This function never returns.
+ */
+int main(void)
+{
+    WDTCTL = WDTPW | WDTHOLD;
+
+    Clk_Init(CLK_1MHZ);
+    Gpio_Init();
+    Uart_Init();
+    Defer_Init();
+
+    if (Tasks_Init() != 0)
+    {
+        P1OUT |= BIT0 | BIT1;           // budget does not fit next to the tasks
+        while (1);
+    }
+
+    SysTime_Init();
+    Energy_Init(NULL);
+    UCA0IE |= UCRXIE;
+    __enable_interrupt();
+
+    while (1)
+    {
+        Scheduler_Dispatch();
+    }
+}
+
+/* -------- Server handlers -------- */
+
+/**
+ * @brief Echo a received line and return its block.
+ *
+ * @param arg line_msg_t block from pool_line.
+ */
+static void Line_Handler(uintptr_t arg)
+{
+    line_msg_t *line = (line_msg_t *)arg;
+
+    printf("rx: %.*s\n\r", line->len, line->text);
+    Pool_Put(&pool_line, line);
+}
+
+/* -------- Tasks -------- */
+
+/**
+ * @brief Take one sample into a small block and queue it for the next report.
+ *
+ * @param now Current tick value passed by scheduler.
+ */
+static void Task_10ms(uint32_t now)
+{
+    sample_msg_t *s = Pool_Alloc(sizeof(*s));
+
+    if (!s)
+        return;                         // counted in pool_small.exhausted
+    s->next = NULL;
+    s->time_ms = now;
+    s->value = (uint16_t)(TA0R ^ (uint16_t)now);    // stand-in for an ADC reading
+    *batch_tail = s;
+    batch_tail = &s->next;
+}
+
+/**
+ * @brief Fold queued samples into a report block and release them.
+ *
+ * @param now Current tick value passed by scheduler.
+ */
+static void Task_100ms(uint32_t now)
+{
+    report_msg_t *r;
+    sample_msg_t *s;
+
+    (void)now;
+    if (!batch_head)
+        return;
+    r = Pool_Alloc(sizeof(*r));
+    if (!r)
+        return;                         // keep the samples for the next pass
+
+    r->first_ms = batch_head->time_ms;
+    r->count = 0;
+    r->min = 0xFFFF;
+    r->max = 0;
+    r->sum = 0;
+    while ((s = batch_head) != NULL && r->count < BATCH_MAX)
+    {
+        batch_head = s->next;
+        r->count++;
+        r->sum += s->value;
+        if (s->value < r->min) r->min = s->value;
+        if (s->value > r->max) r->max = s->value;
+        Pool_Free(s);
+    }
+    if (!batch_head)
+        batch_tail = &batch_head;
+
+    P1OUT ^= BIT0;
+    printf("[%lu] n=%u min=%u max=%u avg=%lu\n\r", (unsigned long)r->first_ms, r->count,
+           r->min, r->max, (unsigned long)(r->sum / r->count));
+    Pool_Free(r);
+}
+
+/**
+ * @brief Start the pool and energy report; bg_report() prints it.
+ *
+ * @param now Current tick value passed by scheduler.
+ */
+static void Task_1s(uint32_t now)
+{
+    P1OUT ^= BIT1;
+    report_ms = now;
+    report_line = 0;                    // an unfinished report starts over
+    Background_Wake((uint8_t)report_job);
+}
+
+/* -------- Background job -------- */
+
+#define REPORT_POOLS 3u
+#define REPORT_LINES (REPORT_POOLS + 4u)
+
+/**
+ * @brief Print one line of the report per call (at most REPORT_CHUNK_US).
+ *
+ * @return Non-zero while lines remain.
+ */
+static uint8_t bg_report(void)
+{
+    static const struct { const char *name; const pool_t *pool; } pools[REPORT_POOLS] = {
+        { "small",  &pool_small },
+        { "line",   &pool_line },
+        { "report", &pool_report },
+    };
+    uint8_t i = report_line;
+
+    if (i == 0)
+    {
+        printf("[%lu] pool    size used/count high exhausted\n\r", (unsigned long)report_ms);
+    }
+    else if (i <= REPORT_POOLS)
+    {
+        const pool_t *p = pools[i - 1u].pool;
+
+        printf("        %-7s %4u %4u/%-5u %4u %9u\n\r", pools[i - 1u].name,
+               p->block_size, p->used, p->count, p->high_water, p->exhausted);
+    }
+    else if (i == REPORT_POOLS + 1u)
+    {
+        printf("        rx dropped %u, full %u, out of budget %u\n\r", line_drops,
+               Server_GetStats(&rx_server)->dropped, Server_GetStats(&rx_server)->exhausted);
+    }
+    else if (i == REPORT_POOLS + 2u)
+    {
+        printf("        uJ 10ms %lu 100ms %lu 1s %lu\n\r",
+               (unsigned long)(Energy_TaskNanojoules(0) / 1000u),
+               (unsigned long)(Energy_TaskNanojoules(1) / 1000u),
+               (unsigned long)(Energy_TaskNanojoules(2) / 1000u));
+    }
+    else
+    {
+        printf("        uJ overhead %lu idle %lu\n\r",
+               (unsigned long)(Energy_TaskNanojoules(ENERGY_MAX_TASKS) / 1000u),
+               (unsigned long)(Energy_SleepNanojoules() / 1000u));
+    }
+    return ++report_line < REPORT_LINES;
+}
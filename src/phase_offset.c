@@ -1,54 +1,70 @@
 /*
  * MSP430FR5994 Deterministic Phase-Offset Scheduler
  * -------------------------------------------------
- * - TimerA0 generates 1 ms system tick (SMCLK = 1 MHz)
+ * - TimerA0 generates 1 ms system tick (SMCLK = 1 MHz, lib/systime.c)
  * - Cooperative (non-preemptive) superloop
- * - Each task has: period_ms, slice_ms, phase_offset_ms
+ * - Each task has: period_ms, slice_ms, phase_offset_ms, priority, preemption threshold
  * - Phase offsets chosen to avoid overlap → zero jitter schedule
+ * - Dispatch re-evaluates after every task: the due task with the highest priority
+ *   (earliest deadline among equals) runs next
+ * - Long tasks call Scheduler_Yield() at safe points; due tasks with a priority above
+ *   the running task's threshold run there (cooperative preemption)
+ * - With nothing due, background jobs (lib/background.c) use the slack before the
+ *   earliest next_run_ms instead of sleeping
  *
  * Tasks:
- *   T1: Blink LED1 every 10ms (slice 1ms, offset 0ms)
- *   T2: Blink LED1 every 100ms (slice 5ms, offset 2ms)
- *   T3: Blink LED2 every 500ms (slice 20ms, offset 10ms)
+ *   T1: P1.3 pulse every 10ms (slice 1ms, offset 0ms, priority 0)
+ *   T2: P1.4 pulse every 50ms (slice 5ms, offset 2ms, priority 1, threshold 1: T1 may
+ *       preempt at its yield points)
+ *   T3: P1.5 pulse every 100ms (slice 20ms, offset 10ms, priority 2, threshold 1: T1 may
+ *       preempt at its yield points)
  */
 
 #include <msp430.h>
 #include <stdint.h>
+#include "clock.h"
+#include "systime.h"
+#include "background.h"
 
 /* ---------- Configuration ---------- */
-#define TICK_MS 1
 #define MAX_TASKS 8
 
-typedef void (*task_fn_t)(uint16_t now_ms);
+/* Dispatch order:
+ * - DISPATCH_PRIORITY: one task per Scheduler_Dispatch(), highest priority first
+ * - DISPATCH_ARRAY: every due task in registration order in one pass (the original
+ *   behaviour, kept to compare lateness on the host: build/host/stress -w)
+ */
+#define DISPATCH_ARRAY      0u
+#define DISPATCH_PRIORITY   1u
+#ifndef DISPATCH_POLICY
+#define DISPATCH_POLICY     DISPATCH_PRIORITY
+#endif
+
+#define PRIO_IDLE 0xFFu     // threshold outside any task: every task may run
+
+typedef void (*task_fn_t)(uint32_t now_ms);
 
 typedef struct {
     task_fn_t fn;
     uint16_t  period_ms;
     uint16_t  slice_ms;
     uint16_t  phase_offset_ms;
-    uint16_t  next_run_ms;
+    uint8_t   priority;         // 0 = highest
+    uint8_t   threshold;        // while running, only priority < threshold may preempt
+    uint32_t  next_run_ms;
 } task_t;
 
 /* ---------- User tasks ---------- */
-static void Task_Fast(uint16_t now_ms);
-static void Task_Medium(uint16_t now_ms);
-static void Task_Slow(uint16_t now_ms);
+static void Task_Fast(uint32_t now_ms);
+static void Task_Medium(uint32_t now_ms);
+static void Task_Slow(uint32_t now_ms);
 
 /* ---------- Scheduler state ---------- */
-static volatile uint16_t sys_ms = 0;
 static task_t tasks[MAX_TASKS];
 static uint8_t task_count = 0;
+static uint8_t running_threshold = PRIO_IDLE;
 
-/* ---------- Clock / GPIO / Timer ---------- */
-void Clk_Init(void)
-{
-    CSCTL0_H = CSKEY >> 8;            // unlock
-    CSCTL1 = DCOFSEL_0;               // DCO = 1 MHz
-    CSCTL2 = SELA__VLOCLK | SELS__DCOCLK | SELM__DCOCLK;
-    CSCTL3 = DIVA__1 | DIVS__1 | DIVM__1;
-    CSCTL0_H = 0;                     // lock
-}
-
+/* ---------- GPIO ---------- */
 void Gpio_Init(void)
 {
     PM5CTL0 &= ~LOCKLPM5;
@@ -56,21 +72,19 @@ void Gpio_Init(void)
     P1OUT &= ~(BIT3 | BIT4 | BIT5);
 }
 
-void TimerA0_Init(void)
-{
-    TA0CCR0 = 999;                    // 1 MHz / 1000 = 1 kHz => 1 ms
-    TA0CCTL0 = CCIE;                  // CCR0 interrupt enable
-    TA0CTL = TASSEL__SMCLK | MC__UP | TACLR;
-}
-
-/* ---------- Task registration ---------- */
-int Scheduler_AddTask(task_fn_t fn, uint16_t period_ms, uint16_t slice_ms, uint16_t phase_offset_ms)
+/* ---------- Task registration ----------
+ * threshold is clamped to priority: a task never admits tasks of its own level or below.
+ */
+int Scheduler_AddTask(task_fn_t fn, uint16_t period_ms, uint16_t slice_ms, uint16_t phase_offset_ms,
+                      uint8_t priority, uint8_t threshold)
 {
-    if (task_count >= MAX_TASKS) return -1;
+    if (task_count >= MAX_TASKS || priority == PRIO_IDLE) return -1;
     tasks[task_count].fn = fn;
     tasks[task_count].period_ms = period_ms;
     tasks[task_count].slice_ms = slice_ms;
     tasks[task_count].phase_offset_ms = phase_offset_ms;
+    tasks[task_count].priority = priority;
+    tasks[task_count].threshold = threshold < priority ? threshold : priority;
     tasks[task_count].next_run_ms = phase_offset_ms;
     task_count++;
     return 0;
@@ -86,94 +100,170 @@ void __attribute__ ((interrupt(TIMER0_A0_VECTOR))) Timer0_A0_ISR (void)
 #error Compiler not supported!
 #endif
 {
-    sys_ms++;
+    SysTime_Tick();
     __bic_SR_register_on_exit(LPM0_bits);
 }
 
-/* ---------- Main superloop ---------- */
-int main(void)
+/* ---------- Task selection ----------
+ * Due task with priority < above, highest priority first, then earliest deadline
+ * (next release). Returns -1 if none.
+ */
+static int8_t pick_task(uint32_t now_ms, uint8_t above)
 {
-    WDTCTL = WDTPW | WDTHOLD;
+    int8_t best = -1;
 
-    Clk_Init();
-    Gpio_Init();
-    TimerA0_Init();
+    for (uint8_t i = 0; i < task_count; i++)
+    {
+        if (tasks[i].priority >= above || (int32_t)(now_ms - tasks[i].next_run_ms) < 0)
+            continue;
+        if (best < 0 || tasks[i].priority < tasks[best].priority ||
+            (tasks[i].priority == tasks[best].priority &&
+             (int32_t)(tasks[i].next_run_ms - tasks[best].next_run_ms) < 0))
+        {
+            best = (int8_t)i;
+        }
+    }
+    return best;
+}
+
+static void run_task(uint8_t i, uint32_t now_ms)
+{
+    uint8_t saved = running_threshold;
+
+    /* Schedule next activation first, so a yield inside the task cannot re-pick it */
+    tasks[i].next_run_ms += tasks[i].period_ms;
+
+    running_threshold = tasks[i].threshold;
+    tasks[i].fn(now_ms);
+    running_threshold = saved;
+}
+
+/* Slack before the earliest release: it happens on the tick that makes systime_ms
+ * reach next_run_ms, so next_run_ms - now_ms - 1 whole ticks come before that one */
+static uint16_t slack_ticks(uint32_t now_ms)
+{
+    uint32_t min = 0xFFFFu;
+
+    for (uint8_t i = 0; i < task_count; i++)
+    {
+        uint32_t left = tasks[i].next_run_ms - now_ms;
+        if (left < min) min = left;
+    }
+    return (uint16_t)(min > TICK_MS ? (min - TICK_MS) / TICK_MS : 0u);
+}
+
+/* ---------- Dispatch: one superloop pass ----------
+ * Sleeps if no task is due; the check runs with GIE clear and LPM0 is entered together
+ * with GIE, so a tick landing between the check and the sleep still wakes the loop.
+ */
+void Scheduler_Dispatch(void)
+{
+    uint32_t now_ms;
+    int8_t next;
 
-    /* Register tasks with deterministic offsets */
-    Scheduler_AddTask(Task_Fast,   10,  1,  0);   // every 10 ms, 1 ms slice, offset 0
-    Scheduler_AddTask(Task_Medium, 50, 5,  2);   // every 100 ms, 5 ms slice, offset 2
-    Scheduler_AddTask(Task_Slow,   100, 20, 10);  // every 500 ms, 20 ms slice, offset 10
+    __disable_interrupt();
+    now_ms = SysTime_Now();
+    next = pick_task(now_ms, PRIO_IDLE);
+    if (next < 0)
+    {
+        /* Idle: one background chunk if it ends before the next release */
+        if (Background_Run(slack_ticks(now_ms)))
+            return;
 
+        /* Sleep until next interrupt (returns with GIE set) */
+        __bis_SR_register(LPM0_bits | GIE);
+        return;
+    }
     __enable_interrupt();
 
-    while (1)
+#if DISPATCH_POLICY == DISPATCH_PRIORITY
+    /* One task, then re-evaluate: a task released meanwhile competes on priority */
+    run_task((uint8_t)next, now_ms);
+#else
+    for (uint8_t i = 0; i < task_count; i++)
     {
-        uint8_t have_work = 0;
-        uint16_t now_ms;
+        if ((int32_t)(now_ms - tasks[i].next_run_ms) >= 0)
+            run_task(i, now_ms);
+    }
+#endif
+}
 
-        /* Atomically read current time */
-        __disable_interrupt();
-        now_ms = sys_ms;
-        __enable_interrupt();
+/* ---------- Cooperative preemption point ----------
+ * Called by a running task: runs every due task whose priority is above the caller's
+ * threshold (nested, each with its own threshold), then returns to the caller.
+ */
+void Scheduler_Yield(void)
+{
+#if DISPATCH_POLICY == DISPATCH_PRIORITY
+    uint32_t now_ms = SysTime_Now();
+    int8_t next;
 
-        for (uint8_t i = 0; i < task_count; i++)
-        {
-            if ((int32_t)(now_ms - tasks[i].next_run_ms) >= 0)
-            {
-                /* Run this task */
-                tasks[i].fn(now_ms);
+    while ((next = pick_task(now_ms, running_threshold)) >= 0)
+    {
+        run_task((uint8_t)next, now_ms);
+        now_ms = SysTime_Now();
+    }
+#endif
+}
 
-                /* Schedule next activation */
-                tasks[i].next_run_ms += tasks[i].period_ms;
+/* ---------- Main superloop ---------- */
+int main(void)
+{
+    WDTCTL = WDTPW | WDTHOLD;
 
-                have_work = 1;
-            }
-        }
+    Clk_Init(CLK_1MHZ);
+    Gpio_Init();
+    SysTime_Init();
 
-        if (!have_work)
-        {
-            /* Sleep until next interrupt */
-            __bis_SR_register(LPM0_bits | GIE);
-        }
+    /* Register tasks with deterministic offsets, priorities and preemption thresholds */
+    Scheduler_AddTask(Task_Fast,   10,  1,  0,  0, 0);  // every 10 ms, 1 ms slice, offset 0
+    Scheduler_AddTask(Task_Medium, 50, 5,  2,  1, 1);  // every 50 ms, 5 ms slice, offset 2
+    Scheduler_AddTask(Task_Slow,   100, 20, 10, 2, 1);  // every 100 ms, 20 ms slice, offset 10
+
+    __enable_interrupt();
+
+    while (1)
+    {
+        Scheduler_Dispatch();
     }
 }
 
 /* ---------- User task implementations ---------- */
-static void Task_Fast(uint16_t now_ms)
+static void Task_Fast(uint32_t now_ms)
 {
     P1OUT |= BIT3;
-    uint16_t start = now_ms;
+    uint32_t start = now_ms;
 
     // Do useful work until we run out of time
     do
     {
-        _no_operation();
+        __no_operation();
     } while (TIME_ELAPSED(start) < 2);
     P1OUT &= ~BIT3;
 }
 
-static void Task_Medium(uint16_t now_ms)
+static void Task_Medium(uint32_t now_ms)
 {
     P1OUT |= BIT4;
-    uint16_t start = now_ms;
+    uint32_t start = now_ms;
 
     // Do useful work until we run out of time
     do
     {
-        _no_operation();
+        Scheduler_Yield();      // Task_Fast may run here
     } while (TIME_ELAPSED(start) < 10);
     P1OUT &= ~BIT4;
 }
 
-static void Task_Slow(uint16_t now_ms)
+static void Task_Slow(uint32_t now_ms)
 {
     P1OUT |= BIT5;
-    uint16_t start = now_ms;
+    uint32_t start = now_ms;
 
     // Do useful work until we run out of time
     do
     {
-        _no_operation();
+        Scheduler_Yield();      // Task_Fast may run here
     } while (TIME_ELAPSED(start) < 50);
     P1OUT &= ~BIT5;
 }
@@ -0,0 +1,118 @@
+/*
+ * Run-time ISR rebinding through the RAM vector table (lib/ramvec.c) @ 8 MHz
+ * - TA0 CCR0 => 1 ms tick (lib/systime.c), cooperative tasks (lib/scheduler.c)
+ * - Two tick ISRs, neither bound to TIMER0_A0_VECTOR at build time:
+ *   Tick_Direct_ISR updates the task countdowns in the ISR (lowest release latency),
+ *   Tick_Deferred_ISR posts them as deferred work (constant ISR cost)
+ * - Button S1 (P5.6) swaps the tick ISR with one RamVec_Set(); a 1 s task reports the
+ *   active mode and the number of swaps
+ *
+ * Key patterns:
+ * - RamVec_Init() before the first interrupt; the statically bound port ISR keeps
+ *   working from the copied table
+ * - Each ISR is a specialised fast path, no mode test or function pointer call inside
+ */
+
+#include <msp430.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "clock.h"
+#include "systime.h"
+#include "scheduler.h"
+#include "defer.h"
+#include "ramvec.h"
+#include "uart.h"
+
+static void task_100ms(uint32_t now);
+static void task_1s(uint32_t now);
+RAMVEC_ISR(Tick_Direct_ISR);
+RAMVEC_ISR(Tick_Deferred_ISR);
+
+static volatile uint16_t swaps = 0;
+
+void Gpio_Init(void)
+{
+    PM5CTL0 &= ~LOCKLPM5;
+    P1DIR |= BIT0;
+    P1OUT &= ~BIT0;
+
+    P5DIR &= ~BIT6;                 // S1: input, pull-up, falling edge
+    P5REN |= BIT6;
+    P5OUT |= BIT6;
+    P5IES |= BIT6;
+    P5IFG &= ~BIT6;
+    P5IE |= BIT6;
+}
+
+/* ---------- Tick ISRs (bound at run time) ---------- */
+
+RAMVEC_ISR(Tick_Direct_ISR)
+{
+    SysTime_Tick();
+    Scheduler_Tick();
+    __bic_SR_register_on_exit(LPM0_bits);
+}
+
+RAMVEC_ISR(Tick_Deferred_ISR)
+{
+    SysTime_Tick();
+    Scheduler_TickDeferred();
+    __bic_SR_register_on_exit(LPM0_bits);
+}
+
+/* ---------- Button: swap the tick ISR ---------- */
+#if defined(__TI_COMPILER_VERSION__) || defined(__IAR_SYSTEMS_ICC__)
+#pragma vector = PORT5_VECTOR
+__interrupt void Port5_ISR (void)
+#elif defined(__GNUC__)
+void __attribute__ ((interrupt(PORT5_VECTOR))) Port5_ISR (void)
+#else
+#error Compiler not supported!
+#endif
+{
+    if (P5IV != P5IV__P5IFG6)
+        return;
+    if (RamVec_Get(TIMER0_A0_VECTOR) == Tick_Direct_ISR)
+        RamVec_Set(TIMER0_A0_VECTOR, Tick_Deferred_ISR);
+    else
+        RamVec_Set(TIMER0_A0_VECTOR, Tick_Direct_ISR);
+    swaps++;
+}
+
+/* ---------- Main superloop ---------- */
+int main(void)
+{
+    WDTCTL = WDTPW | WDTHOLD;
+
+    Clk_Init(CLK_8MHZ);
+    Gpio_Init();
+    Uart_Init();
+    Defer_Init();
+
+    Scheduler_AddTask(task_100ms, 100, 0, 0);
+    Scheduler_AddTask(task_1s, 1000, 3, 0);
+
+    RamVec_Init();
+    RamVec_Set(TIMER0_A0_VECTOR, Tick_Deferred_ISR);
+    SysTime_Init();
+    __enable_interrupt();
+
+    while (1)
+    {
+        Scheduler_Dispatch();
+    }
+}
+
+/* ---------- Tasks ---------- */
+
+static void task_100ms(uint32_t now)
+{
+    (void)now;
+    P1OUT ^= BIT0;
+}
+
+static void task_1s(uint32_t now)
+{
+    printf("[%lu] tick %s, %u swaps\n\r", (unsigned long)now,
+           RamVec_Get(TIMER0_A0_VECTOR) == Tick_Direct_ISR ? "direct" : "deferred", swaps);
+}
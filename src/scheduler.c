@@ -1,64 +1,66 @@
 /*
  * Cooperative periodic task scheduler for MSP430FR5994
- * - SMCLK = 1 MHz (DCO)
- * - TA0 CCR0 => 1 ms tick
- * - ISR increments per-task pending counters (volatile)
+ * - MCLK = SMCLK = 8 MHz (DCO)
+ * - TA0 CCR0 tick (lib/systime.c) from Scheduler_Start(): the GCD of the periods and
+ *   offsets. For 10/50/100 ms at 0/1/3 ms that is 1 ms; offsets on a 5 ms grid would
+ *   let the CPU wake 200 times a second instead of 1000
+ * - ISR advances time and posts the countdown update as deferred work (lib/defer.c);
+ *   the main loop runs it, which increments pending counters (lib/scheduler.c)
  * - Main loop polls counters and calls task functions (cooperative)
+ * - Idle time before the next release runs a background CRC of a log block in chunks
+ *   (lib/background.c), so checksumming never delays a periodic task
  *
  * Key patterns:
- * - Keep ISR minimal and use small static counters inside ISR
+ * - Keep ISR minimal: fixed cost whatever MAX_TASKS is (checked by tools/wcet.py)
  * - Task counters are atomic-ish: accessed in main with interrupts briefly disabled
  * - ISR calls __bic_SR_register_on_exit(LPM0_bits) to wake main loop
+ * - ISR and dispatch path run from SRAM (lib/hot.h), so a 16 MHz build pays no FRAM
+ *   wait states on them
  */
 
 #include <msp430.h>
 #include <stdint.h>
-#include <stddef.h>
-
-#define MAX_TASKS    8   // increase if needed
-#define TICK_MS      1   // system tick in ms
+#include "clock.h"
+#include "systime.h"
+#include "scheduler.h"
+#include "defer.h"
+#include "background.h"
+#include "wcet.h"
+#include "hot.h"
+
+/* ---------- Task set ----------
+ * Slices are checked against the static WCET of each task at build time (tools/wcet.py).
+ */
+#define TASK_10MS_SLICE_MS    2
+#define TASK_50MS_SLICE_MS    3
+#define TASK_100MS_SLICE_MS   6
 
-/* Task type: function pointer with void(void) signature */
-typedef void (*task_fn_t)(void);
+/* Every ISR must stay below this many cycles (tools/wcet.py) */
+#define ISR_BUDGET_CYCLES     400
 
-typedef struct {
-    task_fn_t  fn;         // function to run
-    uint16_t   period_ms;  // period in ms (must be multiple of TICK_MS)
-    uint16_t   offset_ms;
-    volatile uint16_t pending; // pending executions queued by ISR (incremented in ISR)
-} task_t;
+/* Background CRC: bytes per chunk and the chunk's worst case at 8 MHz (CRC module,
+ * about 6 cycles per byte) */
+#define LOG_BLOCK_BYTES       512
+#define CRC_CHUNK_BYTES       64
+#define CRC_CHUNK_US          100
 
 /* ---------- User task prototypes (examples) ---------- */
-static void task_10ms(void);
-static void task_50ms(void);
-static void task_100ms(void);
-
-/* ---------- Scheduler storage ---------- */
-static task_t tasks[MAX_TASKS];
-static uint8_t  task_count = 0;
-
-/* Register a periodic task. Returns 0 on success, -1 on failure. */
-int Scheduler_AddTask(task_fn_t fn, uint16_t period_ms , uint16_t offset_ms)
-{
-    if (!fn || period_ms == 0 || task_count >= MAX_TASKS) return -1;
-    tasks[task_count].fn = fn;
-    tasks[task_count].period_ms = period_ms;
-    tasks[task_count].offset_ms = offset_ms;
-    tasks[task_count].pending = 0;
-    task_count++;
-    return 0;
-}
-
-/* ---------- Clock / GPIO / Timer init ---------- */
-void Clk_Init(void)
-{
-    CSCTL0_H = CSKEY >> 8;            // unlock
-    CSCTL1 = DCOFSEL_6;               // DCO = 8 MHz
-    CSCTL2 = SELA__VLOCLK | SELS__DCOCLK | SELM__DCOCLK;
-    CSCTL3 = DIVA__1 | DIVS__1 | DIVM__1;
-    CSCTL0_H = 0;                     // lock
-}
-
+static void task_10ms(uint32_t now_ms);
+static void task_50ms(uint32_t now_ms);
+static void task_100ms(uint32_t now_ms);
+static uint8_t bg_log_crc(void);
+
+static uint8_t log_block[LOG_BLOCK_BYTES];
+static uint16_t log_crc;
+static int8_t crc_job;
+
+WCET_CLOCK_HZ(8000000);
+WCET_ISR_BUDGET(ISR_BUDGET_CYCLES);
+WCET_SLICE(task_10ms, TASK_10MS_SLICE_MS);
+WCET_SLICE(task_50ms, TASK_50MS_SLICE_MS);
+WCET_SLICE(task_100ms, TASK_100MS_SLICE_MS);
+
+/* ---------- GPIO init ---------- */
 void Gpio_Init(void)
 {
     PM5CTL0 &= ~LOCKLPM5;
@@ -66,49 +68,21 @@ void Gpio_Init(void)
     P1OUT &= ~(BIT3 | BIT4 | BIT5);
 }
 
-/* Setup TA0 CCR0 to create 1 ms tick:
- * SMCLK = 1 MHz, use no divider -> CCR0 = 1000-1 = 999 for 1 ms
- * However we prefer smaller CCR0 to keep timer resolution low-cost on 16-bit: use TA0CCR0 = 999
- */
-void TimerA0_Init(void)
-{
-    TA0CCTL0 = CCIE;                  // CCR0 interrupt enable
-    TA0CCR0  = 999;
-    TA0CTL   = TASSEL_2 | MC_1 | ID_3 | TACLR;  // SMCLK, Up mode, /8
-}
-
 /* ---------- ISR: keep very small ----------
- * - static local counters to avoid frequent FRAM writes
- * - increment per-task pending counters when their period elapses
+ * - advance system time, defer the per-task countdowns (lib/scheduler.c)
  * - clear LPM0 bits on exit so main loop runs
- *
- * Implementation detail: maintain local millisecond accumulator and for each registered
- * task fire when multiple-of-period is reached. Because tasks[] is in RAM and task_count
- * is small, we compute per-task triggers by incrementing an internal counter array.
  */
 #if defined(__TI_COMPILER_VERSION__) || defined(__IAR_SYSTEMS_ICC__)
 #pragma vector = TIMER0_A0_VECTOR
 __interrupt void Timer0_A0_ISR (void)
 #elif defined(__GNUC__)
-void __attribute__ ((interrupt(TIMER0_A0_VECTOR))) Timer0_A0_ISR (void)
+HOT_FN void __attribute__ ((interrupt(TIMER0_A0_VECTOR))) Timer0_A0_ISR (void)
 #else
 #error Compiler not supported!
 #endif
 {
-    /* Local static ms accumulator per registered task (keeps CPU/RAM access inside ISR fast) */
-    static uint16_t local_ms[MAX_TASKS];
-    uint8_t i;
-
-    /* Increment local counters and set pending when period reached */
-    for (i = 0; i < task_count; i++)
-    {
-        local_ms[i]++;  // increments in fast SRAM
-        if (local_ms[i] >= (uint16_t)tasks[i].period_ms + (uint16_t)tasks[i].offset_ms) {
-            local_ms[i] = 0;
-            /* increment pending counter (volatile) -- small variable in RAM */
-            if (tasks[i].pending < 0xFFFF) tasks[i].pending++;
-        }
-    }
+    SysTime_Tick();
+    Scheduler_TickDeferred();
 
     /* Wake up main loop after ISR */
     __bic_SR_register_on_exit(LPM0_bits);
@@ -116,65 +90,33 @@ void __attribute__ ((interrupt(TIMER0_A0_VECTOR))) Timer0_A0_ISR (void)
 
 /* ---------- Main superloop ----------
  * - Registers tasks
- * - In loop, disables interrupts briefly to snapshot and decrement pending counters safely
- * - Calls task functions outside the disabled-interrupt section (cooperative)
- * - Enters LPM0 when no pending work (but checks to avoid race condition)
+ * - Scheduler_Dispatch() sleeps when idle and runs pending tasks (cooperative)
  */
 int main(void)
 {
     WDTCTL = WDTPW | WDTHOLD;     // stop watchdog
 
-    Clk_Init();
+    Clk_Init(CLK_8MHZ);
     Gpio_Init();
+    Defer_Init();
 
-    /* Register tasks (periods in ms). Period must be >= TICK_MS and integer ms. */
-    Scheduler_AddTask(task_10ms, 10, 0);
-    Scheduler_AddTask(task_50ms, 50, 1);
-    Scheduler_AddTask(task_100ms, 100, 3);
+    /* Register tasks (periods in ms). Period must be >= TICK_MS and integer ms. The
+     * 1 and 3 ms offsets keep this set at a 1 ms tick. */
+    Scheduler_AddTask(task_10ms, 10, 0, TASK_10MS_SLICE_MS);
+    Scheduler_AddTask(task_50ms, 50, 1, TASK_50MS_SLICE_MS);
+    Scheduler_AddTask(task_100ms, 100, 3, TASK_100MS_SLICE_MS);
 
-    TimerA0_Init();
+    Background_Init();
+    crc_job = Background_Add(bg_log_crc, CRC_CHUNK_US);
+
+    SysTime_Init();
+    Scheduler_Start();          // tick = GCD of the task set, before interrupts run
 
     __enable_interrupt();
 
     while (1)
     {
-        uint8_t i;
-        uint8_t have_work = 0;
-
-        /* Check if any pending tasks exist atomically. If none, enter LPM0.
-         * We disable interrupts briefly to avoid a race where ISR sets pending
-         * between checking and sleeping.
-         */
-        __disable_interrupt();
-        for (i = 0; i < task_count; i++) {
-            if (tasks[i].pending) { have_work = 1; break; }
-        }
-        if (!have_work) {
-            /* sleep until next tick (ISR will wake via __bic_SR_register_on_exit) */
-            __bis_SR_register(LPM0_bits | GIE);
-        }
-        __enable_interrupt();
-
-        /* Execute tasks that have pending counts.
-         * We snapshot and decrement pending in a short atomic window, then call handlers
-         * while interrupts are enabled so ISR keeps running.
-         */
-        for (i = 0; i < task_count; i++) {
-            uint16_t run_cnt = 0;
-
-            /* snapshot/decrement atomically */
-            __disable_interrupt();
-            if (tasks[i].pending) {
-                run_cnt = tasks[i].pending;
-                tasks[i].pending = 0;   // consume all pending occurrences (coalesced execution)
-            }
-            __enable_interrupt();
-
-            /* run the task 'run_cnt' times (usually 0 or 1). Keep each invocation short. */
-            while (run_cnt--) {
-                tasks[i].fn();
-            }
-        }
+        Scheduler_Dispatch();
 
         /* optional small nop or background work */
         __no_operation();
@@ -185,35 +127,63 @@ int main(void)
  * Keep these short (non-blocking). If a task is long, it will delay other tasks.
  * If you need to preserve missed executions, use a different policy than "coalesce" above.
  */
-static void task_10ms(void)
+static void task_10ms(uint32_t now_ms)
 {
+    (void)now_ms;
     P1OUT ^= BIT3;
     /* Do nothing */
     __delay_cycles(8000);
     P1OUT ^= BIT3;
 }
 
-static void task_50ms(void)
+static void task_50ms(uint32_t now_ms)
 {
+    (void)now_ms;
     P1OUT ^= BIT4;
     /* Do nothing */
     __delay_cycles(16000);
     P1OUT ^= BIT4;
 }
 
-static void task_100ms(void)
+static void task_100ms(uint32_t now_ms)
 {
     P1OUT ^= BIT5;
     /* Do nothing */
     __delay_cycles(40000);
     P1OUT ^= BIT5;
+
+    log_block[(uint16_t)now_ms % LOG_BLOCK_BYTES] = (uint8_t)now_ms;   // new log data
+    Background_Wake((uint8_t)crc_job);
+}
+
+/* ---------- Background job ----------
+ * CRC-16 of log_block, CRC_CHUNK_BYTES per call; returns 0 once the block is done.
+ */
+static uint8_t bg_log_crc(void)
+{
+    static uint16_t pos = 0;
+    uint8_t n;
+
+    if (pos == 0) CRCINIRES = 0xFFFF;
+    for (n = 0; n < CRC_CHUNK_BYTES; n++)
+    {
+        WCET_LOOP_BOUND(CRC_CHUNK_BYTES);
+        CRCDIRB_L = log_block[pos++];
+    }
+    if (pos < LOG_BLOCK_BYTES) return 1;
+
+    log_crc = CRCINIRES;
+    pos = 0;
+    return 0;
 }
 
 /* ---------- Notes & limitations ----------
  * 1) Tasks are cooperative: they must return quickly. If a task blocks for longer than
  *    the smallest scheduling period, other tasks will be delayed or missed.
  *
- * 2) ISR is minimal: local static counters + increment task[i].pending (volatile).
+ * 2) ISR is minimal: tick count + one Defer_Post(); the per-task countdowns run in the
+ *    main loop ahead of the tasks. Other ISRs should hand work off the same way
+ *    (Defer_Post()); Defer_GetStats() reports queue depth and post-to-run latency.
  *    Avoid FRAM writes in ISR; keep ISR code small and data in SRAM.
  *
  * 3) Pending counters are coalesced: if ISR increments pending multiple times before
@@ -224,7 +194,7 @@ static void task_100ms(void)
  *    counters. This window is very short. If you need lock-free atomic ops, adapt to
  *    the platform word-size and use 16-bit atomic access patterns.
  *
- * 5) Timing accuracy: using DCO at 1 MHz is OK for many apps. For strict timekeeping,
+ * 5) Timing accuracy: using the DCO is OK for many apps. For strict timekeeping,
  *    use an external crystal for SMCLK/ACLK or periodically calibrate DCO.
  *
  * 6) Memory/stack: keep stack usage minimal in tasks and avoid calling heavy library
@@ -233,6 +203,8 @@ static void task_100ms(void)
  * 7) Scaling: MAX_TASKS limits the number of tasks; task table is static to avoid dynamic alloc.
  *
  * 8) If you need priorities, you can iterate tasks in priority order or add a priority field.
+ *    Best-effort work goes into background jobs instead: a chunk only starts when it
+ *    ends before the next release (lib/background.c); declare its worst case honestly.
  *
  * 9) Low-power: LPM0 is used; TA0 (SMCLK) runs in LPM0. If you move to deeper LPMs,
  *    ensure the timer source remains active.
@@ -1,8 +1,47 @@
 #include <msp430.h>
 #include <stdint.h>
+#include "clock.h"
+#include "systime.h"
 
 #define MAX_TASKS 8u
 #define MAX_SLOTS 128u
+#define MAX_FRAMES 128u
+
+/* Table backend:
+ * - SCHED_BACKEND_SLOTS: one slot per task instance in the hyperperiod, started at its
+ *   own time (memory grows with hyperperiod / period)
+ * - SCHED_BACKEND_FRAMES: cyclic executive; the hyperperiod is cut into minor frames
+ *   and each frame holds a task bitmask (one byte per frame). The tick ISR only counts
+ *   frame boundaries, the main loop runs the next frame's tasks in order
+ * build_schedule() sets the tick to the GCD of the slot start times (slots) or to the
+ * frame size (frames), so the CPU only wakes when the table can have work. Slot
+ * lateness and slice overruns are timed in TA0 counts (SysTime_Counts()), not ticks
+ */
+#define SCHED_BACKEND_SLOTS  0u
+#define SCHED_BACKEND_FRAMES 1u
+#ifndef SCHED_BACKEND
+#define SCHED_BACKEND SCHED_BACKEND_SLOTS
+#endif
+
+#if MAX_TASKS > 8u
+#error frame_mask holds one bit per task
+#endif
+
+/* build_schedule() results; build/host/hyperperiod proposes periods that fit */
+#define SCHED_OK                0
+#define SCHED_ERR_HYPERPERIOD   (-1)    // hyperperiod does not fit in 32 bits
+#define SCHED_ERR_SLOTS         (-2)    // more than MAX_SLOTS slots per hyperperiod
+#define SCHED_ERR_FRAMES        (-3)    // no minor frame size fits the task set
+
+/* Missed-slot policy: a slot whose start time has passed is either run late
+ * (SLOT_POLICY_LATE) or, when later than SLOT_LATE_TOLERANCE_MS, skipped
+ * (SLOT_POLICY_SKIP). More than one hyperperiod behind, both resynchronize to
+ * the current position in the table and count the slots in between as skipped.
+ */
+#define SLOT_POLICY_LATE 0u
+#define SLOT_POLICY_SKIP 1u
+#define SLOT_POLICY SLOT_POLICY_LATE
+#define SLOT_LATE_TOLERANCE_MS 2u
 
 typedef void (*task_fn_t)(void);
 
@@ -23,13 +62,42 @@ typedef struct
 } slot_t;
 
 static task_def_t tasks[MAX_TASKS];
-static slot_t schedule[MAX_SLOTS];
 static uint8_t num_tasks = 0u;
+#if SCHED_BACKEND == SCHED_BACKEND_SLOTS
+static slot_t schedule[MAX_SLOTS];
 static uint8_t num_slots = 0u;
+#else
+static uint8_t frame_mask[MAX_FRAMES];     // bit i: tasks[i] runs in this frame
+static uint8_t num_frames = 0u;
+static uint16_t frame_ms = 0u;
+#endif
 
-static volatile uint32_t sys_ms = 0u;
 static uint32_t hyperperiod_ms = 0u;
 
+/* ---------- Executor state ---------- */
+typedef struct
+{
+    uint32_t run;          // slots executed
+    uint32_t late;         // executed after their start time
+    uint32_t skipped;      // dropped by policy or resync
+    uint32_t overruns;     // ran longer than duration_ms (frames: frame boundary reached
+                           // before the previous frame finished)
+    uint16_t resyncs;      // position recovered by binary search
+    uint16_t max_late_ms;
+} sched_stats_t;
+
+#if SCHED_BACKEND == SCHED_BACKEND_SLOTS
+static uint8_t slot_idx = 0;
+static uint32_t cycle_start_ms = 0u;  // absolute time of the current hyperperiod start
+static uint16_t counts_per_ms = 0u;   // SysTime_Counts() per ms, for lateness and slices
+#else
+static uint8_t frame_idx = 0u;                // next frame the main loop runs
+static volatile uint16_t frame_tick = 0u;     // ms into the current frame (ISR)
+static volatile uint8_t frames_owed = 0u;     // frame starts not yet taken by the main loop
+static volatile uint8_t frame_busy = 0u;      // main loop is inside a frame
+#endif
+static sched_stats_t sched_stats;
+
 /* ---------- User tasks ---------- */
 void task_1(void)
 {
@@ -49,7 +117,7 @@ void task_3(void)
 /* ---------- Add task ---------- */
 void add_task(const char *name, task_fn_t fn, uint16_t period, uint16_t slice)
 {
-    if (num_tasks >= MAX_TASKS)
+    if (num_tasks >= MAX_TASKS || period == 0u)
         return;
     tasks[num_tasks++] = (task_def_t){ name, period, slice, 0, fn };
 }
@@ -66,21 +134,37 @@ static uint32_t gcd(uint32_t a, uint32_t b)
     return a;
 }
 
+/* 0 if the result does not fit in 32 bits */
 static uint32_t lcm(uint32_t a, uint32_t b)
 {
-    return a / gcd(a, b) * b;
+    uint64_t l;
+
+    if (a == 0u || b == 0u)
+        return 0u;
+    l = (uint64_t)(a / gcd(a, b)) * b;
+    return l > UINT32_MAX ? 0u : (uint32_t)l;
 }
 
+/* Hyperperiod in ms, 0 if there are no tasks or it overflows */
 uint32_t compute_hyperperiod(void)
 {
     if (num_tasks == 0)
         return 0u;
     uint32_t hyper = tasks[0u].period_ms;
-    for (uint8_t i = 1u; i < num_tasks; i++)
+    for (uint8_t i = 1u; i < num_tasks && hyper; i++)
         hyper = lcm(hyper, tasks[i].period_ms);
     return hyper;
 }
 
+/* Slots in one hyperperiod: one per task instance */
+uint32_t count_slots(uint32_t hyper)
+{
+    uint32_t slots = 0u;
+    for (uint8_t i = 0u; i < num_tasks; i++)
+        slots += hyper / tasks[i].period_ms;
+    return slots;
+}
+
 /* ---------- Compute offsets automatically ---------- */
 void compute_offsets(void)
 {
@@ -106,10 +190,20 @@ void compute_offsets(void)
     }
 }
 
-/* ---------- Build schedule table ---------- */
-void build_schedule(void)
+#if SCHED_BACKEND == SCHED_BACKEND_SLOTS
+/* ---------- Build schedule table ----------
+ * Refuses task sets whose table would not fit instead of truncating it.
+ */
+int build_schedule(void)
 {
-    hyperperiod_ms = compute_hyperperiod();
+    uint32_t hyper = compute_hyperperiod();
+
+    if (hyper == 0u)
+        return SCHED_ERR_HYPERPERIOD;
+    if (count_slots(hyper) > MAX_SLOTS)
+        return SCHED_ERR_SLOTS;
+
+    hyperperiod_ms = hyper;
     num_slots = 0;
 
     for (uint8_t i = 0; i < num_tasks; i++)
@@ -119,10 +213,7 @@ void build_schedule(void)
         for (uint32_t n = 0; n < instances; n++)
         {
             uint32_t start = t->offset_ms + n * t->period_ms;
-            if (num_slots < MAX_SLOTS)
-            {
-                schedule[num_slots++] = (slot_t){ t->func, start, t->slice_ms };
-            }
+            schedule[num_slots++] = (slot_t){ t->func, start, t->slice_ms };
         }
     }
 
@@ -139,8 +230,134 @@ void build_schedule(void)
             }
         }
     }
+
+    // every slot starts on a multiple of this: no tick in between can start one
+    uint32_t g = 0u;
+    for (uint8_t i = 0; i < num_tasks; i++)
+        g = gcd(gcd(g, tasks[i].period_ms), tasks[i].offset_ms);
+    SysTime_SetTickMs(SysTime_FitTickMs((uint16_t)g));
+    counts_per_ms = SysTime_CountsPerMs();
+
+    // executor starts at the first slot of a hyperperiod beginning now
+    slot_idx = 0;
+    cycle_start_ms = SysTime_Now();
+    sched_stats = (sched_stats_t){ 0 };
+    return SCHED_OK;
+}
+
+#else
+
+/* ---------- Build frame table ----------
+ * Minor frame f (Baker & Shaw): f >= every slice, f divides the hyperperiod, and
+ * 2f - gcd(f, T) <= T so a whole frame lies between each release and deadline. Sizes
+ * are tried from the largest down (fewest frames); jobs are packed frame by frame,
+ * earliest deadline first, while the slices fit in the frame.
+ */
+static int pack_frames(uint16_t f, uint32_t hyper)
+{
+    uint8_t next[MAX_TASKS] = { 0 };    // next job to place, per task (<= 1 per frame)
+    uint32_t frames = hyper / f;
+
+    if (frames > MAX_FRAMES)
+        return -1;
+    for (uint8_t k = 0; k < frames; k++)
+    {
+        uint32_t start = (uint32_t)k * f;
+        uint16_t room = f;
+        uint8_t mask = 0u;
+
+        for (;;)
+        {
+            int8_t pick = -1;
+            uint32_t pick_deadline = 0u;
+
+            for (uint8_t i = 0; i < num_tasks; i++)
+            {
+                uint32_t release = (uint32_t)next[i] * tasks[i].period_ms;
+                uint32_t deadline = release + tasks[i].period_ms;
+
+                if ((mask & (1u << i)) || release >= hyper || release > start)
+                    continue;
+                if (deadline < start + f)
+                    return -1;                  // job can no longer complete in time
+                if (tasks[i].slice_ms > room)
+                    continue;
+                if (pick < 0 || deadline < pick_deadline)
+                {
+                    pick = (int8_t)i;
+                    pick_deadline = deadline;
+                }
+            }
+            if (pick < 0)
+                break;
+            mask |= (uint8_t)(1u << pick);
+            room -= tasks[pick].slice_ms;
+            next[pick]++;
+        }
+        frame_mask[k] = mask;
+    }
+    for (uint8_t i = 0; i < num_tasks; i++)
+    {
+        if ((uint32_t)next[i] * tasks[i].period_ms != hyper)
+            return -1;
+    }
+    num_frames = (uint8_t)frames;
+    frame_ms = f;
+    return 0;
+}
+
+int build_schedule(void)
+{
+    uint32_t hyper = compute_hyperperiod();
+    uint16_t min_period = 0xFFFFu, max_slice = 1u;
+    uint16_t f;
+
+    if (hyper == 0u)
+        return SCHED_ERR_HYPERPERIOD;
+
+    // shortest period first: frame order is run order
+    for (uint8_t i = 1; i < num_tasks; i++)
+    {
+        for (uint8_t j = i; j > 0 && tasks[j].period_ms < tasks[j - 1].period_ms; j--)
+        {
+            task_def_t tmp = tasks[j];
+            tasks[j] = tasks[j - 1];
+            tasks[j - 1] = tmp;
+        }
+    }
+    for (uint8_t i = 0; i < num_tasks; i++)
+    {
+        if (tasks[i].period_ms < min_period) min_period = tasks[i].period_ms;
+        if (tasks[i].slice_ms > max_slice) max_slice = tasks[i].slice_ms;
+        tasks[i].offset_ms = 0u;
+    }
+
+    for (f = min_period; f >= max_slice; f--)
+    {
+        uint8_t ok = (hyper % f) == 0u;
+
+        for (uint8_t i = 0; i < num_tasks && ok; i++)
+            ok = 2u * f - gcd(f, tasks[i].period_ms) <= tasks[i].period_ms;
+        if (ok && pack_frames(f, hyper) == 0)
+            break;
+    }
+    if (f < max_slice)
+        return SCHED_ERR_FRAMES;
+
+    // only frame boundaries need a tick
+    SysTime_SetTickMs(SysTime_FitTickMs(frame_ms));
+
+    hyperperiod_ms = hyper;
+    frame_idx = 0u;
+    frame_tick = 0u;
+    frame_busy = 0u;
+    frames_owed = 1u;                       // frame 0 starts now
+    sched_stats = (sched_stats_t){ 0 };
+    return SCHED_OK;
 }
 
+#endif
+
 /* ---------- Timer ISR ---------- */
 #if defined(__TI_COMPILER_VERSION__) || defined(__IAR_SYSTEMS_ICC__)
 #pragma vector = TIMER0_A0_VECTOR
@@ -151,7 +368,16 @@ void __attribute__ ((interrupt(TIMER0_A0_VECTOR))) timer_0_a0_isr (void)
 #error Compiler not supported!
 #endif
 {
-    sys_ms++;
+    SysTime_Tick();
+#if SCHED_BACKEND == SCHED_BACKEND_FRAMES
+    if (num_frames && (frame_tick += SysTime_TickMs()) >= frame_ms)
+    {
+        frame_tick = 0u;
+        if (frame_busy || frames_owed)
+            sched_stats.overruns++;     // previous frame still running or not started
+        frames_owed++;
+    }
+#endif
     __bic_SR_register_on_exit(LPM0_bits);
 }
 
@@ -163,42 +389,153 @@ void gpio_init(void)
     P1OUT &= ~(BIT0 | BIT1);
 }
 
-/* ---------- Timer ---------- */
-void systick_init(void)
+#if SCHED_BACKEND == SCHED_BACKEND_SLOTS
+/* ---------- Scheduler execution ---------- */
+
+/* Absolute due time of the current slot */
+static uint32_t slot_due_ms(void)
 {
-    TA0CCR0 = 999;
-    TA0CCTL0 = CCIE;
-    TA0CTL = TASSEL__SMCLK | MC__UP | TACLR;
+    return cycle_start_ms + schedule[slot_idx].start_ms;
 }
 
-/* ---------- Scheduler execution ---------- */
-static uint8_t slot_idx = 0;
+static void next_slot(void)
+{
+    if (++slot_idx >= num_slots)
+    {
+        slot_idx = 0;
+        cycle_start_ms += hyperperiod_ms;
+    }
+}
 
-void run_scheduler(void)
+/* First slot with start_ms >= phase_ms (num_slots if none) */
+static uint8_t find_slot(uint32_t phase_ms)
+{
+    uint8_t lo = 0, hi = num_slots;
+    while (lo < hi)
+    {
+        uint8_t mid = (uint8_t)((lo + hi) / 2u);
+        if (schedule[mid].start_ms < phase_ms)
+            lo = mid + 1u;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+/* Jump to the first slot not yet due at now_ms, counting the ones passed over */
+static void resync(uint32_t now_ms)
 {
+    uint32_t elapsed = now_ms - cycle_start_ms;
+    uint32_t cycles = elapsed / hyperperiod_ms;
+    uint8_t idx = find_slot(elapsed % hyperperiod_ms);
+
+    sched_stats.skipped += cycles * num_slots + idx - slot_idx;
+    sched_stats.resyncs++;
+    cycle_start_ms += cycles * hyperperiod_ms;
+    slot_idx = idx;
     if (slot_idx >= num_slots)
+    {
         slot_idx = 0;
-    slot_t *s = &schedule[slot_idx];
-    if ((sys_ms % hyperperiod_ms) == s->start_ms)
+        cycle_start_ms += hyperperiod_ms;
+    }
+}
+
+/* Non-zero if the current slot's start time has been reached */
+static uint8_t slot_due(void)
+{
+    return num_slots && (int32_t)(SysTime_Now() - slot_due_ms()) >= 0;
+}
+
+/* Run every slot whose start time has passed, oldest first */
+void run_scheduler(void)
+{
+    uint32_t now_ms = SysTime_Now();
+
+    if (num_slots == 0)
+        return;
+
+    // far behind (long overrun, debugger halt): recover position instead of replaying
+    if ((int32_t)(now_ms - slot_due_ms()) > (int32_t)hyperperiod_ms)
+        resync(now_ms);
+
+    while ((int32_t)(now_ms - slot_due_ms()) >= 0)
     {
-        uint32_t start_ms = sys_ms;
-        s->func();
-        if ((sys_ms - start_ms) >= s->duration_ms)
+        slot_t *s = &schedule[slot_idx];
+        // the tick may be several ms long: time the slot in counts, not in ticks
+        uint32_t start = SysTime_Counts();
+        uint32_t late_ms = (start - slot_due_ms() * counts_per_ms) / counts_per_ms;
+
+        if (SLOT_POLICY == SLOT_POLICY_SKIP && late_ms > SLOT_LATE_TOLERANCE_MS)
         {
-            // exceeded slice
+            sched_stats.skipped++;
         }
-        slot_idx++;
+        else
+        {
+            if (late_ms)
+            {
+                sched_stats.late++;
+                if (late_ms > sched_stats.max_late_ms)
+                    sched_stats.max_late_ms = (uint16_t)late_ms;
+            }
+            s->func();
+            sched_stats.run++;
+            if (SysTime_Counts() - start > (uint32_t)s->duration_ms * counts_per_ms)
+            {
+                sched_stats.overruns++;   // exceeded slice
+            }
+        }
+        next_slot();
+        now_ms = SysTime_Now();
     }
 }
 
-/* ---------- Clock ---------- */
-void clk_init(void)
+#else
+
+/* ---------- Scheduler execution ---------- */
+
+/* Non-zero if a frame boundary has passed that the main loop has not started */
+static uint8_t slot_due(void)
 {
-    CSCTL0_H = CSKEY >> 8;
-    CSCTL1 = DCOFSEL_0;
-    CSCTL2 = SELA__VLOCLK | SELS__DCOCLK | SELM__DCOCLK;
-    CSCTL3 = DIVA__1 | DIVS__1 | DIVM__1;
-    CSCTL0_H = 0;
+    return frames_owed != 0u;
+}
+
+/* Run every frame whose boundary has passed, in table order */
+void run_scheduler(void)
+{
+    while (frames_owed)
+    {
+        uint8_t mask = frame_mask[frame_idx];
+        uint16_t sr = __get_interrupt_state();
+
+        __disable_interrupt();
+        frames_owed--;
+        frame_busy = 1u;
+        __set_interrupt_state(sr);
+
+        for (uint8_t i = 0; mask; i++, mask >>= 1)
+        {
+            if (mask & 1u)
+            {
+                tasks[i].func();
+                sched_stats.run++;
+            }
+        }
+        frame_busy = 0u;
+        if (++frame_idx >= num_frames)
+            frame_idx = 0u;
+    }
+}
+
+#endif
+
+/* ---------- Main loop pass: sleep until the next slot is due, then run the table ---------- */
+void scheduler_step(void)
+{
+    __disable_interrupt();
+    if (!slot_due())
+        __bis_SR_register(LPM0_bits | GIE);
+    __enable_interrupt();
+    run_scheduler();
 }
 
 /* ---------- Main ---------- */
@@ -206,24 +543,26 @@ int main(void)
 {
     WDTCTL = WDTPW | WDTHOLD;
 
-    clk_init();
+    Clk_Init(CLK_1MHZ);
     gpio_init();
-    systick_init();
+    SysTime_Init();
 
     add_task("T1", task_1, 10, 2);
     add_task("T2", task_2, 50, 5);
     add_task("T3", task_3, 100, 10);
 
     compute_offsets();
-    build_schedule();
+    if (build_schedule() != SCHED_OK)
+    {
+        P1OUT |= BIT0 | BIT1;   // table does not fit: both LEDs on, halt
+        for (;;)
+            __no_operation();
+    }
 
     __enable_interrupt();
 
     while(1)
     {
-        __disable_interrupt();
-        __bis_SR_register(LPM0_bits | GIE);
-        __enable_interrupt();
-        run_scheduler();
+        scheduler_step();
     }
 }
@@ -0,0 +1,170 @@
+/*
+ * Sensor polling without busy-waiting: queued I2C/SPI transactions (lib/bus.c) @ 8 MHz
+ * - B0 is an I2C master at 400 kHz with a temperature sensor at 0x48 (TMP102-style:
+ *   register 0 holds a 12-bit reading, left aligned)
+ * - B1 is an SPI master at 1 MHz with an accelerometer, chip select on P4.1
+ *   (ADXL345-style: SPI mode 3, read bit 0x80 and multi-byte bit 0x40 in the address
+ *   byte)
+ * - A 100 ms task submits both reads and returns; the bytes move by DMA while the CPU
+ *   sleeps, and the completion callbacks run as deferred work in the main loop
+ * - A 1 s task prints the latest values and the per-port counters
+ *
+ * Key patterns:
+ * - Transfer blocks and buffers are static: one transaction of each kind in flight
+ * - A register read is a one-byte write segment chained to a read segment
+ * - The DMA and USCI_B0 ISRs only hand their event to the engine
+ */
+
+#include <msp430.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "clock.h"
+#include "systime.h"
+#include "scheduler.h"
+#include "defer.h"
+#include "bus.h"
+#include "uart.h"
+
+#define TEMP_ADDR       0x48u
+#define ACCEL_DATAX0    0x32u
+#define ACCEL_READ      0xC0u   // read, multi-byte
+
+static void task_100ms(uint32_t now);
+static void task_1s(uint32_t now);
+static void temp_done(uintptr_t arg);
+static void accel_done(uintptr_t arg);
+
+static const bus_dev_t temp_dev = { BUS_B0, TEMP_ADDR, NULL, 0 };
+static const bus_dev_t accel_dev = { BUS_B1, 0, &P4OUT, BIT1, BUS_SPI_MODE3 };
+
+/* Temperature: write the register pointer, then read two bytes with a repeated START */
+static const uint8_t temp_reg = 0x00;
+static uint8_t temp_raw[2];
+static bus_xfer_t temp_rd = { NULL, NULL, NULL, NULL, temp_raw, 2, BUS_OK, NULL };
+static bus_xfer_t temp_xfer = { NULL, &temp_rd, &temp_dev, &temp_reg, NULL, 1, BUS_OK, temp_done };
+
+/* Acceleration: address byte, then six data bytes with chip select held low */
+static const uint8_t accel_cmd = ACCEL_READ | ACCEL_DATAX0;
+static uint8_t accel_raw[6];
+static bus_xfer_t accel_rd = { NULL, NULL, NULL, NULL, accel_raw, 6, BUS_OK, NULL };
+static bus_xfer_t accel_xfer = { NULL, &accel_rd, &accel_dev, &accel_cmd, NULL, 1, BUS_OK, accel_done };
+
+static int16_t temp_c16;        // 1/16 degree C
+static int16_t accel[3];
+static uint16_t temp_errors = 0;
+
+void Gpio_Init(void)
+{
+    PM5CTL0 &= ~LOCKLPM5;
+    P1DIR |= BIT0;
+    P1OUT &= ~BIT0;
+    P4DIR |= BIT1;              // accelerometer chip select, idle high
+    P4OUT |= BIT1;
+}
+
+/* ---------- ISRs ---------- */
+
+#if defined(__TI_COMPILER_VERSION__) || defined(__IAR_SYSTEMS_ICC__)
+#pragma vector = TIMER0_A0_VECTOR
+__interrupt void Timer0_A0_ISR (void)
+#elif defined(__GNUC__)
+void __attribute__ ((interrupt(TIMER0_A0_VECTOR))) Timer0_A0_ISR (void)
+#else
+#error Compiler not supported!
+#endif
+{
+    SysTime_Tick();
+    Scheduler_TickDeferred();
+    __bic_SR_register_on_exit(LPM0_bits);
+}
+
+#if defined(__TI_COMPILER_VERSION__) || defined(__IAR_SYSTEMS_ICC__)
+#pragma vector = DMA_VECTOR
+__interrupt void Dma_ISR (void)
+#elif defined(__GNUC__)
+void __attribute__ ((interrupt(DMA_VECTOR))) Dma_ISR (void)
+#else
+#error Compiler not supported!
+#endif
+{
+    Bus_DmaIsr(DMAIV);
+    __bic_SR_register_on_exit(LPM0_bits);     // a completion may have been posted
+}
+
+#if defined(__TI_COMPILER_VERSION__) || defined(__IAR_SYSTEMS_ICC__)
+#pragma vector = USCI_B0_VECTOR
+__interrupt void Usci_B0_ISR (void)
+#elif defined(__GNUC__)
+void __attribute__ ((interrupt(USCI_B0_VECTOR))) Usci_B0_ISR (void)
+#else
+#error Compiler not supported!
+#endif
+{
+    Bus_UsciIsr(BUS_B0);
+    __bic_SR_register_on_exit(LPM0_bits);
+}
+
+/* ---------- Main superloop ---------- */
+int main(void)
+{
+    WDTCTL = WDTPW | WDTHOLD;
+
+    Clk_Init(CLK_8MHZ);
+    Gpio_Init();
+    Uart_Init();
+    Defer_Init();
+    Bus_Init(BUS_B0, BUS_I2C, 400000u);
+    Bus_Init(BUS_B1, BUS_SPI, 1000000u);
+
+    Scheduler_AddTask(task_100ms, 100, 0, 1);
+    Scheduler_AddTask(task_1s, 1000, 5, 0);
+
+    SysTime_Init();
+    __enable_interrupt();
+
+    while (1)
+    {
+        Scheduler_Dispatch();
+    }
+}
+
+/* ---------- Completions (deferred work) ---------- */
+
+static void temp_done(uintptr_t arg)
+{
+    const bus_xfer_t *x = (const bus_xfer_t *)arg;
+
+    if (x->status != BUS_OK) { temp_errors++; return; }
+    temp_c16 = (int16_t)(((uint16_t)temp_raw[0] << 8) | temp_raw[1]) >> 4;
+}
+
+static void accel_done(uintptr_t arg)
+{
+    uint8_t i;
+
+    (void)arg;
+    for (i = 0; i < 3; i++)
+        accel[i] = (int16_t)(((uint16_t)accel_raw[2 * i + 1] << 8) | accel_raw[2 * i]);
+}
+
+/* ---------- Tasks ---------- */
+
+/**
+ * @brief Start both reads; a block still in flight from the last period is skipped.
+ */
+static void task_100ms(uint32_t now)
+{
+    (void)now;
+    P1OUT ^= BIT0;
+    Bus_Submit(&temp_xfer);
+    Bus_Submit(&accel_xfer);
+}
+
+static void task_1s(uint32_t now)
+{
+    const bus_stats_t *i2c = Bus_GetStats(BUS_B0);
+
+    printf("[%lu] temp %d.%02u C  accel %d %d %d  i2c ok %lu err %u\n\r", (unsigned long)now,
+           temp_c16 / 16, (unsigned)((temp_c16 & 15) * 100 / 16), accel[0], accel[1], accel[2],
+           (unsigned long)i2c->completed, i2c->errors);
+}
@@ -0,0 +1,116 @@
+/*
+ * Compile-time task set (lib/static_scheduler.hpp) for MSP430FR5994
+ * - Same tasks and clock as src/scheduler.c: MCLK = SMCLK = 8 MHz, tasks of 10/50/100 ms
+ *   with offsets 0/1/3 ms on a fixed TA0 CCR0 1 ms tick, the tick Scheduler_Start()
+ *   derives for that set
+ * - The task list is a type; the tick ISR and the dispatch pass are generated as
+ *   straight-line code with the periods as constants and direct task calls
+ * - Periods, offsets, slices and utilization are checked by static_assert
+ *
+ * Key patterns:
+ * - The countdowns run in the ISR, with constant reloads and no loop over a table,
+ *   instead of being posted as deferred work (src/scheduler.c)
+ * - Compare with the table-driven build:
+ *   make report REPORT_APPS="scheduler static_scheduler" prints size and static cycles
+ *   of the tick ISR and main() (dispatch inlined) for both
+ * - The lib/ C headers are included inside extern "C" by the scheduler header
+ */
+
+#include "static_scheduler.hpp"
+
+extern "C" {
+#include "clock.h"
+#include "wcet.h"
+#include "hot.h"
+}
+
+/* ---------- Task set ---------- */
+#define TASK_10MS_SLICE_MS    2
+#define TASK_50MS_SLICE_MS    3
+#define TASK_100MS_SLICE_MS   6
+
+/* Every ISR must stay below this many cycles (tools/wcet.py) */
+#define ISR_BUDGET_CYCLES     400
+
+static void task_10ms(uint32_t now_ms);
+static void task_50ms(uint32_t now_ms);
+static void task_100ms(uint32_t now_ms);
+
+using Tasks = sched::StaticScheduler<
+    sched::Task<task_10ms, 10, 0, TASK_10MS_SLICE_MS>,
+    sched::Task<task_50ms, 50, 1, TASK_50MS_SLICE_MS>,
+    sched::Task<task_100ms, 100, 3, TASK_100MS_SLICE_MS>>;
+
+WCET_CLOCK_HZ(8000000);
+WCET_ISR_BUDGET(ISR_BUDGET_CYCLES);
+
+/* ---------- GPIO init ---------- */
+static void Gpio_Init(void)
+{
+    PM5CTL0 &= ~LOCKLPM5;
+    P1DIR |= BIT3 | BIT4 | BIT5;
+    P1OUT &= ~(BIT3 | BIT4 | BIT5);
+}
+
+/* ---------- ISR: time and all countdowns, no calls through a table ---------- */
+#if defined(__TI_COMPILER_VERSION__) || defined(__IAR_SYSTEMS_ICC__)
+#pragma vector = TIMER0_A0_VECTOR
+extern "C" __interrupt void Timer0_A0_ISR (void)
+#elif defined(__GNUC__)
+extern "C" HOT_FN void __attribute__ ((interrupt(TIMER0_A0_VECTOR))) Timer0_A0_ISR (void)
+#else
+#error Compiler not supported!
+#endif
+{
+    SysTime_Tick();
+    Tasks::tick();
+
+    /* Wake up main loop after ISR */
+    __bic_SR_register_on_exit(LPM0_bits);
+}
+
+/* ---------- Main superloop ---------- */
+int main(void)
+{
+    WDTCTL = WDTPW | WDTHOLD;     // stop watchdog
+
+    Clk_Init(CLK_8MHZ);
+    Gpio_Init();
+    Defer_Init();
+
+    SysTime_Init();
+
+    __enable_interrupt();
+
+    while (1)
+    {
+        Tasks::dispatch();
+    }
+}
+
+/* ---------- Example user tasks ----------
+ * Same busy loops as src/scheduler.c. Tasks::overruns(i) counts slice overruns.
+ */
+static void task_10ms(uint32_t now_ms)
+{
+    (void)now_ms;
+    P1OUT ^= BIT3;
+    __delay_cycles(8000);
+    P1OUT ^= BIT3;
+}
+
+static void task_50ms(uint32_t now_ms)
+{
+    (void)now_ms;
+    P1OUT ^= BIT4;
+    __delay_cycles(16000);
+    P1OUT ^= BIT4;
+}
+
+static void task_100ms(uint32_t now_ms)
+{
+    (void)now_ms;
+    P1OUT ^= BIT5;
+    __delay_cycles(40000);
+    P1OUT ^= BIT5;
+}
@@ -0,0 +1,175 @@
+/*
+ * Compressed telemetry over the UART (lib/tpack.c) @ 8 MHz
+ * - Every 10 ms three ADC12 inputs (A2..A4 on P1.2, P1.3, P1.4) are sampled through
+ *   aio.h, one single-conversion request each on the ADC device, run in order
+ * - The next 10 ms task encodes that row (delta + zigzag + Rice) into the current
+ *   packet: slowly varying inputs take 3..4 bits per sample instead of 16
+ * - A full packet goes out as [len][packet] by Uart_AioTx from one of two buffers while
+ *   the other one fills; the host decodes a capture with build/host/tpackchk -c 3 -x
+ *
+ * Key patterns:
+ * - TPack_Put() has a static worst case, so the task is checked against its slice
+ *   (WCET_SLICE) like any other
+ * - A packet that cannot be sent because both buffers are busy is dropped whole:
+ *   every packet decodes on its own, so the host only loses those rows
+ */
+
+#include <msp430.h>
+#include <stdint.h>
+#include "clock.h"
+#include "systime.h"
+#include "scheduler.h"
+#include "defer.h"
+#include "aio.h"
+#include "uart.h"
+#include "adc.h"
+#include "tpack.h"
+#include "wcet.h"
+
+#define DEV_TX          0u
+#define DEV_ADC         1u
+
+#define CHANNELS        3u
+#define PACKET_BYTES    200u
+
+static void task_10ms(uint32_t now);
+
+static uint16_t sample[CHANNELS];
+static aio_req_t adc_req[CHANNELS] = {
+    { .dev = DEV_ADC, .op = AIO_READ, .target = (const void *)2, .buf = (uint8_t *)&sample[0], .len = 2 },
+    { .dev = DEV_ADC, .op = AIO_READ, .target = (const void *)3, .buf = (uint8_t *)&sample[1], .len = 2 },
+    { .dev = DEV_ADC, .op = AIO_READ, .target = (const void *)4, .buf = (uint8_t *)&sample[2], .len = 2 },
+};
+
+/* Frame = length byte + packet */
+static uint8_t frame[2][1 + PACKET_BYTES];
+static aio_req_t tx_req[2] = {
+    { .dev = DEV_TX, .op = AIO_WRITE, .buf = frame[0] },
+    { .dev = DEV_TX, .op = AIO_WRITE, .buf = frame[1] },
+};
+static uint8_t fill = 0;
+static tpack_t pack;
+static uint16_t packets_dropped = 0;
+
+WCET_CLOCK_HZ(8000000);
+WCET_SLICE(task_10ms, 1);
+
+void Gpio_Init(void)
+{
+    PM5CTL0 &= ~LOCKLPM5;
+    P1DIR |= BIT0;
+    P1OUT &= ~BIT0;
+    P1SEL1 |= BIT2 | BIT3 | BIT4;   // A2..A4
+    P1SEL0 |= BIT2 | BIT3 | BIT4;
+}
+
+/* ---------- ISRs ---------- */
+
+#if defined(__TI_COMPILER_VERSION__) || defined(__IAR_SYSTEMS_ICC__)
+#pragma vector = TIMER0_A0_VECTOR
+__interrupt void Timer0_A0_ISR (void)
+#elif defined(__GNUC__)
+void __attribute__ ((interrupt(TIMER0_A0_VECTOR))) Timer0_A0_ISR (void)
+#else
+#error Compiler not supported!
+#endif
+{
+    SysTime_Tick();
+    Scheduler_TickDeferred();
+    __bic_SR_register_on_exit(LPM0_bits);
+}
+
+#if defined(__TI_COMPILER_VERSION__) || defined(__IAR_SYSTEMS_ICC__)
+#pragma vector = USCI_A0_VECTOR
+__interrupt void Usci_A0_ISR (void)
+#elif defined(__GNUC__)
+void __attribute__ ((interrupt(USCI_A0_VECTOR))) Usci_A0_ISR (void)
+#else
+#error Compiler not supported!
+#endif
+{
+    Uart_Isr();
+    __bic_SR_register_on_exit(LPM0_bits);
+}
+
+#if defined(__TI_COMPILER_VERSION__) || defined(__IAR_SYSTEMS_ICC__)
+#pragma vector = ADC12_B_VECTOR
+__interrupt void Adc12_ISR (void)
+#elif defined(__GNUC__)
+void __attribute__ ((interrupt(ADC12_B_VECTOR))) Adc12_ISR (void)
+#else
+#error Compiler not supported!
+#endif
+{
+    Adc_Isr();
+    __bic_SR_register_on_exit(LPM0_bits);
+}
+
+/* ---------- Main superloop ---------- */
+int main(void)
+{
+    WDTCTL = WDTPW | WDTHOLD;
+
+    Clk_Init(CLK_8MHZ);
+    Gpio_Init();
+    Uart_Init();
+    Defer_Init();
+    Adc_Init();
+
+    Aio_Attach(DEV_TX, &Uart_AioTx);
+    Aio_Attach(DEV_ADC, &Adc_AioOps);
+
+    TPack_Init(&pack, CHANNELS);
+    TPack_Begin(&pack, &frame[fill][1], PACKET_BYTES);
+    Scheduler_AddTask(task_10ms, 10, 0, 1);
+
+    SysTime_Init();
+    __enable_interrupt();
+
+    while (1)
+    {
+        Scheduler_Dispatch();
+    }
+}
+
+/* ---------- Tasks ---------- */
+
+/* Send the filled packet and continue in the other buffer, or reuse this one */
+static void send_packet(void)
+{
+    uint16_t len = TPack_End(&pack);
+
+    if (len && tx_req[fill ^ 1u].status != AIO_PENDING)
+    {
+        frame[fill][0] = (uint8_t)len;
+        tx_req[fill].len = len + 1u;
+        Aio_Submit(&tx_req[fill]);
+        fill ^= 1u;
+        P1OUT ^= BIT0;
+    }
+    else if (len)
+    {
+        packets_dropped++;
+    }
+    TPack_Begin(&pack, &frame[fill][1], PACKET_BYTES);
+}
+
+/**
+ * @brief Encode the row sampled last period, then start the next three conversions.
+ */
+static void task_10ms(uint32_t now)
+{
+    uint8_t c;
+
+    (void)now;
+    if (adc_req[CHANNELS - 1u].status == AIO_OK)
+    {
+        if (TPack_Put(&pack, sample) != 0)
+        {
+            send_packet();
+            TPack_Put(&pack, sample);
+        }
+    }
+    for (c = 0; c < CHANNELS; c++)
+        Aio_Submit(&adc_req[c]);
+}
@@ -1,17 +1,6 @@
 #include <msp430.h>
 #include <stdio.h>
-
-void Clk_Init(void)
-{
-    // Startup clock system with max DCO setting ~8MHz
-    CSCTL0_H = CSKEY_H;                     // Unlock CS registers
-    CSCTL1 = DCOFSEL_6;                     // Set DCO to 8MHz
-    CSCTL2 = SELA__VLOCLK | SELS__DCOCLK | SELM__DCOCLK;
-    CSCTL3 = DIVA__1 | DIVS__1 | DIVM__1;   // Set all dividers
-    CSCTL0_H = 0;                           // Lock CS registers
-
-    __delay_cycles(10000);  // Wait for clock set
-}
+#include "clock.h"
 
 void app_timer(void)
 {
@@ -36,7 +25,7 @@ int main( void )
     WDTCTL = WDTPW | WDTHOLD;               // Stop watchdog timer
     PM5CTL0 &= ~LOCKLPM5;                   // Disable the GPIO power-on default high-impedance mode
 
-    Clk_Init();
+    Clk_Init(CLK_8MHZ);
 
     app_timer();
 }
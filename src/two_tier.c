@@ -0,0 +1,175 @@
+/*
+ * Two-tier timebase for MSP430FR5994
+ * - MCLK = SMCLK = 8 MHz (DCO)
+ * - TB0 CCR0 => 4 kHz high-rate tier (lib/hirate.c): 250 us control loop and a
+ *   1 kHz filter run inside the ISR with a reserved CPU budget
+ * - TA0 CCR0 => 1 ms tick for the cooperative scheduler (lib/scheduler.c)
+ *
+ * Key patterns:
+ * - High-rate tasks are admitted only if the worst tick fits HIRATE_BUDGET_PCT;
+ *   their declared cycle counts are what HiRate_AddTask() checks
+ * - TIMER0_B0 has a higher interrupt priority than TIMER0_A0, so its jitter is bounded
+ *   by the longest other ISR or interrupt-disabled window, not by task length
+ * - The 1 ms tasks see the reserved share as interference (WCET_ISR_RATE below)
+ */
+
+#include <msp430.h>
+#include <stdint.h>
+#include "clock.h"
+#include "systime.h"
+#include "scheduler.h"
+#include "hirate.h"
+#include "wcet.h"
+
+#define MCLK_HZ               8000000
+#define HIRATE_HZ             4000
+
+/* ---------- High-rate task set (cycles, checked against the reserved budget) ---------- */
+#define CONTROL_WCET_CYCLES   200
+#define FILTER_WCET_CYCLES    150
+
+/* ---------- 1 ms task set ---------- */
+#define TASK_10MS_SLICE_MS    2
+#define TASK_100MS_SLICE_MS   4
+
+static void control_loop(void);
+static void filter_1khz(void);
+static void task_10ms(uint32_t now_ms);
+static void task_100ms(uint32_t now_ms);
+
+WCET_CLOCK_HZ(MCLK_HZ);
+WCET_ISR_RATE(Timer0_B0_ISR, HIRATE_HZ, (MCLK_HZ / HIRATE_HZ * HIRATE_BUDGET_PCT / 100));
+WCET_SLICE(task_10ms, TASK_10MS_SLICE_MS);
+WCET_SLICE(task_100ms, TASK_100MS_SLICE_MS);
+
+/* ---------- Shared state (high-rate tier writes, 1 ms tier reads) ---------- */
+static volatile int16_t setpoint = 0;
+static volatile int16_t output = 0;
+static volatile int16_t filtered = 0;
+static int32_t integral = 0;
+
+/* ---------- GPIO init ---------- */
+void Gpio_Init(void)
+{
+    PM5CTL0 &= ~LOCKLPM5;
+    P1DIR |= BIT3 | BIT4 | BIT5;
+    P1OUT &= ~(BIT3 | BIT4 | BIT5);
+}
+
+/* ---------- ISRs ---------- */
+#if defined(__TI_COMPILER_VERSION__) || defined(__IAR_SYSTEMS_ICC__)
+#pragma vector = TIMER0_B0_VECTOR
+__interrupt void Timer0_B0_ISR (void)
+#elif defined(__GNUC__)
+void __attribute__ ((interrupt(TIMER0_B0_VECTOR))) Timer0_B0_ISR (void)
+#else
+#error Compiler not supported!
+#endif
+{
+    /* Runs high-rate tasks in place; does not wake the main loop */
+    HiRate_Tick();
+}
+
+#if defined(__TI_COMPILER_VERSION__) || defined(__IAR_SYSTEMS_ICC__)
+#pragma vector = TIMER0_A0_VECTOR
+__interrupt void Timer0_A0_ISR (void)
+#elif defined(__GNUC__)
+void __attribute__ ((interrupt(TIMER0_A0_VECTOR))) Timer0_A0_ISR (void)
+#else
+#error Compiler not supported!
+#endif
+{
+    SysTime_Tick();
+    Scheduler_Tick();
+
+    /* Wake up main loop after ISR */
+    __bic_SR_register_on_exit(LPM0_bits);
+}
+
+/* ---------- Main ---------- */
+int main(void)
+{
+    WDTCTL = WDTPW | WDTHOLD;     // stop watchdog
+
+    Clk_Init(CLK_8MHZ);
+    Gpio_Init();
+
+    /* High-rate tier: TB0 must be running before tasks are admitted (budget needs the rate) */
+    HiRate_Init(HIRATE_HZ);
+    if (HiRate_AddTask(control_loop, 1, CONTROL_WCET_CYCLES) != 0 ||
+        HiRate_AddTask(filter_1khz, 4, FILTER_WCET_CYCLES) != 0)
+    {
+        /* Budget exceeded: stop here with the fault LED on */
+        P1OUT |= BIT5;
+        while (1) __no_operation();
+    }
+
+    /* 1 ms tier */
+    Scheduler_AddTask(task_10ms, 10, 0, TASK_10MS_SLICE_MS);
+    Scheduler_AddTask(task_100ms, 100, 5, TASK_100MS_SLICE_MS);
+    SysTime_Init();
+
+    __enable_interrupt();
+
+    while (1)
+    {
+        Scheduler_Dispatch();
+    }
+}
+
+/* ---------- High-rate tasks (ISR context, keep within the declared cycles) ---------- */
+
+/* PI controller, Q8 gains; output drives a software PWM on P1.3 */
+static void control_loop(void)
+{
+    int16_t error = setpoint - filtered;
+    int32_t out;
+
+    integral += error;
+    if (integral > 0x7FFFL) integral = 0x7FFFL;
+    if (integral < -0x8000L) integral = -0x8000L;
+
+    out = ((int32_t)error * 96 + integral * 4) >> 8;
+    output = (int16_t)out;
+
+    if (output > 0) P1OUT |= BIT3;
+    else            P1OUT &= ~BIT3;
+}
+
+/* First-order low-pass of the controller output (stand-in for a sensor read) */
+static void filter_1khz(void)
+{
+    filtered += (output - filtered) >> 3;
+}
+
+/* ---------- 1 ms tier tasks ---------- */
+static void task_10ms(uint32_t now_ms)
+{
+    /* Square-wave setpoint, 1 s period */
+    setpoint = ((now_ms / 500u) & 1u) ? 1000 : -1000;
+    P1OUT ^= BIT4;
+    __delay_cycles(4000);
+    P1OUT ^= BIT4;
+}
+
+static void task_100ms(uint32_t now_ms)
+{
+    (void)now_ms;
+    /* Fault LED if the high-rate tier ever exceeded its reserved share */
+    if (HiRate_GetStats()->overruns)
+        P1OUT |= BIT5;
+    __delay_cycles(16000);
+}
+
+/* ---------- Notes ----------
+ * 1) High-rate tasks run with GIE clear inside the TB0 ISR. Everything they share with
+ *    the 1 ms tier is a 16-bit volatile (single-instruction access) or owned by one tier.
+ *
+ * 2) The budget is checked per tick assuming all tasks fire together, which is
+ *    pessimistic for dividers > 1 but keeps the check O(1).
+ *
+ * 3) HiRate_GetStats() reports the measured worst tick (TB0R at ISR exit, so interrupt
+ *    latency is included) and ticks that exceeded the reserved budget.
+ *
+ * 4) LPM0 keeps SMCLK running, so both timers keep ticking while the main loop sleeps.
+ */
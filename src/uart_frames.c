@@ -0,0 +1,156 @@
+/*
+ * Framed UART messages without a frame buffer (Uart_WriteV) @ 8 MHz
+ * - Every 50 ms a message goes out as three segments: a 4-byte header in SRAM, a slice
+ *   of a 1 KB calibration table that stays in FRAM, and a CRC-16 in SRAM
+ * - DMA channel 2 feeds TXBUF from each segment in place; nothing is copied into a
+ *   transmit buffer, the CPU only starts each segment from the DMA ISR
+ * - Two message blocks alternate; the completion callback marks a block free again and
+ *   toggles P1.0, so P1.0 shows the released frames
+ *
+ * Key patterns:
+ * - The header and CRC belong to the driver from Uart_WriteV() until the callback runs;
+ *   a task that finds both blocks busy skips its frame instead of waiting
+ * - The DMA vector is shared with bus.c: Uart_DmaIsr() claims channel 2 events and
+ *   passes the rest on
+ * - The CRC module checksums the header and the FRAM slice where they are
+ */
+
+#include <msp430.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "clock.h"
+#include "systime.h"
+#include "scheduler.h"
+#include "defer.h"
+#include "bus.h"
+#include "uart.h"
+
+#define TABLE_BYTES     1024u
+#define SLICE_BYTES     64u
+
+typedef struct {
+    uart_txv_t txv;                 // first member: the callback gets the block
+    uart_iov_t iov[3];
+    uint8_t    hdr[4];
+    uint8_t    crc[2];
+    uint8_t    busy;
+} frame_t;
+
+static void task_50ms(uint32_t now);
+static void frame_sent(uintptr_t arg);
+
+/* Constant data is placed in FRAM by the linker */
+static const uint8_t table[TABLE_BYTES] = { 0x5A, 0xC3, 0x0F, 0x81 };
+
+static frame_t frames[2];
+static uint8_t seq = 0;
+static uint16_t frames_skipped = 0;
+
+void Gpio_Init(void)
+{
+    PM5CTL0 &= ~LOCKLPM5;
+    P1DIR |= BIT0;
+    P1OUT &= ~BIT0;
+}
+
+/* ---------- ISRs ---------- */
+
+#if defined(__TI_COMPILER_VERSION__) || defined(__IAR_SYSTEMS_ICC__)
+#pragma vector = TIMER0_A0_VECTOR
+__interrupt void Timer0_A0_ISR (void)
+#elif defined(__GNUC__)
+void __attribute__ ((interrupt(TIMER0_A0_VECTOR))) Timer0_A0_ISR (void)
+#else
+#error Compiler not supported!
+#endif
+{
+    SysTime_Tick();
+    Scheduler_TickDeferred();
+    __bic_SR_register_on_exit(LPM0_bits);
+}
+
+#if defined(__TI_COMPILER_VERSION__) || defined(__IAR_SYSTEMS_ICC__)
+#pragma vector = DMA_VECTOR
+__interrupt void Dma_ISR (void)
+#elif defined(__GNUC__)
+void __attribute__ ((interrupt(DMA_VECTOR))) Dma_ISR (void)
+#else
+#error Compiler not supported!
+#endif
+{
+    uint16_t iv = DMAIV;            // reading DMAIV clears the event
+
+    if (!Uart_DmaIsr(iv))
+        Bus_DmaIsr(iv);
+    __bic_SR_register_on_exit(LPM0_bits);
+}
+
+/* ---------- Main superloop ---------- */
+int main(void)
+{
+    WDTCTL = WDTPW | WDTHOLD;
+
+    Clk_Init(CLK_8MHZ);
+    Gpio_Init();
+    Uart_Init();
+    Defer_Init();
+
+    Scheduler_AddTask(task_50ms, 50, 0, 0);
+
+    SysTime_Init();
+    __enable_interrupt();
+
+    while (1)
+    {
+        Scheduler_Dispatch();
+    }
+}
+
+/* ---------- Tasks ---------- */
+
+static void frame_sent(uintptr_t arg)
+{
+    ((frame_t *)arg)->busy = 0;
+    P1OUT ^= BIT0;
+}
+
+/**
+ * @brief Describe the next frame in a free block and queue it; no payload is copied.
+ */
+static void task_50ms(uint32_t now)
+{
+    frame_t *f = !frames[0].busy ? &frames[0] : !frames[1].busy ? &frames[1] : NULL;
+    const uint8_t *slice = &table[(uint16_t)(seq % (TABLE_BYTES / SLICE_BYTES)) * SLICE_BYTES];
+    uint16_t i;
+
+    if (!f)
+    {
+        frames_skipped++;
+        return;
+    }
+    f->hdr[0] = 0xA5;
+    f->hdr[1] = seq++;
+    f->hdr[2] = (uint8_t)now;
+    f->hdr[3] = SLICE_BYTES;
+
+    CRCINIRES = 0xFFFF;
+    for (i = 0; i < sizeof(f->hdr); i++)
+        CRCDIRB_L = f->hdr[i];
+    for (i = 0; i < SLICE_BYTES; i++)
+        CRCDIRB_L = slice[i];
+    f->crc[0] = (uint8_t)CRCINIRES;
+    f->crc[1] = (uint8_t)(CRCINIRES >> 8);
+
+    f->iov[0].base = f->hdr;
+    f->iov[0].len = sizeof(f->hdr);
+    f->iov[1].base = slice;
+    f->iov[1].len = SLICE_BYTES;
+    f->iov[2].base = f->crc;
+    f->iov[2].len = sizeof(f->crc);
+    f->txv.iov = f->iov;
+    f->txv.iovcnt = 3;
+    f->txv.done = frame_sent;
+    f->busy = 1;
+    if (Uart_WriteV(&f->txv) != 0)
+        f->busy = 0;
+}
@@ -0,0 +1,312 @@
+#!/usr/bin/env python3
+"""
+Static cycle report for MSP430X (CPUXV2) firmware images.
+
+Disassembles an .elf with msp430-elf-objdump and sums the per-instruction
+cycle counts of each function, using the MSP430X instruction cycle tables
+(SLAU367, "MSP430X Instruction Cycles and Lengths"). Every instruction of a
+function is counted once, so the figure is a straight-line cost that is
+comparable across build profiles, not a worst-case bound.
+
+The cycles column is the zero-wait cost: code in SRAM at any clock, or in FRAM
+up to 8 MHz. At 16 MHz FRAM needs one wait state per cache miss; "fram16"
+adds it once per 64-bit line of the function (cold cache, the usual state on
+interrupt entry from LPM), which is what lib/hot.h saves by running the
+function from SRAM. The "at" column shows where the linker put it.
+
+Usage:
+    cycles.py [--objdump PATH] [--match REGEX] firmware.elf
+"""
+
+import argparse
+import re
+import subprocess
+import sys
+from collections import OrderedDict
+
+ISR_ENTRY_CYCLES = 6   # interrupt acceptance, RETI is counted in the body
+
+FRAM_LINE_BYTES = 8    # FRAM cache line (64 bits)
+FRAM_WAITS_16MHZ = 1   # NWAITS at 16 MHz (lib/clock.c)
+SRAM_START, SRAM_END = 0x1C00, 0x3C00
+
+DEFAULT_MATCH = r'(?i)isr|task|scheduler|dispatch|run_|main$'
+
+# Format I (double operand): CYCLES_FMT1[src][dst], dst in (reg, pc, mem)
+CYCLES_FMT1 = {
+    'Rn':   (1, 3, 4),
+    '@Rn':  (2, 4, 5),
+    '@Rn+': (2, 4, 5),
+    '#':    (2, 3, 5),
+    'x':    (3, 5, 6),
+}
+
+# Format II (single operand): CYCLES_FMT2[mode] = (RRA/RRC/SWPB/SXT, PUSH, CALL, CALLA)
+CYCLES_FMT2 = {
+    'Rn':   (1, 3, 4, 5),
+    '@Rn':  (3, 3, 4, 5),
+    '@Rn+': (3, 3, 4, 5),
+    '#':    (None, 3, 4, 5),
+    'x':    (4, 4, 5, 6),
+}
+
+FMT1 = {'mov', 'add', 'addc', 'sub', 'subc', 'cmp', 'dadd', 'bit', 'bic',
+        'bis', 'xor', 'and'}
+FMT2 = {'rrc', 'rra', 'swpb', 'sxt', 'push', 'call'}
+JUMPS = {'jmp', 'jne', 'jnz', 'jeq', 'jz', 'jnc', 'jlo', 'jc', 'jhs', 'jn',
+         'jge', 'jl'}
+# Emulated instructions: constant-generator source -> format I on the dst
+EMUL_CG = {'clr': 'mov', 'inc': 'add', 'incd': 'add', 'dec': 'sub',
+           'decd': 'sub', 'tst': 'cmp', 'inv': 'xor', 'adc': 'addc',
+           'sbc': 'subc', 'dadc': 'dadd'}
+EMUL_SELF = {'rla': 'add', 'rlc': 'addc'}
+SR_OPS = {'nop', 'dint', 'eint', 'setc', 'clrc', 'setz', 'clrz', 'setn',
+          'clrn'}
+CG_VALUES = {0, 1, 2, 4, 8, -1, 0xff, 0xffff, 0xfffff}
+PC_NAMES = {'r0', 'pc'}
+
+
+class Insn(object):
+    """One disassembled instruction."""
+
+    def __init__(self, addr, size, mnem, ops, comment):
+        self.addr = addr
+        self.size = size
+        self.mnem = mnem
+        self.ops = ops
+        self.comment = comment
+
+    def base(self):
+        """Mnemonic without the .b/.w/.a suffix."""
+        return self.mnem.split('.')[0]
+
+    def target(self):
+        """Branch/call target address, or None if indirect/unknown."""
+        if self.base() not in JUMPS | {'call', 'calla', 'br', 'bra'}:
+            return None
+        m = re.search(r'abs (0x[0-9a-f]+)', self.comment)
+        if m:
+            return int(m.group(1), 16)
+        if self.ops and self.ops[0].startswith('#'):
+            v = parse_int(self.ops[0][1:])
+            if v is not None:
+                return v
+        m = re.search(r'(0x[0-9a-f]+)', self.comment)
+        if m and self.base() in ('call', 'calla', 'br', 'bra'):
+            return int(m.group(1), 16)
+        return None
+
+    def __repr__(self):
+        return '%05x: %s %s' % (self.addr, self.mnem, ', '.join(self.ops))
+
+
+def parse_int(text):
+    try:
+        return int(text, 0)
+    except ValueError:
+        return None
+
+
+def mode(op):
+    """Addressing mode class of an operand as used by the cycle tables."""
+    op = op.strip()
+    if re.match(r'^(r\d+|pc|sp|sr|cg)$', op):
+        return 'Rn'
+    if op.startswith('#'):
+        v = parse_int(op[1:])
+        return 'Rn' if v in CG_VALUES else '#'
+    if op.startswith('@'):
+        return '@Rn+' if op.endswith('+') else '@Rn'
+    return 'x'      # indexed, symbolic or absolute
+
+
+def dst_column(op):
+    if op.strip() in PC_NAMES:
+        return 1
+    return 0 if mode(op) == 'Rn' else 2
+
+
+def fmt1_cycles(base, src, dst):
+    cyc = CYCLES_FMT1[mode(src)][dst_column(dst)]
+    # MOV, BIT and CMP to memory skip the write-back
+    if base in ('mov', 'bit', 'cmp') and dst_column(dst) == 2:
+        cyc -= 1
+    return cyc
+
+
+def insn_cycles(insn):
+    """Cycle count of one instruction (without FRAM wait states)."""
+    mnem = insn.base()
+    ops = insn.ops
+    extended = False
+
+    if mnem in ('reti',):
+        return 5
+    if mnem in ('ret', 'reta'):
+        return 4
+    if mnem in JUMPS:
+        return 2
+    if mnem in SR_OPS:
+        return 1
+
+    if mnem in ('pushm', 'popm'):
+        n = parse_int(ops[0][1:]) or 1
+        return 2 + (2 * n if insn.mnem.endswith('.a') else n)
+    if mnem in ('rrum', 'rram', 'rrcm', 'rlam'):
+        return parse_int(ops[0][1:]) or 1
+    if mnem == 'mova' or mnem == 'bra':
+        src = ops[0]
+        dst = ops[1] if len(ops) > 1 else 'pc'
+        if mode(dst) != 'Rn':
+            return 4
+        return {'Rn': 1, '#': 2, '@Rn': 3, '@Rn+': 3, 'x': 4}[mode(src)] + \
+            (2 if dst.strip() in PC_NAMES else 0)
+    if mnem in ('adda', 'suba', 'cmpa'):
+        return 1 if mode(ops[0]) == 'Rn' else 2
+    if mnem == 'calla':
+        return CYCLES_FMT2[mode(ops[0])][3]
+    if mnem == 'rpt':
+        return 1
+
+    # Extended (X) forms: one extra cycle for the extension word on memory operands
+    if mnem.endswith('x') and mnem[:-1] in (FMT1 | FMT2 | set(EMUL_CG) |
+                                            set(EMUL_SELF) | {'pop', 'rrum'}):
+        mnem = mnem[:-1]
+        extended = True
+
+    cyc = None
+    if mnem in FMT1 and len(ops) == 2:
+        cyc = fmt1_cycles(mnem, ops[0], ops[1])
+    elif mnem in EMUL_CG and len(ops) == 1:
+        cyc = fmt1_cycles(EMUL_CG[mnem], '#0', ops[0])
+    elif mnem in EMUL_SELF and len(ops) == 1:
+        cyc = fmt1_cycles(EMUL_SELF[mnem], ops[0], ops[0])
+    elif mnem == 'pop' and len(ops) == 1:
+        cyc = fmt1_cycles('mov', '@r1+', ops[0])
+    elif mnem == 'br' and len(ops) == 1:
+        cyc = fmt1_cycles('mov', ops[0], 'pc')
+    elif mnem in FMT2 and len(ops) == 1:
+        col = {'push': 1, 'call': 2}.get(mnem, 0)
+        cyc = CYCLES_FMT2[mode(ops[0])][col] or 1
+    if cyc is None:
+        raise ValueError('no cycle data for "%s"' % insn)
+
+    if extended and any(mode(op) != 'Rn' for op in ops):
+        cyc += 1
+    return cyc
+
+
+LINE_FUNC = re.compile(r'^([0-9a-f]+) <([^>]+)>:$')
+LINE_SECTION = re.compile(r'^Disassembly of section (\S+):$')
+LINE_SYMBOL = re.compile(r'^[0-9a-f]+ (.{7}) (\S+)\s+[0-9a-f]+\s+(\S+)$')
+LINE_INSN = re.compile(r'^\s*([0-9a-f]+):\t([0-9a-f ]+?)\s*(?:\t(.*))?$')
+
+
+def disassemble(elf, objdump='msp430-elf-objdump'):
+    """Return OrderedDict name -> [Insn] for every function in .text sections,
+    and for function symbols in other code sections (HOT_FN code in .data)."""
+    out = subprocess.check_output([objdump, '-d', '-z', elf],
+                                  universal_newlines=True)
+    syms = subprocess.check_output([objdump, '-t', elf],
+                                   universal_newlines=True)
+    return parse_objdump(out, function_symbols(syms))
+
+
+def function_symbols(text):
+    """Names of STT_FUNC symbols in an objdump -t listing."""
+    names = set()
+    for line in text.splitlines():
+        m = LINE_SYMBOL.match(line)
+        if m and 'F' in m.group(1):
+            names.add(m.group(3))
+    return names
+
+
+def parse_objdump(text, func_syms=None):
+    funcs = OrderedDict()
+    cur = None
+    section = ''
+    for line in text.splitlines():
+        m = LINE_SECTION.match(line)
+        if m:
+            section = m.group(1)
+            cur = None
+            continue
+        m = LINE_FUNC.match(line)
+        if m:
+            # Outside .text only real functions: the rest of .data is variables
+            if 'text' in section or func_syms is None or m.group(2) in func_syms:
+                cur = funcs.setdefault(m.group(2), [])
+            else:
+                cur = None
+            continue
+        m = LINE_INSN.match(line)
+        if not m or cur is None:
+            continue
+        nbytes = len(m.group(2).split())
+        body = (m.group(3) or '').strip()
+        if not body:
+            if cur:                         # continuation of a long opcode
+                cur[-1].size += nbytes
+            continue
+        comment = ''
+        if ';' in body:
+            body, comment = body.split(';', 1)
+        parts = body.split(None, 1)
+        ops = [o.strip() for o in parts[1].split(',')] if len(parts) > 1 else []
+        ops = [o for o in ops if o]
+        cur.append(Insn(int(m.group(1), 16), nbytes, parts[0].lower(), ops,
+                        comment.strip()))
+    return funcs
+
+
+def is_isr(insns):
+    return any(i.base() == 'reti' for i in insns)
+
+
+def linear_cycles(insns):
+    return sum(insn_cycles(i) for i in insns)
+
+
+def fram_lines(insns):
+    """FRAM cache lines covered by the function's code."""
+    lines = set()
+    for i in insns:
+        for a in range(i.addr, i.addr + i.size):
+            lines.add(a // FRAM_LINE_BYTES)
+    return len(lines)
+
+
+def in_sram(insns):
+    return SRAM_START <= insns[0].addr < SRAM_END
+
+
+def main(argv=None):
+    ap = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    ap.add_argument('elf')
+    ap.add_argument('--objdump', default='msp430-elf-objdump')
+    ap.add_argument('--match', default=DEFAULT_MATCH,
+                    help='regex selecting functions to report')
+    args = ap.parse_args(argv)
+
+    funcs = disassemble(args.elf, args.objdump)
+    pat = re.compile(args.match)
+    print('%-32s %6s %6s %8s %8s %5s' % ('function', 'bytes', 'insns', 'cycles',
+                                         'fram16', 'at'))
+    for name, insns in funcs.items():
+        if not insns or not (pat.search(name) or is_isr(insns)):
+            continue
+        cyc = linear_cycles(insns)
+        tag = name
+        if is_isr(insns):
+            cyc += ISR_ENTRY_CYCLES
+            tag += ' (ISR)'
+        print('%-32s %6d %6d %8d %8d %5s' % (
+            tag, sum(i.size for i in insns), len(insns), cyc,
+            cyc + FRAM_WAITS_16MHZ * fram_lines(insns),
+            'SRAM' if in_sram(insns) else 'FRAM'))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,500 @@
+#!/usr/bin/env python3
+"""
+Static WCET estimation for MSP430X firmware images.
+
+Builds a control-flow graph per function from the msp430-elf-objdump
+disassembly, bounds loops from WCET_LOOP_BOUND() annotations (lib/wcet.h)
+or simple counted-loop patterns, adds callee costs through the call graph,
+and reports a cycle bound for every ISR and every task declared with
+WCET_SLICE(). Each declared task must fit in its slice at WCET_CLOCK_HZ(),
+including one execution of every ISR per tick (or per period for ISRs declared
+with WCET_ISR_RATE()), and every ISR must fit WCET_ISR_BUDGET() if declared;
+otherwise the exit status is 1 so the build fails.
+
+Bounds use the MSP430X cycle tables from tools/cycles.py. FRAM wait states
+(16 MHz) and indirect calls through function pointers are not included.
+
+Usage:
+    wcet.py [--objdump PATH] [--tick-ms N] [--verbose] firmware.elf
+"""
+
+import argparse
+import math
+import os
+import re
+import struct
+import subprocess
+import sys
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import cycles  # noqa: E402
+
+COND_JUMPS = cycles.JUMPS - {'jmp'}
+
+
+class WcetError(Exception):
+    """Function cannot be bounded (unbounded loop, indirect jump, recursion)."""
+
+
+# ---------- ELF annotation sections ----------
+
+def section_bytes(elf, name, objdump):
+    """Raw contents of a section, b'' if the image has none."""
+    res = subprocess.run([objdump, '-s', '-j', name, elf],
+                         stdout=subprocess.PIPE, stderr=subprocess.DEVNULL,
+                         universal_newlines=True)
+    data = bytearray()
+    for line in res.stdout.splitlines():
+        m = re.match(r'^ ([0-9a-f]{4,}) ((?:[0-9a-f]{2,8} ?){1,4})', line)
+        if m:
+            data += bytes.fromhex(m.group(2).replace(' ', ''))
+    return bytes(data)
+
+
+def read_bounds(elf, objdump):
+    data = section_bytes(elf, '.wcet_bounds', objdump)
+    return [struct.unpack_from('<II', data, o) for o in range(0, len(data) - 7, 8)]
+
+
+def read_slices(elf, objdump):
+    data = section_bytes(elf, '.wcet_slices', objdump)
+    slices = []
+    o = 0
+    while o + 4 < len(data):
+        ms, = struct.unpack_from('<I', data, o)
+        end = data.index(b'\0', o + 4)
+        slices.append((data[o + 4:end].decode(), ms))
+        o = (end + 4) & ~3
+    return slices
+
+
+def read_isr_rates(elf, objdump):
+    """name -> (hz, reserved cycles or 0) from WCET_ISR_RATE()."""
+    data = section_bytes(elf, '.wcet_isr_rates', objdump)
+    rates = {}
+    o = 0
+    while o + 8 < len(data):
+        hz, cyc = struct.unpack_from('<II', data, o)
+        end = data.index(b'\0', o + 8)
+        rates[data[o + 8:end].decode()] = (hz, cyc)
+        o = (end + 4) & ~3
+    return rates
+
+
+def read_isr_budget(elf, objdump):
+    data = section_bytes(elf, '.wcet_isr_budget', objdump)
+    return struct.unpack_from('<I', data)[0] if len(data) >= 4 else None
+
+
+def read_clock(elf, objdump):
+    data = section_bytes(elf, '.wcet_clock', objdump)
+    return struct.unpack_from('<I', data)[0] if len(data) >= 4 else None
+
+
+# ---------- CFG ----------
+
+class Block(object):
+    def __init__(self, start):
+        self.start = start
+        self.insns = []
+        self.succs = []
+        self.cost = 0
+        self.exit = False
+
+
+def build_cfg(insns):
+    """Split a function into basic blocks. Returns (blocks by start addr, entry)."""
+    addrs = set(i.addr for i in insns)
+    leaders = {insns[0].addr}
+    for k, ins in enumerate(insns):
+        b = ins.base()
+        if b in cycles.JUMPS or b in ('br', 'bra', 'ret', 'reta', 'reti'):
+            t = ins.target()
+            if t in addrs:
+                leaders.add(t)
+            if k + 1 < len(insns):
+                leaders.add(insns[k + 1].addr)
+
+    blocks = {}
+    cur = None
+    for ins in insns:
+        if ins.addr in leaders:
+            cur = blocks[ins.addr] = Block(ins.addr)
+        cur.insns.append(ins)
+
+    order = sorted(blocks)
+    for n, start in enumerate(order):
+        blk = blocks[start]
+        last = blk.insns[-1]
+        b = last.base()
+        nxt = order[n + 1] if n + 1 < len(order) else None
+        if b == 'jmp':
+            blk.succs = [last.target()]
+        elif b in COND_JUMPS:
+            blk.succs = [last.target(), nxt]
+        elif b in ('ret', 'reta', 'reti'):
+            blk.exit = True
+        elif b in ('br', 'bra'):
+            t = last.target()
+            if t in addrs:
+                blk.succs = [t]
+            else:
+                blk.exit = True          # tail call, costed in block_cost()
+        elif nxt is not None:
+            blk.succs = [nxt]
+        else:
+            blk.exit = True
+        blk.succs = [s for s in blk.succs if s is not None]
+        for s in blk.succs:
+            if s not in blocks:
+                raise WcetError('jump into another function at 0x%x' % s)
+    return blocks, insns[0].addr
+
+
+def dominators(blocks, entry):
+    preds = {a: [] for a in blocks}
+    for a, b in blocks.items():
+        for s in b.succs:
+            preds[s].append(a)
+    dom = {a: set(blocks) for a in blocks}
+    dom[entry] = {entry}
+    changed = True
+    while changed:
+        changed = False
+        for a in sorted(blocks):
+            if a == entry:
+                continue
+            ps = [dom[p] for p in preds[a]]
+            new = ({a} | set.intersection(*ps)) if ps else {a}
+            if new != dom[a]:
+                dom[a] = new
+                changed = True
+    return dom, preds
+
+
+def check_reducible(blocks, entry, dom):
+    """Every cycle must go through a back-edge (target dominates source)."""
+    state = {}
+    stack = [(entry, iter(blocks[entry].succs))]
+    state[entry] = 1
+    while stack:
+        n, it = stack[-1]
+        for s in it:
+            if s in dom[n]:
+                continue
+            if state.get(s) == 1:
+                raise WcetError('irreducible loop at 0x%x' % s)
+            if s not in state:
+                state[s] = 1
+                stack.append((s, iter(blocks[s].succs)))
+                break
+        else:
+            state[n] = 2
+            stack.pop()
+
+
+def natural_loops(blocks, entry):
+    """Return list of (header, body set, latches) for every back-edge target."""
+    dom, preds = dominators(blocks, entry)
+    check_reducible(blocks, entry, dom)
+    loops = {}
+    for a, b in blocks.items():
+        for s in b.succs:
+            if s in dom[a]:                          # back-edge a -> s
+                body = {s, a}
+                stack = [a]
+                while stack:
+                    n = stack.pop()
+                    if n == s:
+                        continue
+                    for p in preds[n]:
+                        if p not in body:
+                            body.add(p)
+                            stack.append(p)
+                h = loops.setdefault(s, [set(), set()])
+                h[0] |= body
+                h[1].add(a)
+    return [(h, body, latches) for h, (body, latches) in loops.items()], preds
+
+
+def infer_bound(blocks, preds, header, body, latches):
+    """Counted loop: preheader 'mov #N, rX', latch 'dec rX / add #-1, rX; jnz'."""
+    for l in latches:
+        ins = blocks[l].insns
+        if len(ins) < 2 or ins[-1].base() not in ('jnz', 'jne'):
+            continue
+        dec = ins[-2]
+        b = dec.base()
+        if b in ('dec', 'decx') and len(dec.ops) == 1:
+            reg = dec.ops[0]
+        elif b in ('add', 'addx', 'adda') and dec.ops[0] == '#-1':
+            reg = dec.ops[1]
+        elif b in ('sub', 'subx', 'suba') and dec.ops[0] == '#1':
+            reg = dec.ops[1]
+        else:
+            continue
+        for p in preds[header]:
+            if p in body:
+                continue
+            for i in reversed(blocks[p].insns):
+                if len(i.ops) == 2 and i.ops[1] == reg:
+                    if i.base() in ('mov', 'movx', 'mova') and i.ops[0].startswith('#'):
+                        n = cycles.parse_int(i.ops[0][1:])
+                        if n is not None:
+                            return n & 0xfffff if i.base() == 'mova' else n & 0xffff
+                    break
+    return None
+
+
+# ---------- WCET ----------
+
+class Analyzer(object):
+    def __init__(self, funcs, bounds):
+        self.funcs = funcs
+        self.by_addr = dict((ins[0].addr, n) for n, ins in funcs.items() if ins)
+        self.bounds = bounds
+        self.memo = {}
+        self.indirect = {}
+        self.active = set()
+
+    def wcet(self, name):
+        if name in self.memo:
+            return self.memo[name]
+        if name in self.active:
+            raise WcetError('recursion through %s' % name)
+        self.active.add(name)
+        try:
+            self.indirect[name] = 0
+            self.memo[name] = self._wcet(name)
+        finally:
+            self.active.discard(name)
+        return self.memo[name]
+
+    def callee_cost(self, caller, ins):
+        t = ins.target()
+        if t is None:
+            self.indirect[caller] += 1      # function pointer, costed per task
+            return 0
+        callee = self.by_addr.get(t)
+        if callee is None:
+            raise WcetError('call to unknown address 0x%x' % t)
+        cost = self.wcet(callee)
+        self.indirect[caller] += self.indirect[callee]
+        return cost
+
+    def block_cost(self, name, blk, addrs):
+        cost = 0
+        for ins in blk.insns:
+            cost += cycles.insn_cycles(ins)
+            b = ins.base()
+            if b in ('call', 'calla'):
+                cost += self.callee_cost(name, ins)
+            elif b in ('br', 'bra'):
+                t = ins.target()
+                if t is None:
+                    raise WcetError('indirect jump at 0x%x' % ins.addr)
+                if t not in addrs:
+                    cost += self.callee_cost(name, ins)
+        return cost
+
+    def _wcet(self, name):
+        insns = self.funcs[name]
+        blocks, entry = build_cfg(insns)
+        addrs = set(i.addr for i in insns)
+        for blk in blocks.values():
+            blk.cost = self.block_cost(name, blk, addrs)
+        loops, preds = natural_loops(blocks, entry)
+
+        def in_block(addr):
+            for a, blk in blocks.items():
+                if blk.insns[0].addr <= addr <= blk.insns[-1].addr:
+                    return a
+            return None
+
+        # Annotated bound -> innermost loop containing the annotation
+        bound_of = {}
+        for addr, n in self.bounds:
+            a = in_block(addr)
+            if a is None:
+                continue
+            inner = [l for l in loops if a in l[1]]
+            if inner:
+                h = min(inner, key=lambda l: len(l[1]))[0]
+                bound_of[h] = max(bound_of.get(h, 0), n)
+
+        # Collapse loops innermost first into super nodes
+        rep = dict((a, a) for a in blocks)      # block -> current node
+        cost = dict((a, blocks[a].cost) for a in blocks)
+        succs = dict((a, set(blocks[a].succs)) for a in blocks)
+        exits = set(a for a in blocks if blocks[a].exit)
+        for h, body, latches in sorted(loops, key=lambda l: len(l[1])):
+            bound = bound_of.get(h)
+            if bound is None:
+                bound = infer_bound(blocks, preds, h, body, latches)
+            if bound is None:
+                src = blocks[h].insns[0].addr
+                raise WcetError('loop at 0x%x has no bound (add WCET_LOOP_BOUND)' % src)
+            nodes = set(rep[a] for a in body)
+            hn = rep[h]
+            latch_nodes = set(rep[a] for a in latches)
+            # Longest path inside the loop from the header (back-edges removed)
+            dist = {}
+
+            def longest(n):
+                if n in dist:
+                    return dist[n]
+                best = None
+                for p in nodes:
+                    if p != n and n in succs[p] and n != hn:
+                        d = longest(p)
+                        best = d if best is None else max(best, d)
+                dist[n] = cost[n] + (best or 0)
+                return dist[n]
+
+            iter_cost = max(longest(l) for l in latch_nodes)
+            leaving = [n for n in nodes if (succs[n] - nodes) or n in exits]
+            exit_cost = max(longest(n) for n in leaving) if leaving else 0
+            total = bound * iter_cost + exit_cost
+            out = set()
+            for n in nodes:
+                out |= succs[n] - nodes
+            is_exit = any(n in exits for n in nodes)
+            for p in list(succs):
+                if p not in nodes and succs[p] & nodes:
+                    succs[p] = (succs[p] - nodes) | {hn}
+            for n in nodes:
+                if n != hn:
+                    del succs[n]
+                    del cost[n]
+                    exits.discard(n)
+            succs[hn] = out
+            cost[hn] = total
+            if is_exit:
+                exits.add(hn)
+            for a in rep:
+                if rep[a] in nodes:
+                    rep[a] = hn
+
+        # Longest path through the remaining DAG
+        memo = {}
+
+        def path(n):
+            if n not in memo:
+                tails = [path(s) for s in succs[n]]
+                memo[n] = cost[n] + (max(tails) if tails else 0)
+            return memo[n]
+
+        return path(rep[entry])
+
+
+def find_function(funcs, name):
+    """Match a source name against symbols, allowing LTO/clone suffixes."""
+    if name in funcs:
+        return name
+    for f in funcs:
+        if f.startswith(name + '.'):
+            return f
+    return None
+
+
+def isr_runs(slice_ms, rate, tick_ms):
+    """Runs of an ISR that can land inside one slice (once per tick by default)."""
+    if rate:
+        return int(math.ceil(slice_ms * rate / 1000.0))
+    return int(math.ceil(slice_ms / float(tick_ms)))
+
+
+def main(argv=None):
+    ap = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    ap.add_argument('elf')
+    ap.add_argument('--objdump', default='msp430-elf-objdump')
+    ap.add_argument('--tick-ms', type=int, default=1,
+                    help='tick period; every ISR is charged once per tick')
+    ap.add_argument('--verbose', action='store_true')
+    args = ap.parse_args(argv)
+
+    slices = read_slices(args.elf, args.objdump)
+    isr_budget = read_isr_budget(args.elf, args.objdump)
+    if not slices and not isr_budget:
+        if args.verbose:
+            print('%s: no WCET_SLICE()/WCET_ISR_BUDGET() annotations, nothing to check'
+                  % args.elf)
+        return 0
+    hz = read_clock(args.elf, args.objdump)
+    if not hz:
+        print('%s: WCET annotations without WCET_CLOCK_HZ()' % args.elf)
+        return 1
+
+    funcs = cycles.disassemble(args.elf, args.objdump)
+    an = Analyzer(funcs, read_bounds(args.elf, args.objdump))
+    failed = False
+
+    print('WCET report: %s @ %d Hz' % (os.path.basename(args.elf), hz))
+    if isr_budget:
+        print('ISR budget: %d cycles (%.1f us)' % (isr_budget, isr_budget * 1e6 / hz))
+    print('%-28s %10s %10s %9s  %s' % ('function', 'cycles', 'us', 'slice_ms', 'status'))
+
+    rates = read_isr_rates(args.elf, args.objdump)
+    isrs = []       # (cycles per run, runs per second or None = once per tick)
+    for name, insns in funcs.items():
+        if not insns or not cycles.is_isr(insns):
+            continue
+        rate, reserved = next((rates[r] for r in rates if find_function({name: 0}, r)),
+                              (None, 0))
+        note = '%d Hz' % rate if rate else ''
+        if reserved:
+            if isrs is not None:
+                isrs.append((reserved, rate))
+            if isr_budget and reserved > isr_budget:
+                note = 'FAIL: over ISR budget, ' + note
+                failed = True
+            print('%-28s %10d %10.1f %9s  reserved, %s' % (name + ' (ISR)', reserved,
+                                                         reserved * 1e6 / hz, '-', note))
+            continue
+        try:
+            w = an.wcet(name) + cycles.ISR_ENTRY_CYCLES
+            if isrs is not None:
+                isrs.append((w, rate))
+            note += ('' if not an.indirect.get(name) else
+                     '%s%d indirect call(s) not costed' % (', ' if note else '',
+                                                           an.indirect[name]))
+            if isr_budget and w > isr_budget:
+                note = 'FAIL: over ISR budget' + (', ' + note if note else '')
+                failed = True
+            print('%-28s %10d %10.1f %9s  %s' % (name + ' (ISR)', w, w * 1e6 / hz, '-', note))
+        except WcetError as e:
+            isrs = None
+            failed = failed or bool(isr_budget)
+            print('%-28s %10s %10s %9s  UNBOUNDED: %s' % (name + ' (ISR)', '-', '-', '-', e))
+
+    for name, slice_ms in slices:
+        sym = find_function(funcs, name)
+        if sym is None:
+            print('%-28s %10s %10s %9d  MISSING: no such function' % (name, '-', '-', slice_ms))
+            failed = True
+            continue
+        try:
+            w = an.wcet(sym)
+        except WcetError as e:
+            print('%-28s %10s %10s %9d  UNBOUNDED: %s' % (name, '-', '-', slice_ms, e))
+            failed = True
+            continue
+        budget = slice_ms * hz // 1000
+        if isrs is None:
+            status = 'FAIL: ISR interference unbounded'
+            failed = True
+        else:
+            demand = w + sum(c * isr_runs(slice_ms, rate, args.tick_ms) for c, rate in isrs)
+            status = 'ok (%d%% of slice incl. ISRs)' % (100 * demand // max(budget, 1))
+            if demand > budget:
+                status = 'FAIL: needs %.2f ms incl. ISRs' % (demand * 1000.0 / hz)
+                failed = True
+        if an.indirect.get(sym):
+            status += ', %d indirect call(s) not costed' % an.indirect[sym]
+        print('%-28s %10d %10.1f %9d  %s' % (name, w, w * 1e6 / hz, slice_ms, status))
+
+    return 1 if failed else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())